@@ -0,0 +1,582 @@
+//-----------------------------------------------------------------------------
+#include "olcAnsiBackend.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+//-----------------------------------------------------------------------------
+
+#if defined(_WIN32) && !defined(ENABLE_VIRTUAL_TERMINAL_PROCESSING)
+#define ENABLE_VIRTUAL_TERMINAL_PROCESSING 0x0004
+#endif
+
+// Unchanged cells in between two changed ones are rewritten when there are
+// at most this many of them; a cursor move costs more than that
+static const int ANSI_MAX_GAP = 4;
+//-----------------------------------------------------------------------------
+
+static void AppendInt(std::string &s, int n)
+{
+	char tmp[12];
+	int  i = 0;
+	do
+	{
+		tmp[i++] = char('0' + n % 10);
+		n /= 10;
+	} while(n > 0);
+	while(i > 0)
+		s += tmp[--i];
+}
+//-----------------------------------------------------------------------------
+
+static void AppendUtf8(std::string &s, uint32_t c)
+{
+	if(c < 0x80)
+		s += char(c);
+	else if(c < 0x800)
+	{
+		s += char(0xC0 | (c >> 6));
+		s += char(0x80 | (c & 0x3F));
+	}
+	else if(c < 0x10000)
+	{
+		s += char(0xE0 | (c >> 12));
+		s += char(0x80 | ((c >> 6) & 0x3F));
+		s += char(0x80 | (c & 0x3F));
+	}
+	else
+	{
+		s += char(0xF0 | (c >> 18));
+		s += char(0x80 | ((c >> 12) & 0x3F));
+		s += char(0x80 | ((c >> 6) & 0x3F));
+		s += char(0x80 | (c & 0x3F));
+	}
+}
+//-----------------------------------------------------------------------------
+
+// Console colours are BGR ordered (1 = blue, 4 = red), ANSI ones are RGB
+static int AnsiColour(int c)
+{
+	return ((c & 1) << 2) | (c & 2) | ((c & 4) >> 2);
+}
+//-----------------------------------------------------------------------------
+
+static bool WriteAll(const char *data, size_t size)
+{
+#ifdef _WIN32
+	HANDLE hOut = GetStdHandle(STD_OUTPUT_HANDLE);
+	while(size > 0)
+	{
+		DWORD written = 0;
+		if(!WriteFile(hOut, data, DWORD(size), &written, NULL))
+			return false;
+		data += written;
+		size -= written;
+	}
+#else
+	while(size > 0)
+	{
+		ssize_t written = write(STDOUT_FILENO, data, size);
+		if(written < 0)
+		{
+			if(errno == EINTR)
+				continue;
+			return false;
+		}
+		data += written;
+		size -= size_t(written);
+	}
+#endif
+	return true;
+}
+//-----------------------------------------------------------------------------
+
+
+
+
+
+
+
+
+
+
+
+
+//-----------------------------------------------------------------------------
+
+olcAnsiBackend::~olcAnsiBackend()
+{
+	if(!m_bConstructed)
+		return;
+
+	//-- Reset colours, show the cursor and leave the alternate screen
+	static const char restore[] = "\x1b[0m\x1b[?25h\x1b[?1049l";
+	WriteAll(restore, sizeof(restore) - 1);
+
+#ifndef _WIN32
+	if(m_bRawInput)
+	{
+		static const char mouseOff[] = "\x1b[?1003l\x1b[?1006l";
+		WriteAll(mouseOff, sizeof(mouseOff) - 1);
+		tcsetattr(STDIN_FILENO, TCSAFLUSH, &m_termOriginal);
+	}
+#endif
+}
+//-----------------------------------------------------------------------------
+
+int olcAnsiBackend::Construct(int &width, int &height, int, int)
+{
+	//-- Clamp the requested size to the terminal, when there is one. Output
+	//   redirected to a file or pipe is left at the requested size
+#ifdef _WIN32
+	HANDLE hOut = GetStdHandle(STD_OUTPUT_HANDLE);
+	DWORD  mode = 0;
+	if(GetConsoleMode(hOut, &mode))
+	{
+		if(!SetConsoleMode(hOut, mode | ENABLE_VIRTUAL_TERMINAL_PROCESSING))
+			return olcReportError(L"SetConsoleMode");
+		SetConsoleOutputCP(CP_UTF8);
+
+		CONSOLE_SCREEN_BUFFER_INFO csbi;
+		if(GetConsoleScreenBufferInfo(hOut, &csbi))
+		{
+			int cols = csbi.srWindow.Right - csbi.srWindow.Left + 1;
+			int rows = csbi.srWindow.Bottom - csbi.srWindow.Top + 1;
+			width  = width  > cols ? cols : width;
+			height = height > rows ? rows : height;
+		}
+	}
+#else
+	struct winsize ws;
+	if(isatty(STDOUT_FILENO) && ioctl(STDOUT_FILENO, TIOCGWINSZ, &ws) == 0 && ws.ws_col > 0 && ws.ws_row > 0)
+	{
+		width  = width  > ws.ws_col ? ws.ws_col : width;
+		height = height > ws.ws_row ? ws.ws_row : height;
+	}
+#endif
+	if(width <= 0 || height <= 0)
+		return olcReportError(L"olcAnsiBackend: invalid screen size");
+
+	//-- Switch to the alternate screen and hide the cursor
+	static const char setup[] = "\x1b[?1049h\x1b[?25l";
+	if(!WriteAll(setup, sizeof(setup) - 1))
+		return olcReportError(L"olcAnsiBackend: cannot write to the terminal");
+
+#ifndef _WIN32
+	//-- Raw keyboard (signals still work, so Ctrl+C quits) and SGR mouse
+	//   reports for every motion
+	if(isatty(STDIN_FILENO) && tcgetattr(STDIN_FILENO, &m_termOriginal) == 0)
+	{
+		struct termios raw = m_termOriginal;
+		raw.c_lflag &= ~tcflag_t(ICANON | ECHO | IEXTEN);
+		raw.c_iflag &= ~tcflag_t(IXON | ICRNL);
+		raw.c_cc[VMIN]  = 1;
+		raw.c_cc[VTIME] = 0;
+		if(tcsetattr(STDIN_FILENO, TCSAFLUSH, &raw) == 0)
+		{
+			static const char mouseOn[] = "\x1b[?1003h\x1b[?1006h";
+			WriteAll(mouseOn, sizeof(mouseOn) - 1);
+			m_bRawInput = true;
+		}
+	}
+#endif
+
+	m_bConstructed = true;
+	m_bRepaint     = true;
+	return 1;
+}
+//-----------------------------------------------------------------------------
+
+void olcAnsiBackend::MoveCursor(int x, int y)
+{
+	if(x == m_nCursorX && y == m_nCursorY)
+		return;
+
+	if(y == m_nCursorY && x > m_nCursorX && m_nCursorX >= 0)
+	{
+		//-- Cursor Forward is shorter than a full position on the same row
+		m_sFrame += "\x1b[";
+		if(x - m_nCursorX > 1)
+			AppendInt(m_sFrame, x - m_nCursorX);
+		m_sFrame += 'C';
+	}
+	else
+	{
+		m_sFrame += "\x1b[";
+		AppendInt(m_sFrame, y + 1);
+		if(x > 0)
+		{
+			m_sFrame += ';';
+			AppendInt(m_sFrame, x + 1);
+		}
+		m_sFrame += 'H';
+	}
+
+	m_nCursorX = x;
+	m_nCursorY = y;
+}
+//-----------------------------------------------------------------------------
+
+void olcAnsiBackend::SetAttributes(int attr)
+{
+	attr &= 0xFF;
+	if(attr == m_nAttributes)
+		return;
+
+	int fg = attr & 0x0F;
+	int bg = attr >> 4;
+	bool bSetFg = m_nAttributes < 0 || fg != (m_nAttributes & 0x0F);
+	bool bSetBg = m_nAttributes < 0 || bg != (m_nAttributes >> 4);
+
+	m_sFrame += "\x1b[";
+	if(bSetFg)
+		AppendInt(m_sFrame, (fg & 8 ? 90 : 30) + AnsiColour(fg));
+	if(bSetFg && bSetBg)
+		m_sFrame += ';';
+	if(bSetBg)
+		AppendInt(m_sFrame, (bg & 8 ? 100 : 40) + AnsiColour(bg));
+	m_sFrame += 'm';
+
+	m_nAttributes = attr;
+}
+//-----------------------------------------------------------------------------
+
+void olcAnsiBackend::EmitGlyph(wchar_t c)
+{
+	uint32_t u = uint32_t(c);
+	//-- Control characters (and the zeroed cells of a fresh buffer) would move
+	//   the cursor around, draw them as blanks
+	if(u < 0x20 || u == 0x7F)
+		u = L' ';
+	AppendUtf8(m_sFrame, u);
+
+	if(++m_nCursorX >= m_nWidth)
+	{
+		//-- Terminals differ on where the cursor ends up after writing the
+		//   last column, so force an absolute move next time
+		m_nCursorX = -1;
+		m_nCursorY = -1;
+	}
+}
+//-----------------------------------------------------------------------------
+
+void olcAnsiBackend::PresentSpan(const olcCellBuffer &buf, int y, int x1, int x2)
+{
+	size_t         nRow       = size_t(y) * size_t(m_nWidth);
+	const wchar_t *glyphs     = buf.Glyphs() + nRow;
+	const uint8_t *attrs      = buf.Attributes() + nRow;
+	wchar_t       *prevGlyphs = m_bufPresented.Glyphs() + nRow;
+	uint8_t       *prevAttrs  = m_bufPresented.Attributes() + nRow;
+
+	//-- Regions are whole dirty spans, often rewritten with what was there
+	//   already; the planes rule those out a vector at a time
+	if(!m_bRepaint &&
+	   memcmp(glyphs + x1, prevGlyphs + x1, sizeof(wchar_t) * size_t(x2 - x1)) == 0 &&
+	   memcmp(attrs + x1, prevAttrs + x1, size_t(x2 - x1)) == 0)
+		return;
+
+	auto changed = [&](int i)
+	{
+		return m_bRepaint || glyphs[i] != prevGlyphs[i] || attrs[i] != prevAttrs[i];
+	};
+
+	int x = x1;
+	while(x < x2)
+	{
+		if(!changed(x))
+		{
+			++x;
+			continue;
+		}
+
+		//-- Extend the run over further changes, bridging short gaps
+		int end = x + 1;
+		for(int i = end; i < x2; ++i)
+		{
+			if(changed(i))
+				end = i + 1;
+			else if(i - end + 1 > ANSI_MAX_GAP)
+				break;
+		}
+
+		MoveCursor(x, y);
+		for(int i = x; i < end; ++i)
+		{
+			SetAttributes(attrs[i]);
+			EmitGlyph(glyphs[i]);
+			prevGlyphs[i] = glyphs[i];
+			prevAttrs[i]  = attrs[i];
+		}
+		x = end;
+	}
+}
+//-----------------------------------------------------------------------------
+
+void olcAnsiBackend::Present(const olcCellBuffer &buf, const sCellRect *pRegions, int nRegions)
+{
+	int width  = buf.Width();
+	int height = buf.Height();
+	if(width != m_nWidth || height != m_nHeight)
+	{
+		m_nWidth  = width;
+		m_nHeight = height;
+		m_bufPresented.Resize(width, height);
+		m_bRepaint = true;
+	}
+
+	m_sFrame.clear();
+	m_sFrame += m_sPendingTitle;
+	m_sPendingTitle.clear();
+
+	if(m_bRepaint)
+	{
+		//-- Nothing on the terminal can be trusted, send every cell
+		m_nCursorX    = -1;
+		m_nCursorY    = -1;
+		m_nAttributes = -1;
+		for(int y = 0; y < height; ++y)
+			PresentSpan(buf, y, 0, width);
+		m_bRepaint = false;
+	}
+	else
+	{
+		for(int i = 0; i < nRegions; ++i)
+			for(int y = pRegions[i].Top; y <= pRegions[i].Bottom; ++y)
+				PresentSpan(buf, y, pRegions[i].Left, pRegions[i].Right + 1);
+	}
+
+	Flush();
+}
+//-----------------------------------------------------------------------------
+
+void olcAnsiBackend::SetTitle(const std::wstring &sTitle)
+{
+	//-- The engine updates the title every frame; sending it that often
+	//   would cost more than the frame itself
+	auto tpNow = std::chrono::steady_clock::now();
+	if(tpNow - m_tpLastTitle < std::chrono::seconds(1))
+		return;
+	m_tpLastTitle = tpNow;
+
+	m_sPendingTitle = "\x1b]0;";
+	for(wchar_t c : sTitle)
+		AppendUtf8(m_sPendingTitle, uint32_t(c));
+	m_sPendingTitle += '\x07';
+}
+//-----------------------------------------------------------------------------
+
+void olcAnsiBackend::Flush()
+{
+	m_nLastFrameBytes = m_sFrame.size();
+	if(!m_sFrame.empty())
+		WriteAll(m_sFrame.data(), m_sFrame.size());
+}
+//-----------------------------------------------------------------------------
+
+#ifdef _WIN32
+
+void olcAnsiBackend::PollKeyboard(short *pKeyState)
+{
+	for(int i = 0; i < 256; i++)
+		pKeyState[i] = GetAsyncKeyState(i);
+}
+//-----------------------------------------------------------------------------
+
+#else
+
+int olcAnsiBackend::WaitInput(olcInputEvent *pEvents, int nMax, int nTimeoutMs)
+{
+	//-- Leftovers that did not fit last time come first
+	if(!m_sInput.empty())
+	{
+		int n = ParseInput(pEvents, nMax);
+		if(n > 0)
+			return n;
+	}
+
+	//-- Wake up in time to release the next held key that goes quiet, or to
+	//-- report a lone ESC nothing followed
+	auto tpNow  = std::chrono::steady_clock::now();
+	auto wakeAt = [&](std::chrono::steady_clock::time_point tp)
+	{
+		int nMs    = int(std::chrono::duration_cast<std::chrono::milliseconds>(tp - tpNow).count()) + 1;
+		nTimeoutMs = std::max(0, std::min(nTimeoutMs, nMs));
+	};
+	for(const sHeldKey &key : m_vecHeldKeys)
+		wakeAt(key.tpLast + (key.bRepeated ? m_durKeyHoldRepeat : m_durKeyHoldFirst));
+	if(m_sInput == "\x1B")
+		wakeAt(m_tpEscape + m_durEscapeWait);
+
+	int n = 0;
+	struct pollfd pfd = { STDIN_FILENO, POLLIN, 0 };
+	if(poll(&pfd, 1, nTimeoutMs) > 0 && (pfd.revents & POLLIN))
+	{
+		char buf[256];
+		ssize_t nRead = read(STDIN_FILENO, buf, sizeof(buf));
+		if(nRead > 0)
+			m_sInput.append(buf, size_t(nRead));
+	}
+	if(!m_sInput.empty())
+		n = ParseInput(pEvents, nMax);
+	return n + ReleaseKeys(pEvents + n, nMax - n);
+}
+//-----------------------------------------------------------------------------
+
+int olcAnsiBackend::ReleaseKeys(olcInputEvent *pEvents, int nMax)
+{
+	auto tpNow = std::chrono::steady_clock::now();
+	int  n     = 0;
+	for(size_t i = 0; i < m_vecHeldKeys.size() && n < nMax; )
+	{
+		const sHeldKey &key = m_vecHeldKeys[i];
+		if(tpNow - key.tpLast < (key.bRepeated ? m_durKeyHoldRepeat : m_durKeyHoldFirst))
+		{
+			++i;
+			continue;
+		}
+		pEvents[n++] = { tpNow, INPUT_KEY_UP, key.nKey, 0, 0 };
+		m_vecHeldKeys[i] = m_vecHeldKeys.back();
+		m_vecHeldKeys.pop_back();
+	}
+	return n;
+}
+//-----------------------------------------------------------------------------
+
+int olcAnsiBackend::ParseInput(olcInputEvent *pEvents, int nMax)
+{
+	// Virtual key codes, as the Win32 console would report them
+	enum { VK_BACK = 0x08, VK_TAB = 0x09, VK_RETURN = 0x0D, VK_ESCAPE = 0x1B, VK_SPACE = 0x20,
+	       VK_PRIOR = 0x21, VK_NEXT = 0x22, VK_END = 0x23, VK_HOME = 0x24, VK_LEFT = 0x25,
+	       VK_UP = 0x26, VK_RIGHT = 0x27, VK_DOWN = 0x28, VK_INSERT = 0x2D, VK_DELETE = 0x2E };
+
+	auto tpNow = std::chrono::steady_clock::now();
+	int  n     = 0;
+	//-- The first byte of a key presses it, the repeats keep it held
+	auto tap   = [&](int vk)
+	{
+		for(sHeldKey &key : m_vecHeldKeys)
+		{
+			if(key.nKey == vk)
+			{
+				key.bRepeated = true;
+				key.tpLast    = tpNow;
+				return;
+			}
+		}
+		m_vecHeldKeys.push_back({ vk, false, tpNow });
+		pEvents[n++] = { tpNow, INPUT_KEY_DOWN, vk, 0, 0 };
+	};
+
+	const std::string &s = m_sInput;
+	size_t i = 0;
+	while(i < s.size() && n < nMax)
+	{
+		unsigned char c = (unsigned char)s[i];
+
+		if(c == 0x1B && i + 1 == s.size())
+		{
+			//-- A lone ESC at the end may be a sequence split across reads,
+			//-- it only is the Escape key if nothing follows for a while
+			if(m_tpEscape == std::chrono::steady_clock::time_point())
+				m_tpEscape = tpNow;
+			if(tpNow - m_tpEscape < m_durEscapeWait)
+				break;
+		}
+
+		if(c == 0x1B && i + 1 < s.size() && (s[i + 1] == '[' || s[i + 1] == 'O'))
+		{
+			//-- Control sequence: parameters up to a final byte in 0x40-0x7E
+			size_t j = i + 2;
+			while(j < s.size() && !(s[j] >= 0x40 && s[j] <= 0x7E))
+				++j;
+			if(j >= s.size())
+				break;	// incomplete, wait for the rest
+
+			std::string sParams(s, i + 2, j - i - 2);
+			char        cFinal = s[j];
+			i = j + 1;
+
+			if(!sParams.empty() && sParams[0] == '<' && (cFinal == 'M' || cFinal == 'm'))
+			{
+				//-- SGR mouse report: <button;column;row
+				int b = 0, x = 0, y = 0;
+				if(sscanf(sParams.c_str() + 1, "%d;%d;%d", &b, &x, &y) != 3 || (b & 64))
+					continue;
+				x -= 1;
+				y -= 1;
+				if(b & 32)
+					pEvents[n++] = { tpNow, INPUT_MOUSE_MOVE, 0, x, y };
+				else
+				{
+					// Same button numbering as the Win32 console: left, right, middle
+					static const int buttons[4] = { 0, 2, 1, 3 };
+					pEvents[n++] = { tpNow, cFinal == 'M' ? INPUT_MOUSE_DOWN : INPUT_MOUSE_UP, buttons[b & 3], x, y };
+				}
+				continue;
+			}
+
+			int vk = 0;
+			switch(cFinal)
+			{
+			case 'A': vk = VK_UP;    break;
+			case 'B': vk = VK_DOWN;  break;
+			case 'C': vk = VK_RIGHT; break;
+			case 'D': vk = VK_LEFT;  break;
+			case 'H': vk = VK_HOME;  break;
+			case 'F': vk = VK_END;   break;
+			case '~':
+				switch(atoi(sParams.c_str()))
+				{
+				case 1: case 7: vk = VK_HOME;   break;
+				case 2:         vk = VK_INSERT; break;
+				case 3:         vk = VK_DELETE; break;
+				case 4: case 8: vk = VK_END;    break;
+				case 5:         vk = VK_PRIOR;  break;
+				case 6:         vk = VK_NEXT;   break;
+				}
+				break;
+			}
+			if(vk)
+				tap(vk);
+			continue;
+		}
+
+		++i;
+		if(c >= 'a' && c <= 'z')
+			tap(c - 'a' + 'A');
+		else if((c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9'))
+			tap(c);
+		else if(c >= 1 && c <= 26 && c != '\t' && c != '\r' && c != '\n' && c != 0x08)
+			tap(c - 1 + 'A');	// Ctrl + letter
+		else switch(c)
+		{
+		case ' ':  tap(VK_SPACE);  break;
+		case '\r':
+		case '\n': tap(VK_RETURN); break;
+		case '\t': tap(VK_TAB);    break;
+		case 0x08:
+		case 0x7F: tap(VK_BACK);   break;
+		case 0x1B: tap(VK_ESCAPE); break;
+		default:   break;	// punctuation and UTF-8 bytes have no key code
+		}
+	}
+
+	m_sInput.erase(0, i);
+	if(m_sInput != "\x1B")
+		m_tpEscape = std::chrono::steady_clock::time_point();
+	return n;
+}
+//-----------------------------------------------------------------------------
+
+#endif
+//-----------------------------------------------------------------------------
@@ -0,0 +1,116 @@
+//---------------------------------------------------------------------------//
+//  ANSI/VT100 terminal backend.
+//
+//  Draws into any VT compatible terminal (Linux terminals, SSH sessions,
+//  Windows 10+ consoles). The dirty regions of each frame are diffed against
+//  the last presented one and only the changed runs of cells are sent:
+//
+//   - the cursor is only moved where a run does not start right where the
+//     previous one left it, using whichever escape sequence is shorter
+//   - the current SGR (colour) state is remembered across runs and frames,
+//     so cells sharing the same Attributes never repeat their colour codes
+//   - short gaps of unchanged cells inside a run are rewritten rather than
+//     skipped, as that is cheaper than another cursor move
+//   - the whole frame is assembled in memory and pushed with a single write
+//
+//  On POSIX systems the terminal is put in raw mode and read for keys and
+//  SGR mouse reports. Terminals only send key presses, never releases, so a
+//  key is taken as held from its first byte for as long as the terminal's
+//  autorepeat keeps sending it, and released once it has gone quiet for a
+//  while (see SetKeyHold()). That has a few limits:
+//
+//   - a quick tap stays held for the whole first timeout, which has to
+//     outlast the delay before the terminal starts repeating
+//   - terminals only repeat the last key pressed, so of two keys held
+//     together the first one is released after a while
+//   - keys without a byte of their own (Shift, Ctrl, Alt alone) are never
+//     seen
+//   - Escape is reported a little late, as an ESC at the end of a read may
+//     be the start of a sequence whose rest has not arrived yet
+//---------------------------------------------------------------------------//
+
+//-----------------------------------------------------------------------------
+#pragma once
+//-----------------------------------------------------------------------------
+#include <chrono>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <termios.h>
+#endif
+//-----------------------------------------------------------------------------
+#include "olcRenderBackend.h"
+//-----------------------------------------------------------------------------
+
+class olcAnsiBackend : public olcRenderBackend
+{
+private:
+	olcCellBuffer          m_bufPresented;
+	std::string            m_sFrame;
+	std::string            m_sPendingTitle;
+	int                    m_nWidth        = 0;
+	int                    m_nHeight       = 0;
+	int                    m_nCursorX      = -1;
+	int                    m_nCursorY      = -1;
+	int                    m_nAttributes   = -1;
+	bool                   m_bRepaint      = true;
+	bool                   m_bConstructed  = false;
+	size_t                 m_nLastFrameBytes = 0;
+	std::chrono::steady_clock::time_point m_tpLastTitle;
+
+#ifndef _WIN32
+	struct sHeldKey
+	{
+		int  nKey;
+		bool bRepeated;
+		std::chrono::steady_clock::time_point tpLast;
+	};
+
+	struct termios         m_termOriginal;
+	bool                   m_bRawInput     = false;
+	std::string            m_sInput;
+	std::vector<sHeldKey>  m_vecHeldKeys;
+	std::chrono::steady_clock::time_point m_tpEscape;	// when a lone trailing ESC was first seen
+	std::chrono::milliseconds m_durEscapeWait    { 25 };
+	std::chrono::milliseconds m_durKeyHoldFirst  { 500 };
+	std::chrono::milliseconds m_durKeyHoldRepeat { 100 };
+
+	int  ParseInput(olcInputEvent *pEvents, int nMax);
+	int  ReleaseKeys(olcInputEvent *pEvents, int nMax);
+#endif
+
+	void MoveCursor(int x, int y);
+	void SetAttributes(int attr);
+	void EmitGlyph(wchar_t c);
+	void PresentSpan(const olcCellBuffer &buf, int y, int x1, int x2);
+	void Flush();
+
+public:
+	~olcAnsiBackend();
+
+	int  Construct(int &width, int &height, int fontw, int fonth) override;
+	void Present(const olcCellBuffer &buf, const sCellRect *pRegions, int nRegions) override;
+	void SetTitle(const std::wstring &sTitle) override;
+#ifdef _WIN32
+	void PollKeyboard(short *pKeyState) override;
+#else
+	int  WaitInput(olcInputEvent *pEvents, int nMax, int nTimeoutMs) override;
+	bool HasInput() const override { return m_bRawInput; }
+#endif
+
+	// Force the next Present() to repaint every cell
+	void   Invalidate()            { m_bRepaint = true; }
+	size_t LastFrameBytes() const  { return m_nLastFrameBytes; }
+
+#ifndef _WIN32
+	// How long a key stays held without a repeat: after its first press, and
+	// once it has started repeating. Call before Start().
+	void   SetKeyHold(int nFirstMs, int nRepeatMs)
+	{
+		m_durKeyHoldFirst  = std::chrono::milliseconds(nFirstMs);
+		m_durKeyHoldRepeat = std::chrono::milliseconds(nRepeatMs);
+	}
+#endif
+};
+//-----------------------------------------------------------------------------
@@ -0,0 +1,206 @@
+//-----------------------------------------------------------------------------
+#include "olcAssetLoader.h"
+
+#include <algorithm>
+//-----------------------------------------------------------------------------
+
+olcAssetLoader::~olcAssetLoader()
+{
+	Stop();
+}
+//-----------------------------------------------------------------------------
+
+void olcAssetLoader::Start(int nWorkers)
+{
+	//-- Join any running workers, but keep their queue. The workers need the
+	//   lock to finish, so they are joined outside it, while the list (which
+	//   Wait() looks at) only changes under it.
+	{
+		std::lock_guard<std::mutex> lock(m_mux);
+		m_bQuit = true;
+	}
+	m_cvWork.notify_all();
+	for(std::thread &t : m_vecThreads)
+		t.join();
+
+	if(nWorkers < 0)
+		nWorkers = std::max(int(std::thread::hardware_concurrency()) - 1, 1);
+	std::lock_guard<std::mutex> lock(m_mux);
+	m_vecThreads.clear();
+	m_bQuit = false;
+	for(int i = 0; i < nWorkers; ++i)
+		m_vecThreads.emplace_back(&olcAssetLoader::WorkerThread, this);
+	//-- Without workers, waits on queued loads give up
+	m_cvDone.notify_all();
+}
+//-----------------------------------------------------------------------------
+
+void olcAssetLoader::Stop()
+{
+	Start(0);
+
+	std::lock_guard<std::mutex> lock(m_mux);
+	for(auto &queued : m_mapQueue)
+	{
+		queued.second->nState.store(ASSET_CANCELLED, std::memory_order_release);
+		m_mapCache.erase(queued.second->sFile);
+	}
+	m_mapQueue.clear();
+	m_cvDone.notify_all();
+}
+//-----------------------------------------------------------------------------
+
+void olcAssetLoader::WorkerThread()
+{
+	std::unique_lock<std::mutex> lock(m_mux);
+	while(true)
+	{
+		m_cvWork.wait(lock, [&] { return m_bQuit || !m_mapQueue.empty(); });
+		if(m_bQuit)
+			break;
+
+		AssetPtr pAsset = m_mapQueue.begin()->second;
+		m_mapQueue.erase(m_mapQueue.begin());
+		pAsset->nState.store(ASSET_LOADING, std::memory_order_release);
+		++m_nLoading;
+		lock.unlock();
+
+		//-- The file is read and the sprite allocated here, off the game
+		//   thread
+		std::unique_ptr<olcSprite> pSprite(new olcSprite());
+		bool bLoaded = pSprite->Load(pAsset->sFile);
+
+		lock.lock();
+		--m_nLoading;
+		if(pAsset->bCancel)
+			pAsset->nState.store(ASSET_CANCELLED, std::memory_order_release);
+		else if(bLoaded)
+		{
+			pAsset->pSprite = std::move(pSprite);
+			pAsset->nState.store(ASSET_READY, std::memory_order_release);
+		}
+		else
+		{
+			//-- Not cached, so the file can be tried again once it is there
+			pAsset->nState.store(ASSET_FAILED, std::memory_order_release);
+			auto it = m_mapCache.find(pAsset->sFile);
+			if(it != m_mapCache.end() && it->second == pAsset)
+				m_mapCache.erase(it);
+		}
+		m_cvDone.notify_all();
+	}
+}
+//-----------------------------------------------------------------------------
+
+olcSpriteHandle olcAssetLoader::LoadSprite(const std::wstring &sFile, int nPriority)
+{
+	olcSpriteHandle handle;
+	std::lock_guard<std::mutex> lock(m_mux);
+
+	auto it = m_mapCache.find(sFile);
+	int  nCached = it != m_mapCache.end() ? it->second->nState.load(std::memory_order_relaxed) : ASSET_CANCELLED;
+	if(nCached != ASSET_CANCELLED && nCached != ASSET_FAILED)
+	{
+		handle.m_pAsset = it->second;
+		if(handle.m_pAsset->nState.load(std::memory_order_relaxed) == ASSET_QUEUED && -nPriority < handle.m_pAsset->key.first)
+		{
+			m_mapQueue.erase(handle.m_pAsset->key);
+			handle.m_pAsset->key.first = -nPriority;
+			m_mapQueue[handle.m_pAsset->key] = handle.m_pAsset;
+		}
+		return handle;
+	}
+
+	handle.m_pAsset = std::make_shared<olcSpriteHandle::sAsset>();
+	handle.m_pAsset->sFile        = sFile;
+	handle.m_pAsset->pPlaceholder = m_pPlaceholder;
+	handle.m_pAsset->key          = { -nPriority, m_nOrder++ };
+	m_mapCache[sFile] = handle.m_pAsset;
+	m_mapQueue[handle.m_pAsset->key] = handle.m_pAsset;
+	m_cvWork.notify_one();
+	return handle;
+}
+//-----------------------------------------------------------------------------
+
+void olcAssetLoader::SetPriority(const olcSpriteHandle &handle, int nPriority)
+{
+	if(!handle.Valid())
+		return;
+	std::lock_guard<std::mutex> lock(m_mux);
+	AssetPtr pAsset = handle.m_pAsset;
+	if(pAsset->nState.load(std::memory_order_relaxed) != ASSET_QUEUED)
+		return;
+	m_mapQueue.erase(pAsset->key);
+	pAsset->key.first = -nPriority;
+	m_mapQueue[pAsset->key] = pAsset;
+}
+//-----------------------------------------------------------------------------
+
+bool olcAssetLoader::Cancel(const olcSpriteHandle &handle)
+{
+	if(!handle.Valid())
+		return false;
+	std::lock_guard<std::mutex> lock(m_mux);
+	AssetPtr pAsset = handle.m_pAsset;
+	int      nState = pAsset->nState.load(std::memory_order_relaxed);
+	if(nState != ASSET_QUEUED && nState != ASSET_LOADING)
+		return false;
+
+	//-- Only uncache it if the cache still holds this load of the file
+	auto it = m_mapCache.find(pAsset->sFile);
+	if(it != m_mapCache.end() && it->second == pAsset)
+		m_mapCache.erase(it);
+
+	if(nState == ASSET_QUEUED)
+	{
+		m_mapQueue.erase(pAsset->key);
+		pAsset->nState.store(ASSET_CANCELLED, std::memory_order_release);
+		m_cvDone.notify_all();
+	}
+	else
+		pAsset->bCancel = true;
+	return true;
+}
+//-----------------------------------------------------------------------------
+
+bool olcAssetLoader::Wait(const olcSpriteHandle &handle)
+{
+	if(!handle.Valid())
+		return false;
+	std::unique_lock<std::mutex> lock(m_mux);
+	m_cvDone.wait(lock, [&]
+	{
+		int nState = handle.m_pAsset->nState.load(std::memory_order_relaxed);
+		return nState != ASSET_LOADING && (nState != ASSET_QUEUED || m_vecThreads.empty());
+	});
+	return handle.Ready();
+}
+//-----------------------------------------------------------------------------
+
+void olcAssetLoader::WaitAll()
+{
+	std::unique_lock<std::mutex> lock(m_mux);
+	m_cvDone.wait(lock, [&] { return m_nLoading == 0 && (m_mapQueue.empty() || m_vecThreads.empty()); });
+}
+//-----------------------------------------------------------------------------
+
+size_t olcAssetLoader::Pending()
+{
+	std::lock_guard<std::mutex> lock(m_mux);
+	return m_mapQueue.size() + size_t(m_nLoading);
+}
+//-----------------------------------------------------------------------------
+
+void olcAssetLoader::Evict(const std::wstring &sFile)
+{
+	std::lock_guard<std::mutex> lock(m_mux);
+	m_mapCache.erase(sFile);
+}
+//-----------------------------------------------------------------------------
+
+void olcAssetLoader::ClearCache()
+{
+	std::lock_guard<std::mutex> lock(m_mux);
+	m_mapCache.clear();
+}
+//-----------------------------------------------------------------------------
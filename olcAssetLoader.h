@@ -0,0 +1,136 @@
+//---------------------------------------------------------------------------//
+//  Asynchronous asset loading.
+//
+//  olcAssetLoader reads sprites on worker threads of its own, so a level
+//  can be loaded without stalling the game loop. LoadSprite() only queues
+//  the file and returns a handle at once. The handle gives the sprite when
+//  it is ready, and the placeholder (if there is one) until then or if the
+//  load fails.
+//
+//  Queued loads are taken highest priority first, in request order within
+//  a priority. Requests for a file already loaded or on its way share the
+//  one handle: the cache maps each file name to its handle until it is
+//  evicted (or its load fails, so a file written later can still load). A
+//  load still in the queue can be cancelled. One already being read runs to
+//  the end, and its sprite is dropped.
+//
+//  Handles hold their sprite, so a sprite stays valid for as long as some
+//  handle to it does, even once evicted from the cache or after the loader
+//  is gone.
+//---------------------------------------------------------------------------//
+
+//-----------------------------------------------------------------------------
+#pragma once
+//-----------------------------------------------------------------------------
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+//-----------------------------------------------------------------------------
+#include "olcConsoleGameEngine.h"
+//-----------------------------------------------------------------------------
+
+enum ASSET_STATE
+{
+	ASSET_QUEUED    = 0,
+	ASSET_LOADING   = 1,
+	ASSET_READY     = 2,
+	ASSET_FAILED    = 3,
+	ASSET_CANCELLED = 4,
+};
+//-----------------------------------------------------------------------------
+
+class olcSpriteHandle
+{
+private:
+	struct sAsset
+	{
+		std::wstring               sFile;
+		std::atomic<int>           nState{ ASSET_QUEUED };
+		std::unique_ptr<olcSprite> pSprite;		// set before nState turns ASSET_READY
+		olcSprite*                 pPlaceholder = nullptr;
+		std::pair<int, uint64_t>   key;			// in the queue: -priority, request order
+		bool                       bCancel      = false;
+	};
+	std::shared_ptr<sAsset> m_pAsset;
+	friend class olcAssetLoader;
+
+public:
+	bool        Valid() const { return m_pAsset != nullptr; }
+	ASSET_STATE State() const { return m_pAsset ? ASSET_STATE(m_pAsset->nState.load(std::memory_order_acquire)) : ASSET_FAILED; }
+	bool        Ready() const { return State() == ASSET_READY; }
+
+	// The sprite once it is ready, the placeholder otherwise (nullptr if
+	// there is none)
+	olcSprite*  Get() const
+	{
+		if(!m_pAsset)
+			return nullptr;
+		return Ready() ? m_pAsset->pSprite.get() : m_pAsset->pPlaceholder;
+	}
+};
+//-----------------------------------------------------------------------------
+
+class olcAssetLoader
+{
+private:
+	typedef std::shared_ptr<olcSpriteHandle::sAsset> AssetPtr;
+
+	std::vector<std::thread>   m_vecThreads;
+	std::mutex                 m_mux;
+	std::condition_variable    m_cvWork;
+	std::condition_variable    m_cvDone;
+	std::map<std::pair<int, uint64_t>, AssetPtr> m_mapQueue;
+	std::unordered_map<std::wstring, AssetPtr>   m_mapCache;
+	uint64_t                   m_nOrder       = 0;
+	int                        m_nLoading     = 0;
+	bool                       m_bQuit        = false;
+	olcSprite*                 m_pPlaceholder = nullptr;
+
+	void WorkerThread();
+
+public:
+	explicit olcAssetLoader(int nWorkers = 2) { Start(nWorkers); }
+	~olcAssetLoader();
+	olcAssetLoader(const olcAssetLoader&) = delete;
+	olcAssetLoader& operator=(const olcAssetLoader&) = delete;
+
+	// Start nWorkers threads, replacing any running ones. Negative picks one
+	// less than the number of hardware threads. Stopping cancels everything
+	// still queued.
+	void Start(int nWorkers = 2);
+	void Stop();
+
+	// Shown by handles of later loads until their sprite is ready. Must
+	// outlive those handles.
+	void SetPlaceholder(olcSprite *pPlaceholder) { m_pPlaceholder = pPlaceholder; }
+
+	// Queue a sprite file, or return the handle of the load of it already
+	// cached (raised to nPriority if still queued). A file whose load was
+	// cancelled or failed is queued again.
+	olcSpriteHandle LoadSprite(const std::wstring &sFile, int nPriority = 0);
+	// Move a queued load within the queue
+	void SetPriority(const olcSpriteHandle &handle, int nPriority);
+	// Give up on a load: taken out of the queue, or dropped when its read
+	// ends. Affects every handle sharing it. False if already done.
+	bool Cancel(const olcSpriteHandle &handle);
+
+	// Block until the load is over, true if the sprite is ready
+	bool Wait(const olcSpriteHandle &handle);
+	void WaitAll();
+	// Loads queued or being read
+	size_t Pending();
+
+	// Forget cached files, so the next load reads them again. Handles keep
+	// their sprites.
+	void Evict(const std::wstring &sFile);
+	void ClearCache();
+};
+//-----------------------------------------------------------------------------
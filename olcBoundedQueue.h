@@ -0,0 +1,71 @@
+//---------------------------------------------------------------------------//
+//  Blocking bounded queue.
+//
+//  Connects the stages of a pipeline running on threads of their own. Push()
+//  waits while the queue is full and Pop() while it is empty, so a fast
+//  stage is held back by a slow one instead of running ahead of it. Close()
+//  ends the stream: Push() fails from then on, and Pop() fails once the
+//  items already queued are drained.
+//---------------------------------------------------------------------------//
+
+//-----------------------------------------------------------------------------
+#pragma once
+//-----------------------------------------------------------------------------
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <utility>
+//-----------------------------------------------------------------------------
+
+template<typename T>
+class olcBoundedQueue
+{
+private:
+	std::mutex              m_mux;
+	std::condition_variable m_cvPush;
+	std::condition_variable m_cvPop;
+	std::deque<T>           m_queue;
+	size_t                  m_nCapacity;
+	bool                    m_bClosed = false;
+
+public:
+	explicit olcBoundedQueue(size_t nCapacity) : m_nCapacity(nCapacity > 0 ? nCapacity : 1) {}
+
+	olcBoundedQueue(const olcBoundedQueue&) = delete;
+	olcBoundedQueue& operator=(const olcBoundedQueue&) = delete;
+
+	// False if the queue was closed, the item is not taken then
+	bool Push(T &&item)
+	{
+		std::unique_lock<std::mutex> lock(m_mux);
+		m_cvPush.wait(lock, [&] { return m_bClosed || m_queue.size() < m_nCapacity; });
+		if(m_bClosed)
+			return false;
+		m_queue.push_back(std::move(item));
+		m_cvPop.notify_one();
+		return true;
+	}
+
+	// False once the queue is closed and empty
+	bool Pop(T &item)
+	{
+		std::unique_lock<std::mutex> lock(m_mux);
+		m_cvPop.wait(lock, [&] { return m_bClosed || !m_queue.empty(); });
+		if(m_queue.empty())
+			return false;
+		item = std::move(m_queue.front());
+		m_queue.pop_front();
+		m_cvPush.notify_one();
+		return true;
+	}
+
+	void Close()
+	{
+		std::lock_guard<std::mutex> lock(m_mux);
+		m_bClosed = true;
+		m_cvPush.notify_all();
+		m_cvPop.notify_all();
+	}
+};
+//-----------------------------------------------------------------------------
@@ -0,0 +1,62 @@
+//---------------------------------------------------------------------------//
+//  Engine cells.
+//
+//  Screens, layers and recorded frames are kept as two planes rather than
+//  as an array of Win32 CHAR_INFO: a glyph per cell, and a byte of
+//  attributes per cell (foreground colour in the low nibble, background in
+//  the high one, as in COLOUR). Fills and clears store whole vectors of one
+//  plane at a time, diffs compare planes with memcmp, and none of it needs
+//  a Windows header. Backends convert to whatever their device takes when
+//  they present (see olcCellKernels.h).
+//---------------------------------------------------------------------------//
+
+//-----------------------------------------------------------------------------
+#pragma once
+//-----------------------------------------------------------------------------
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+//-----------------------------------------------------------------------------
+
+// An inclusive rectangle of cells, laid out like the Win32 SMALL_RECT
+struct sCellRect
+{
+	short Left;
+	short Top;
+	short Right;
+	short Bottom;
+};
+//-----------------------------------------------------------------------------
+
+class olcCellBuffer
+{
+private:
+	int                  m_nWidth  = 0;
+	int                  m_nHeight = 0;
+	std::vector<wchar_t> m_vecGlyphs;
+	std::vector<uint8_t> m_vecAttributes;
+
+public:
+	olcCellBuffer() {}
+	olcCellBuffer(int w, int h) { Resize(w, h); }
+
+	// Resize and blank every cell (glyph 0, black on black)
+	void Resize(int w, int h)
+	{
+		m_nWidth  = w;
+		m_nHeight = h;
+		m_vecGlyphs.assign(size_t(w) * size_t(h), 0);
+		m_vecAttributes.assign(size_t(w) * size_t(h), 0);
+	}
+
+	int    Width() const  { return m_nWidth;  }
+	int    Height() const { return m_nHeight; }
+	size_t Size() const   { return m_vecGlyphs.size(); }
+
+	// Row-major planes, Size() entries each
+	wchar_t*       Glyphs()           { return m_vecGlyphs.data(); }
+	const wchar_t* Glyphs() const     { return m_vecGlyphs.data(); }
+	uint8_t*       Attributes()       { return m_vecAttributes.data(); }
+	const uint8_t* Attributes() const { return m_vecAttributes.data(); }
+};
+//-----------------------------------------------------------------------------
@@ -0,0 +1,138 @@
+//-----------------------------------------------------------------------------
+#include "olcCellKernels.h"
+
+#include <cstring>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define OLC_CELLS_AVX2
+#define OLC_CELLS_SSE2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OLC_CELLS_SSE2
+#endif
+//-----------------------------------------------------------------------------
+
+// wchar_t is UTF-16 on Windows and 32 bits wide elsewhere
+static_assert(sizeof(wchar_t) == 2 || sizeof(wchar_t) == 4, "unexpected wchar_t size");
+//-----------------------------------------------------------------------------
+
+void olcFillCells(wchar_t *pGlyphs, uint8_t *pAttributes, size_t n, wchar_t c, uint8_t col)
+{
+	memset(pAttributes, col, n);
+
+	uint8_t *p   = reinterpret_cast<uint8_t*>(pGlyphs);
+	uint8_t *end = p + n * sizeof(wchar_t);
+
+#if defined(OLC_CELLS_AVX2)
+	__m256i v = sizeof(wchar_t) == 2 ? _mm256_set1_epi16(short(c)) : _mm256_set1_epi32(int(c));
+	for(; end - p >= 64; p += 64)
+	{
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(p + 32), v);
+	}
+	if(end - p >= 32)
+	{
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v);
+		p += 32;
+	}
+#elif defined(OLC_CELLS_SSE2)
+	__m128i v = sizeof(wchar_t) == 2 ? _mm_set1_epi16(short(c)) : _mm_set1_epi32(int(c));
+	for(; end - p >= 64; p += 64)
+	{
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(p), v);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(p + 16), v);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(p + 32), v);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(p + 48), v);
+	}
+	for(; end - p >= 16; p += 16)
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(p), v);
+#endif
+
+	//-- Whatever is left over (or everything, without SIMD)
+	for(; p < end; p += sizeof(wchar_t))
+		memcpy(p, &c, sizeof(wchar_t));
+}
+//-----------------------------------------------------------------------------
+
+void olcPackCells(const wchar_t *pGlyphs, const uint8_t *pAttributes, size_t n, uint32_t *pDst)
+{
+	size_t i = 0;
+
+#if defined(OLC_CELLS_SSE2)
+	const __m128i zero = _mm_setzero_si128();
+	for(; i + 8 <= n; i += 8)
+	{
+		//-- Eight glyphs as 16-bit lanes. 32-bit ones are truncated the way
+		//   the scalar cast does: sign extend the low half, then pack
+		__m128i g;
+		if(sizeof(wchar_t) == 2)
+			g = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pGlyphs + i));
+		else
+		{
+			__m128i g0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pGlyphs + i));
+			__m128i g1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pGlyphs + i + 4));
+			g0 = _mm_srai_epi32(_mm_slli_epi32(g0, 16), 16);
+			g1 = _mm_srai_epi32(_mm_slli_epi32(g1, 16), 16);
+			g  = _mm_packs_epi32(g0, g1);
+		}
+
+		//-- Eight attribute bytes widened to 16 bits, then interleaved
+		__m128i a = _mm_unpacklo_epi8(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(pAttributes + i)), zero);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + i),     _mm_unpacklo_epi16(g, a));
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(pDst + i + 4), _mm_unpackhi_epi16(g, a));
+	}
+#endif
+
+	for(; i < n; ++i)
+		pDst[i] = uint32_t(uint16_t(pGlyphs[i])) | (uint32_t(pAttributes[i]) << 16);
+}
+//-----------------------------------------------------------------------------
+
+void olcPackHalfBlocks(const uint8_t *pTop, const uint8_t *pBottom, size_t n, wchar_t *pGlyphs, uint8_t *pAttributes)
+{
+	const wchar_t HALF_BLOCK  = 0x2580;
+	const wchar_t SOLID_BLOCK = 0x2588;
+	size_t i = 0;
+
+#if defined(OLC_CELLS_SSE2)
+	const __m128i zero   = _mm_setzero_si128();
+	const __m128i nibble = _mm_set1_epi8(0x0F);
+	const __m128i solid  = _mm_set1_epi8(char(SOLID_BLOCK - HALF_BLOCK));
+	const __m128i half   = _mm_set1_epi16(short(HALF_BLOCK));
+	for(; i + 16 <= n; i += 16)
+	{
+		__m128i t = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pTop + i)), nibble);
+		__m128i b = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(pBottom + i)), nibble);
+
+		//-- Top colour is the foreground. The shift is by 16-bit lanes, but a
+		//   nibble moved up by 4 never leaves its byte.
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(pAttributes + i), _mm_or_si128(t, _mm_slli_epi16(b, 4)));
+
+		//-- U+2580, plus the distance to U+2588 where the pair matches
+		__m128i d  = _mm_and_si128(_mm_cmpeq_epi8(t, b), solid);
+		__m128i g0 = _mm_add_epi16(_mm_unpacklo_epi8(d, zero), half);
+		__m128i g1 = _mm_add_epi16(_mm_unpackhi_epi8(d, zero), half);
+		if(sizeof(wchar_t) == 2)
+		{
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(pGlyphs + i),     g0);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(pGlyphs + i + 8), g1);
+		}
+		else
+		{
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(pGlyphs + i),      _mm_unpacklo_epi16(g0, zero));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(pGlyphs + i + 4),  _mm_unpackhi_epi16(g0, zero));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(pGlyphs + i + 8),  _mm_unpacklo_epi16(g1, zero));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(pGlyphs + i + 12), _mm_unpackhi_epi16(g1, zero));
+		}
+	}
+#endif
+
+	for(; i < n; ++i)
+	{
+		uint8_t t = pTop[i] & 0x0F, b = pBottom[i] & 0x0F;
+		pAttributes[i] = uint8_t(t | (b << 4));
+		pGlyphs[i]     = t == b ? SOLID_BLOCK : HALF_BLOCK;
+	}
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,30 @@
+//---------------------------------------------------------------------------//
+//  Cell kernels.
+//
+//  Bulk operations on runs of screen cells (see olcCellBuffer.h) used by the
+//  drawing routines and the backends. They work a whole SIMD register at a
+//  time; SSE2 is used where the compiler targets it (always on x86-64),
+//  AVX2 when enabled, plain loops otherwise.
+//---------------------------------------------------------------------------//
+
+//-----------------------------------------------------------------------------
+#pragma once
+//-----------------------------------------------------------------------------
+#include <cstddef>
+#include <cstdint>
+//-----------------------------------------------------------------------------
+#include "olcCellBuffer.h"
+//-----------------------------------------------------------------------------
+
+// Set n consecutive cells to the same glyph and attributes
+void olcFillCells(wchar_t *pGlyphs, uint8_t *pAttributes, size_t n, wchar_t c, uint8_t col);
+
+// Interleave n cells into 32-bit words, UTF-16 glyph in the low half and
+// attributes in the high one: the layout of a Win32 CHAR_INFO
+void olcPackCells(const wchar_t *pGlyphs, const uint8_t *pAttributes, size_t n, uint32_t *pDst);
+
+// Turn n pairs of pixel colours (low nibble) into cells: an upper half block
+// (U+2580) in the top colour on the bottom one, or a solid block (U+2588)
+// where both pixels are the same colour
+void olcPackHalfBlocks(const uint8_t *pTop, const uint8_t *pBottom, size_t n, wchar_t *pGlyphs, uint8_t *pAttributes);
+//-----------------------------------------------------------------------------
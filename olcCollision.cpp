@@ -0,0 +1,166 @@
+//-----------------------------------------------------------------------------
+#include "olcCollision.h"
+
+#include <algorithm>
+#include <climits>
+//-----------------------------------------------------------------------------
+
+void olcCollisionMask::Build(const olcSprite *sprite)
+{
+	m_nWidth  = sprite ? sprite->nWidth  : 0;
+	m_nHeight = sprite ? sprite->nHeight : 0;
+	m_nStride = (m_nWidth + 63) / 64 + 1;
+	m_vecBits.assign(size_t(m_nStride) * size_t(m_nHeight), 0);
+
+	for(int y = 0; y < m_nHeight; ++y)
+	{
+		const wchar_t *glyphs = sprite->Glyphs() + y * m_nWidth;
+		uint64_t      *row    = m_vecBits.data() + size_t(y) * size_t(m_nStride);
+		for(int x = 0; x < m_nWidth; ++x)
+			if(glyphs[x] != L' ')
+				row[x >> 6] |= uint64_t(1) << (x & 63);
+	}
+}
+//-----------------------------------------------------------------------------
+
+bool olcCollisionMask::Test(int x, int y) const
+{
+	if(x < 0 || y < 0 || x >= m_nWidth || y >= m_nHeight)
+		return false;
+	return (m_vecBits[size_t(y) * size_t(m_nStride) + size_t(x >> 6)] >> (x & 63)) & 1;
+}
+//-----------------------------------------------------------------------------
+
+// The 64 cells of a row from column nBit on. Rows end in a spare zero word,
+// so the word after the one holding nBit can always be read.
+static inline uint64_t MaskWindow(const uint64_t *row, int nBit)
+{
+	int k = nBit >> 6, s = nBit & 63;
+	return s == 0 ? row[k] : (row[k] >> s) | (row[k + 1] << (64 - s));
+}
+//-----------------------------------------------------------------------------
+
+bool olcCollisionMask::Overlaps(int x, int y, const olcCollisionMask &other, int ox, int oy) const
+{
+	int x1 = std::max(x, ox);
+	int y1 = std::max(y, oy);
+	int x2 = std::min(x + m_nWidth,  ox + other.m_nWidth);
+	int y2 = std::min(y + m_nHeight, oy + other.m_nHeight);
+	if(x1 >= x2 || y1 >= y2)
+		return false;
+
+	//-- Bits past x2 are past the end of one mask or the other, and so zero
+	//   in it: the last window of a row needs no trimming
+	for(int j = y1; j < y2; ++j)
+	{
+		const uint64_t *a = m_vecBits.data() + size_t(j - y) * size_t(m_nStride);
+		const uint64_t *b = other.m_vecBits.data() + size_t(j - oy) * size_t(other.m_nStride);
+		for(int i = x1; i < x2; i += 64)
+			if(MaskWindow(a, i - x) & MaskWindow(b, i - ox))
+				return true;
+	}
+	return false;
+}
+//-----------------------------------------------------------------------------
+
+void olcCollisionGrid::FindPairs(const sCollider *pColliders, int nColliders, std::vector<std::pair<int, int>> &vecPairs)
+{
+	vecPairs.clear();
+	auto live = [&](int i)
+	{
+		const olcCollisionMask *pMask = pColliders[i].pMask;
+		return pMask != nullptr && pMask->Width() > 0 && pMask->Height() > 0;
+	};
+
+	//-- Bounds of the whole scene, and the mean collider extent
+	long long nMinX = LLONG_MAX, nMinY = LLONG_MAX, nMaxX = LLONG_MIN, nMaxY = LLONG_MIN;
+	long long nExtent = 0;
+	int       nLive   = 0;
+	for(int i = 0; i < nColliders; ++i)
+	{
+		if(!live(i))
+			continue;
+		const sCollider &c = pColliders[i];
+		nMinX = std::min(nMinX, (long long)c.x);
+		nMinY = std::min(nMinY, (long long)c.y);
+		nMaxX = std::max(nMaxX, (long long)c.x + c.pMask->Width());
+		nMaxY = std::max(nMaxY, (long long)c.y + c.pMask->Height());
+		nExtent += std::max(c.pMask->Width(), c.pMask->Height());
+		++nLive;
+	}
+	if(nLive < 2)
+		return;
+
+	//-- A sparse scene would need a huge grid, coarsen it until there are
+	//   at most a few grid cells per collider
+	long long nCell = m_nCellSize > 0 ? m_nCellSize : std::max(2 * nExtent / nLive, 1LL);
+	long long nGridW, nGridH;
+	while(true)
+	{
+		nGridW = (nMaxX - nMinX + nCell - 1) / nCell;
+		nGridH = (nMaxY - nMinY + nCell - 1) / nCell;
+		if(nGridW * nGridH <= 4LL * nLive + 64)
+			break;
+		nCell *= 2;
+	}
+
+	//-- Counting sort of the colliders into every grid cell their box
+	//   covers. Filling backwards leaves each cell's list in index order.
+	m_vecBounds.resize(size_t(nColliders) * 4);
+	m_vecCellStart.assign(size_t(nGridW * nGridH) + 1, 0);
+	for(int i = 0; i < nColliders; ++i)
+	{
+		if(!live(i))
+			continue;
+		const sCollider &c = pColliders[i];
+		int *b = &m_vecBounds[size_t(i) * 4];
+		b[0] = int((c.x - nMinX) / nCell);
+		b[1] = int((c.y - nMinY) / nCell);
+		b[2] = int((c.x + c.pMask->Width()  - 1 - nMinX) / nCell);
+		b[3] = int((c.y + c.pMask->Height() - 1 - nMinY) / nCell);
+		for(int gy = b[1]; gy <= b[3]; ++gy)
+			for(int gx = b[0]; gx <= b[2]; ++gx)
+				m_vecCellStart[size_t(gy * nGridW + gx)]++;
+	}
+	for(size_t g = 1; g < m_vecCellStart.size(); ++g)
+		m_vecCellStart[g] += m_vecCellStart[g - 1];
+	m_vecEntries.resize(size_t(m_vecCellStart.back()));
+	for(int i = nColliders - 1; i >= 0; --i)
+	{
+		if(!live(i))
+			continue;
+		const int *b = &m_vecBounds[size_t(i) * 4];
+		for(int gy = b[1]; gy <= b[3]; ++gy)
+			for(int gx = b[0]; gx <= b[2]; ++gx)
+				m_vecEntries[size_t(--m_vecCellStart[size_t(gy * nGridW + gx)])] = i;
+	}
+
+	//-- Within each grid cell, boxes first, then masks. A pair sharing
+	//   several cells is only taken in the one holding the top left corner
+	//   of the overlap of their boxes.
+	for(long long gy = 0; gy < nGridH; ++gy)
+	{
+		for(long long gx = 0; gx < nGridW; ++gx)
+		{
+			size_t g  = size_t(gy * nGridW + gx);
+			int    e1 = m_vecCellStart[g], e2 = m_vecCellStart[g + 1];
+			for(int ea = e1; ea < e2; ++ea)
+			{
+				const sCollider &a = pColliders[m_vecEntries[size_t(ea)]];
+				for(int eb = ea + 1; eb < e2; ++eb)
+				{
+					const sCollider &b = pColliders[m_vecEntries[size_t(eb)]];
+					long long x1 = std::max(a.x, b.x), y1 = std::max(a.y, b.y);
+					if(x1 >= std::min((long long)a.x + a.pMask->Width(),  (long long)b.x + b.pMask->Width()) ||
+					   y1 >= std::min((long long)a.y + a.pMask->Height(), (long long)b.y + b.pMask->Height()))
+						continue;
+					if((x1 - nMinX) / nCell != gx || (y1 - nMinY) / nCell != gy)
+						continue;
+					if(a.pMask->Overlaps(a.x, a.y, *b.pMask, b.x, b.y))
+						vecPairs.push_back({ m_vecEntries[size_t(ea)], m_vecEntries[size_t(eb)] });
+				}
+			}
+		}
+	}
+}
+//-----------------------------------------------------------------------------
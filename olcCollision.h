@@ -0,0 +1,78 @@
+//---------------------------------------------------------------------------//
+//  Sprite collision.
+//
+//  An olcCollisionMask holds one bit per cell of a sprite, set where the
+//  sprite is opaque (any glyph but L' ', as when drawing it), packed 64
+//  cells to a word along each row. Two masks are tested for overlap a word
+//  at a time: the rows they share are lined up by shifting, then ANDed.
+//  Like olcCompiledSprite, a mask is a snapshot, built once when the sprite
+//  is loaded; rebuild it if the sprite changes.
+//
+//  olcCollisionGrid finds every overlapping pair among many positioned
+//  masks. Colliders are binned into a uniform grid over their bounding
+//  boxes, and only colliders sharing a grid cell are compared, each pair
+//  once (in the cell holding the top left corner of the boxes' overlap).
+//  The grid lives in flat arrays that are reused from call to call.
+//---------------------------------------------------------------------------//
+
+//-----------------------------------------------------------------------------
+#pragma once
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <utility>
+#include <vector>
+//-----------------------------------------------------------------------------
+#include "olcConsoleGameEngine.h"
+//-----------------------------------------------------------------------------
+
+class olcCollisionMask
+{
+private:
+	int                   m_nWidth  = 0;
+	int                   m_nHeight = 0;
+	int                   m_nStride = 0;	// words per row, one spare
+	std::vector<uint64_t> m_vecBits;
+
+public:
+	olcCollisionMask() {}
+	explicit olcCollisionMask(const olcSprite *sprite) { Build(sprite); }
+
+	void Build(const olcSprite *sprite);
+
+	int  Width() const  { return m_nWidth;  }
+	int  Height() const { return m_nHeight; }
+
+	// Whether cell (x, y) is opaque, false outside the mask
+	bool Test(int x, int y) const;
+
+	// Whether this mask at (x, y) and other at (ox, oy) share an opaque cell
+	bool Overlaps(int x, int y, const olcCollisionMask &other, int ox, int oy) const;
+};
+//-----------------------------------------------------------------------------
+
+struct sCollider
+{
+	int                     x;
+	int                     y;
+	const olcCollisionMask *pMask;	// nullptr colliders are ignored
+};
+//-----------------------------------------------------------------------------
+
+class olcCollisionGrid
+{
+private:
+	int                   m_nCellSize;
+	std::vector<int>      m_vecCellStart;	// per grid cell, into m_vecEntries
+	std::vector<int>      m_vecEntries;		// collider indices, by grid cell
+	std::vector<int>      m_vecBounds;		// per collider: grid x1, y1, x2, y2
+
+public:
+	// Grid cells of nCellSize screen cells, 0 to size them from the
+	// colliders (twice their mean extent)
+	explicit olcCollisionGrid(int nCellSize = 0) : m_nCellSize(nCellSize) {}
+
+	// Every pair (i, j), i < j, of colliders whose masks overlap. vecPairs
+	// is replaced.
+	void FindPairs(const sCollider *pColliders, int nColliders, std::vector<std::pair<int, int>> &vecPairs);
+};
+//-----------------------------------------------------------------------------
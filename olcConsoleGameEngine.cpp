@@ -6,14 +6,28 @@
 //  option 1: Added a parameter on the engine that allow for a delay between
 //  calls to the main loop to be inserted. That "delay" time is spent checking
 //  for user input (keys pressed)
+//
+//  Now: input is read on its own thread as timestamped events, and latched
+//  until the next update sees them, so a press is never lost however long
+//  the loop sleeps. SetTargetFPS() paces the loop (see olcFrameScheduler)
+//  and SetFixedTimestep() decouples the update rate from the frame rate.
 //---------------------------------------------------------------------------//
 
 
 //-----------------------------------------------------------------------------
 #include "olcConsoleGameEngine.h"
-
+#include "olcCellKernels.h"
+#include "olcTilemap.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
 #include <cwchar>
 #include <fstream>
+#include <functional>
 #include <chrono>
 #include <vector>
 #include <list>
@@ -42,11 +56,23 @@ void olcSprite::Create(int w, int h)
 
 void olcSprite::Destroy()
 {
-	if (m_Glyphs)  delete[] m_Glyphs;
-	if (m_Colours) delete[] m_Colours;
+	if (m_bOwner && m_Glyphs)  delete[] m_Glyphs;
+	if (m_bOwner && m_Colours) delete[] m_Colours;
 
 	m_Glyphs = nullptr;
 	m_Colours = nullptr;
+	m_bOwner = true;
+}
+//-----------------------------------------------------------------------------
+
+void olcSprite::View(int w, int h, wchar_t *glyphs, short *colours)
+{
+	Destroy();
+	nWidth    = w;
+	nHeight   = h;
+	m_Glyphs  = glyphs;
+	m_Colours = colours;
+	m_bOwner  = false;
 }
 //-----------------------------------------------------------------------------
 
@@ -110,20 +136,119 @@ bool olcSprite::Load(std::wstring sFile)
 
 	std::string aux = WS2S(sFile);
 	std::ifstream f;
-	f.open(aux.c_str(), std::ios_base::binary | std::ios_base::trunc);
+	f.open(aux.c_str(), std::ios_base::binary | std::ios_base::ate);
+	if(!f.is_open())
+		return false;
+	long long nFileSize = (long long)f.tellg();
+	f.seekg(0);
+
+	int w = 0, h = 0;
+	f.read((char*)&w, sizeof(int));
+	f.read((char*)&h, sizeof(int));
+	if(!f || w <= 0 || h <= 0 || (long long)w * h > (nFileSize >> 2))
+		return false;
+
+	//-- Glyphs are stored as the writer's wchar_t, 2 bytes on Windows and 4
+	//   elsewhere. Tell them apart by what is left of the file.
+	long long nCells      = (long long)w * h;
+	long long nGlyphBytes = nFileSize - 2 * (long long)sizeof(int) - nCells * (long long)sizeof(short);
+	if(nGlyphBytes != nCells * 2 && nGlyphBytes != nCells * 4)
+		return false;
+
+	Create(w, h);
+	f.read((char*)m_Colours, sizeof(short) * nCells);
+	if(nGlyphBytes == nCells * (long long)sizeof(wchar_t))
+		f.read((char*)m_Glyphs, sizeof(wchar_t) * nCells);
+	else if(nGlyphBytes == nCells * 2)
+	{
+		std::vector<uint16_t> glyphs((size_t)nCells);
+		f.read((char*)glyphs.data(), 2 * nCells);
+		for(long long i = 0; i < nCells; ++i)
+			m_Glyphs[i] = wchar_t(glyphs[size_t(i)]);
+	}
+	else
+	{
+		std::vector<uint32_t> glyphs((size_t)nCells);
+		f.read((char*)glyphs.data(), 4 * nCells);
+		for(long long i = 0; i < nCells; ++i)
+			m_Glyphs[i] = glyphs[size_t(i)] < 0x10000 ? wchar_t(glyphs[size_t(i)]) : wchar_t(0xFFFD);
+	}
+
+	if(!f)
+	{
+		Destroy();
+		nWidth = 0;
+		nHeight = 0;
+		return false;
+	}
+	return true;
+}
+//-----------------------------------------------------------------------------
 
-	f.read((char*)&nWidth,  sizeof(int));
-	f.read((char*)&nHeight, sizeof(int));
-	Create(nWidth, nHeight);
+void olcCompiledSprite::Compile(const olcSprite *sprite)
+{
+	vecRuns.clear();
+	vecRowStart.clear();
+	vecGlyphs.clear();
+	vecAttributes.clear();
+	nWidth  = sprite ? sprite->nWidth  : 0;
+	nHeight = sprite ? sprite->nHeight : 0;
+
+	for(int y = 0; y < nHeight; ++y)
+	{
+		vecRowStart.push_back(int(vecRuns.size()));
+		const wchar_t *glyphs  = sprite->Glyphs()  + y * nWidth;
+		const short   *colours = sprite->Colours() + y * nWidth;
 
-	f.read((char*)m_Colours, sizeof(short)   * nWidth * nHeight);
-	f.read((char*)m_Glyphs,  sizeof(wchar_t) * nWidth * nHeight);
+		int x = 0;
+		while(x < nWidth)
+		{
+			if(glyphs[x] == L' ')
+			{
+				++x;
+				continue;
+			}
 
-	f.close();
+			sRun run = { x, 0, int(vecGlyphs.size()) };
+			for(; x < nWidth && glyphs[x] != L' '; ++x)
+			{
+				vecGlyphs.push_back(glyphs[x]);
+				vecAttributes.push_back(uint8_t(colours[x]));
+			}
+			run.nLength = x - run.x;
+			vecRuns.push_back(run);
+		}
+	}
+	vecRowStart.push_back(int(vecRuns.size()));
+}
+//-----------------------------------------------------------------------------
+
+bool olcFont::Create(const olcSprite *atlas, int nGlyphWidth, int nGlyphHeight, wchar_t cFirst)
+{
+	m_nGlyphs = 0;
+	if(atlas == nullptr || nGlyphWidth <= 0 || nGlyphHeight <= 0 ||
+	   atlas->nWidth < nGlyphWidth || atlas->nHeight < nGlyphHeight)
+		return false;
+
+	m_atlas.Compile(atlas);
+	m_nGlyphWidth  = nGlyphWidth;
+	m_nGlyphHeight = nGlyphHeight;
+	m_nColumns     = atlas->nWidth / nGlyphWidth;
+	m_nGlyphs      = m_nColumns * (atlas->nHeight / nGlyphHeight);
+	m_cFirst       = cFirst;
 	return true;
 }
 //-----------------------------------------------------------------------------
 
+bool olcFont::Load(const std::wstring &sFile, int nGlyphWidth, int nGlyphHeight, wchar_t cFirst)
+{
+	olcSprite atlas;
+	if(!atlas.Load(sFile))
+		return false;
+	return Create(&atlas, nGlyphWidth, nGlyphHeight, cFirst);
+}
+//-----------------------------------------------------------------------------
+
 
 
 
@@ -138,439 +263,1936 @@ bool olcSprite::Load(std::wstring sFile)
 //-----------------------------------------------------------------------------
 
 olcConsoleGameEngine::olcConsoleGameEngine()
-	: m_nScreenWidth(80)
+	: m_pBackend(olcCreateDefaultBackend())
+	, m_bDirtyTracking(true)
+	, m_nDrawFrame(0)
+	, m_nPresentBuffers(2)
+	, m_nPresentPolicy(PRESENT_BLOCK)
+	, m_nFramesDropped(0)
+	, m_bPresenterQuit(false)
+	, m_fTargetFrameTime(0.0f)
+	, m_bDeferredDrawing(false)
+	, m_pDrawLayer(nullptr)
+	, m_bLayersChanged(false)
+	, m_bPixelMode(false)
+	, m_bPixelsDirty(false)
+	, m_queueInput(4096)
+	, m_bInputQuit(false)
+	, m_nMouseLatchX(0)
+	, m_nMouseLatchY(0)
+	, m_nScreenWidth(80)
 	, m_nScreenHeight(30)
 	, m_bufScreen(nullptr)
 	, m_sAppName(L"Default")
+	, m_mousePosX(0)
+	, m_mousePosY(0)
 {
-	m_hOriginalConsole = GetStdHandle(STD_OUTPUT_HANDLE);
-	m_hConsole         = CreateConsoleScreenBuffer(GENERIC_READ | GENERIC_WRITE,
-										0, NULL, CONSOLE_TEXTMODE_BUFFER, NULL);
-	m_keyNewState      = new short[256];
-	m_keyOldState      = new short[256];
-
-	memset(m_keyNewState, 0, 256 * sizeof(short));
-	memset(m_keyOldState, 0, 256 * sizeof(short));
 	memset(m_keys, 0, 256 * sizeof(sKeyState));
+	memset(m_keyLatch, 0, 256 * sizeof(sKeyState));
+	memset(m_mouse, 0, 5 * sizeof(sKeyState));
+	memset(m_mouseLatch, 0, 5 * sizeof(sKeyState));
 }
 //-----------------------------------------------------------------------------
 
 olcConsoleGameEngine::~olcConsoleGameEngine()
 {
-	SetConsoleActiveScreenBuffer(m_hOriginalConsole);
-	if(m_hConsole)
-		CloseHandle(m_hConsole);
-	if(m_bufScreen)
-		delete[] m_bufScreen;
-	delete[] m_keyNewState;
-	delete[] m_keyOldState;
+	StopRecording();
+	m_pBackend.reset();
 }
 //-----------------------------------------------------------------------------
 
 void olcConsoleGameEngine::GameThread()
 {
+	olcProfiler::SetThreadName("Game");
+
 	// Create user resources as part of this thread
 	if (!OnUserCreate())
-		return;
+		m_bAtomActive = false;
+
+	StartPresenter();
+	StartInput();
 
-	wchar_t s[128];
-	std::chrono::system_clock::time_point tp1;
-	auto    tp2    = std::chrono::system_clock::now();
-	float   fEtime = 0.0;
+	float fEtime = 0.0f;
+
+	UpdateFramePacing();
+	m_scheduler.Reset();
 
-	// Run as fast as possible
 	while(m_bAtomActive)
 	{
 		// Handle Timing
-		tp1    = tp2;
-		tp2    = std::chrono::system_clock::now();
-		fEtime = std::chrono::duration<float>(tp2 - tp1).count();
+		fEtime = m_scheduler.BeginFrame();
+		int64_t nProfileFrame = olcProfiler::BeginFrame();
 
-		// Handle keyboard input
-		handleKeyboardInput();
+		// Handle keyboard and mouse input gathered by the input thread
+		{
+			OLC_PROFILE_ZONE("Input");
+			handleInput();
+		}
 
-		// Handle Mouse Input - Check for window events
-		handleMouseInput();
+		// Handle Frame Update, either one variable step or as many fixed
+		// steps as the time elapsed allows
+		if(m_scheduler.FixedStep() > 0.0f)
+		{
+			while(m_bAtomActive && m_scheduler.ConsumeStep())
+			{
+				commitInput();
+				OLC_PROFILE_ZONE("OnUserUpdate");
+				if(!OnUserUpdate(m_scheduler.FixedStep()))
+					m_bAtomActive = false;
+			}
+		}
+		else
+		{
+			commitInput();
+			OLC_PROFILE_ZONE("OnUserUpdate");
+			if(!OnUserUpdate(fEtime))
+				m_bAtomActive = false;
+		}
 
-		// Handle Frame Update
-		if(!OnUserUpdate(fEtime))
-			m_bAtomActive = false;
+		// Hand the Screen Buffer over to be presented
+		SubmitFrame(fEtime, m_nPresentPolicy);
+		olcProfiler::EndFrame(nProfileFrame);
 
-		// Update Title & Present Screen Buffer
-		swprintf_s(s, 128, L"OneLoneCoder.com - Console Game Engine - %s - FPS: %3.2f ", m_sAppName.c_str(), 1.0f / fEtime);
-		SetConsoleTitleW(s);
-		WriteConsoleOutputW(m_hConsole, m_bufScreen, { (short)m_nScreenWidth, (short)m_nScreenHeight }, { 0,0 }, &m_rectWindow);
+		// Wait for the next frame, the input thread keeps collecting events
+		if(m_bAtomActive)
+		{
+			OLC_PROFILE_ZONE("Wait");
+			m_scheduler.WaitForNextFrame();
+		}
 	}
 
+	// Make sure the last frame is not one of the dropped ones
+	if(!m_vecFrames[m_nDrawFrame].vecRegions.empty())
+		SubmitFrame(fEtime, PRESENT_BLOCK);
+	StopPresenter();
+	StopInput();
+
+	// Take the lock so Start() cannot miss the notification
+	std::lock_guard<std::mutex> lck(m_muxGame);
 	m_cvGameFinished.notify_one();
 }
 //-----------------------------------------------------------------------------
 
-void olcConsoleGameEngine::handleKeyboardInput()
+bool olcConsoleGameEngine::BeginStepping()
 {
-	// Handle Keyboard Input
-	for (int i = 0; i < 256; i++)
+	//-- Frames are presented on the calling thread, so only the one being
+	//   drawn is kept from an earlier Start()
+	if(m_vecFrames.size() > 1)
 	{
-		m_keyNewState[i] = GetAsyncKeyState(i);
+		std::swap(m_vecFrames[0], m_vecFrames[size_t(m_nDrawFrame)]);
+		m_vecFrames.resize(1);
+		m_vecFrames[0].nState = FRAME_DRAWING;
+		m_nDrawFrame = 0;
+		m_bufScreen  = &m_vecFrames[0].buf;
+		m_queuePresent.clear();
+	}
+
+	m_bAtomActive = OnUserCreate();
+	return m_bAtomActive;
+}
+//-----------------------------------------------------------------------------
+
+bool olcConsoleGameEngine::Step(float fElapsedTime)
+{
+	if(!m_bAtomActive)
+		return false;
+
+	handleInput();
+	commitInput();
+	if(!OnUserUpdate(fElapsedTime))
+		m_bAtomActive = false;
+	SubmitFrame(fElapsedTime, PRESENT_BLOCK);
+	return m_bAtomActive;
+}
+//-----------------------------------------------------------------------------
 
-		m_keys[i].bPressed = false;
-		m_keys[i].bReleased = false;
+void olcConsoleGameEngine::StartInput()
+{
+	m_bInputQuit = false;
+	if(m_pBackend->HasInput())
+		m_threadInput = std::thread(&olcConsoleGameEngine::InputThread, this);
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::StopInput()
+{
+	if(!m_threadInput.joinable())
+		return;
+	m_bInputQuit = true;
+	m_threadInput.join();
+}
+//-----------------------------------------------------------------------------
 
-		if (m_keyNewState[i] != m_keyOldState[i])
+void olcConsoleGameEngine::InputThread()
+{
+	// Wait on the backend and forward whatever it reports. The timeout is
+	// only there to notice when the game is over.
+	olcProfiler::SetThreadName("Input");
+	olcInputEvent events[256];
+	while(!m_bInputQuit)
+	{
+		int n = m_pBackend->WaitInput(events, 256, 10);
+		for(int i = 0; i < n; ++i)
 		{
-			if (m_keyNewState[i] & 0x8000)
-			{
-				m_keys[i].bPressed = !m_keys[i].bHeld;
-				m_keys[i].bHeld = true;
-			}
-			else
+			//-- With the queue full, mouse moves are dropped (the next one
+			//   carries the position anyway), but presses and releases wait
+			//   for room: a lost release would leave a key held for good
+			if(events[i].nType == INPUT_MOUSE_MOVE)
 			{
-				m_keys[i].bReleased = true;
-				m_keys[i].bHeld = false;
+				m_queueInput.Push(events[i]);
+				continue;
 			}
+			while(!m_queueInput.Push(events[i]) && !m_bInputQuit)
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
 		}
-
-		m_keyOldState[i] = m_keyNewState[i];
 	}
 }
 //-----------------------------------------------------------------------------
 
-void olcConsoleGameEngine::handleMouseInput()
+bool olcConsoleGameEngine::InjectInput(const olcInputEvent &e)
 {
-	//// Handle Mouse Input - Check for window events
-	//INPUT_RECORD inBuf[32];
-	//DWORD events = 0;
-	//GetNumberOfConsoleInputEvents(m_hConsoleIn, &events);
-	//if (events > 0)
-	//	ReadConsoleInput(m_hConsoleIn, inBuf, events, &events);
-
-	//// Handle events - we only care about mouse clicks and movement
-	//// for now
-	//for (DWORD i = 0; i < events; i++)
-	//{
-	//	switch (inBuf[i].EventType)
-	//	{
-	//	case FOCUS_EVENT:
-	//	{
-	//		m_bConsoleInFocus = inBuf[i].Event.FocusEvent.bSetFocus;
-	//	}
-	//	break;
-
-	//	case MOUSE_EVENT:
-	//	{
-	//		switch (inBuf[i].Event.MouseEvent.dwEventFlags)
-	//		{
-	//		case MOUSE_MOVED:
-	//		{
-	//			m_mousePosX = inBuf[i].Event.MouseEvent.dwMousePosition.X;
-	//			m_mousePosY = inBuf[i].Event.MouseEvent.dwMousePosition.Y;
-	//		}
-	//		break;
-
-	//		case 0:
-	//		{
-	//			for (int m = 0; m < 5; m++)
-	//				m_mouseNewState[m] = (inBuf[i].Event.MouseEvent.dwButtonState & (1 << m)) > 0;
+	if(m_threadInput.joinable())
+		return false;
+	return m_queueInput.Push(e);
+}
+//-----------------------------------------------------------------------------
 
-	//		}
-	//		break;
+// The virtual keys of the mouse buttons (VK_LBUTTON, VK_RBUTTON, VK_MBUTTON,
+// VK_XBUTTON1, VK_XBUTTON2), which m_keys[] has always reported them under
+static const int s_mouseButtonKeys[5] = { 0x01, 0x02, 0x04, 0x05, 0x06 };
+//-----------------------------------------------------------------------------
 
-	//		default:
-	//			break;
-	//		}
-	//	}
-	//	break;
+void olcConsoleGameEngine::handleInput()
+{
+	// Handle Keyboard and Mouse Input. Changes are latched until the next
+	// update consumes them, so a press and release inside one frame both count
+	olcInputEvent e;
+	while(m_queueInput.Pop(e))
+	{
+		switch(e.nType)
+		{
+		case INPUT_KEY_DOWN:
+		case INPUT_KEY_UP:
+			if(e.nKey < 0 || e.nKey > 255)
+				continue;
+			latchButton(m_keyLatch[e.nKey], e.nType == INPUT_KEY_DOWN);
+			break;
+
+		case INPUT_MOUSE_DOWN:
+		case INPUT_MOUSE_UP:
+			if(e.nKey < 0 || e.nKey > 4)
+				continue;
+			latchButton(m_mouseLatch[e.nKey], e.nType == INPUT_MOUSE_DOWN);
+			latchButton(m_keyLatch[s_mouseButtonKeys[e.nKey]], e.nType == INPUT_MOUSE_DOWN);
+			m_nMouseLatchX = e.x;
+			m_nMouseLatchY = e.y;
+			break;
+
+		case INPUT_MOUSE_MOVE:
+			m_nMouseLatchX = e.x;
+			m_nMouseLatchY = e.y;
+			break;
+		}
+		m_vecInputPending.push_back(e);
+	}
+}
+//-----------------------------------------------------------------------------
 
-	//	default:
-	//		break;
-	//		// We don't care just at the moment
-	//	}
-	//}
+void olcConsoleGameEngine::latchButton(sKeyState &latch, bool bDown)
+{
+	if (bDown)
+	{
+		latch.bPressed |= !latch.bHeld;
+		latch.bHeld = true;
+	}
+	else
+	{
+		latch.bReleased = true;
+		latch.bHeld = false;
+	}
+}
+//-----------------------------------------------------------------------------
 
-	//for (int m = 0; m < 5; m++)
-	//{
-	//	m_mouse[m].bPressed = false;
-	//	m_mouse[m].bReleased = false;
+void olcConsoleGameEngine::commitInput()
+{
+	for (int i = 0; i < 256; i++)
+	{
+		m_keys[i] = m_keyLatch[i];
+		m_keyLatch[i].bPressed = false;
+		m_keyLatch[i].bReleased = false;
+	}
 
-	//	if (m_mouseNewState[m] != m_mouseOldState[m])
-	//	{
-	//		if (m_mouseNewState[m])
-	//		{
-	//			m_mouse[m].bPressed = true;
-	//			m_mouse[m].bHeld = true;
-	//		}
-	//		else
-	//		{
-	//			m_mouse[m].bReleased = true;
-	//			m_mouse[m].bHeld = false;
-	//		}
-	//	}
+	for (int m = 0; m < 5; m++)
+	{
+		m_mouse[m] = m_mouseLatch[m];
+		m_mouseLatch[m].bPressed = false;
+		m_mouseLatch[m].bReleased = false;
+	}
+	m_mousePosX = m_nMouseLatchX;
+	m_mousePosY = m_nMouseLatchY;
 
-	//	m_mouseOldState[m] = m_mouseNewState[m];
-	//}
+	m_vecInputEvents.swap(m_vecInputPending);
+	m_vecInputPending.clear();
 }
 //-----------------------------------------------------------------------------
 
-int olcConsoleGameEngine::Error(wchar_t *msg)
+int olcConsoleGameEngine::Error(const wchar_t *msg)
 {
-	wchar_t buf[256];
-	FormatMessageW(FORMAT_MESSAGE_FROM_SYSTEM, NULL, GetLastError(), MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT), buf, 256, NULL);
-	wprintf(L"[ERROR] %ls: %ls\n", msg, buf);
+	return olcReportError(msg);
+}
+//-----------------------------------------------------------------------------
 
-	std::wstring txt(msg);
-	txt += std::wstring(L":\n") + std::wstring(buf);
-	MessageBoxW(NULL, txt.c_str(), L"OLC Console Game Engine Error", MB_OK | MB_ICONERROR);
-	return -1;
+void olcConsoleGameEngine::SetRenderBackend(std::unique_ptr<olcRenderBackend> pBackend)
+{
+	if(pBackend)
+		m_pBackend = std::move(pBackend);
 }
 //-----------------------------------------------------------------------------
 
 int olcConsoleGameEngine::ConstructConsole(int width, int height, int fontw, int fonth)
 {
-	if(INVALID_HANDLE_VALUE == m_hConsole)
-		return Error(L"CreateConsoleScreenBuffer");
+	//-- The backend sets up the output device and may shrink the requested
+	//   size to what the device supports
+	if(m_pBackend->Construct(width, height, fontw, fonth) < 0)
+		return -1;
 
 	m_nScreenWidth  = width;
 	m_nScreenHeight = height;
 
-	//-- This is what I have found so far:
-	//   - Windows establishes lower and upper limits to the size of the screen buffer.
-	//     The low limit depend on the current font size of the console and the current size of
-	//     the console screen.
-	//     Trying to set the buffer size below the actual console window size results
-	//     in an error.
-	//   - The maximum size for the buffer depends on the font size. The maximum buffer size
-	//     can be obtained by a call to GetConsoleScreenBufferInfo().
-	//
-	//     This is how we proceed to manage to get the console buffer and window size:
-	//
-	//   1. Set Console Window to the lowest possible size hence reducing the
-	//      low limit to its bare minimum
-	//   2. Set the ScreenBuffer size to the desired console size
-	//   3. Set the buffer to the console.
-	//   4. Set, now that the buffer has been assigned to the console, the font
-	//      size to the desired value. Mind though, the "Consolas" font has a
-	//      fixed pitch for the size, the width being half the height.
-	//   5. Get the ScreenBuffer info to check the maximum size allowed for the
-	//      console window. Adjust desired buffer size to allowed if necessary
-	//   6. Set the Window Size to the screen buffer size
-
-	//-- 1. Change console visual size to a minimum so ScreenBuffer can shrink
-	//   below the actual visual size
-	m_rectWindow = { 0, 0, 1, 1 };
-	SetConsoleWindowInfo(m_hConsole, TRUE, &m_rectWindow);
-
-	//-- 2. Set now the size of the screen buffer (there are minimum system sizes that
-	//   can be obtained by calling GetSystemMetrics() with params SM_CXMIN y SM_CXMAX
-	COORD coord;//({ m_nScreenWidth, m_nScreenHeight });
-	coord.X = m_nScreenWidth;
-	coord.Y = m_nScreenHeight;
-	if(!SetConsoleScreenBufferSize(m_hConsole, coord))
-		Error(L"SetConsoleScreenBufferSize");
-
-	//-- 3. Set the buffer to the console
-	if(!SetConsoleActiveScreenBuffer(m_hConsole))
-		return Error(L"SetConsoleActiveScreenBuffer");
-	m_bufScreen = new CHAR_INFO[m_nScreenWidth*m_nScreenHeight];
-	memset(m_bufScreen, 0, sizeof(CHAR_INFO) * m_nScreenWidth * m_nScreenHeight);
-
-	//-- 4. Set the font size now that the buffer has been assigned to the
-	//      actual console
-	CONSOLE_FONT_INFOEX cfi;
-	cfi.cbSize       = sizeof(cfi);
-	if(!GetCurrentConsoleFontEx(m_hConsole, false, &cfi))
-		return Error(L"GetCurrentConsoleFontEx");
-	cfi.nFont        = 0;
-	cfi.dwFontSize.X = fonth / 2;//fontw;
-	cfi.dwFontSize.Y = fonth;
-	cfi.FontFamily   = FF_DONTCARE;
-	cfi.FontWeight   = FW_NORMAL;
-	wcscpy_s(cfi.FaceName, L"Consolas");
-	if(!SetCurrentConsoleFontEx(m_hConsole, false, &cfi))
-		return Error(L"SetCurrentConsoleFontEx");
-
-	//-- 5. Get Screen Buffer Info and check the maximum allowed window size
-	CONSOLE_SCREEN_BUFFER_INFO csbi;
-	if(!GetConsoleScreenBufferInfo(m_hConsole, &csbi))
-		return Error(L"GetConsoleScreenBufferInfo");
-	//-- Re-scale the buffer and window if we've exceeded the high-end limit
-	if(m_nScreenHeight > csbi.dwMaximumWindowSize.Y ||
-	   m_nScreenWidth  > csbi.dwMaximumWindowSize.X)
-	{
-		m_nScreenHeight = m_nScreenHeight > csbi.dwMaximumWindowSize.Y
-						? csbi.dwMaximumWindowSize.Y : m_nScreenHeight;
-		m_nScreenWidth = m_nScreenWidth > csbi.dwMaximumWindowSize.X
-						? csbi.dwMaximumWindowSize.X : m_nScreenWidth;
-		coord.X = m_nScreenWidth;
-		coord.Y = m_nScreenHeight;
-		if(!SetConsoleScreenBufferSize(m_hConsole, coord))
-			Error(L"SetConsoleScreenBufferSize");
-	}
-
-	//-- 6. Set Console Window Size
-	m_rectWindow = { 0, 0, SHORT(m_nScreenWidth - 1), SHORT(m_nScreenHeight - 1) };
-	if(!SetConsoleWindowInfo(m_hConsole, TRUE, &m_rectWindow))
-		return Error(L"SetConsoleWindowInfo");
+	//-- Only the buffer drawn into is created here, the presenter's ones are
+	//   added when the game starts
+	m_vecFrames.clear();
+	m_vecFrames.resize(1);
+	m_vecFrames[0].buf.Resize(m_nScreenWidth, m_nScreenHeight);
+	m_vecFrames[0].nState = FRAME_DRAWING;
+	m_nDrawFrame = 0;
+	m_bufScreen  = &m_vecFrames[0].buf;
+
+	//-- The first frame presents everything
+	m_vecDirtyRows.assign(size_t(m_nScreenHeight), sDirtySpan{ 0, m_nScreenWidth });
+	m_drawCommands.Resize(m_nScreenWidth, m_nScreenHeight);
+	m_vecLayers.clear();
+	m_pDrawLayer = nullptr;
+	SetPixelMode(m_bPixelMode);
 
 	return 1;
 }
 //-----------------------------------------------------------------------------
 
-void olcConsoleGameEngine::Draw(int x, int y, wchar_t c, short col)
+void olcConsoleGameEngine::MarkDirty(int x1, int y1, int x2, int y2)
+{
+	Clip(x1, y1);
+	Clip(x2, y2);
+	if(x1 >= x2)
+		return;
+	for(int y = y1; y < y2; ++y)
+		MarkDirtySpan(y, x1, x2);
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::CollectDirtyRegions(std::vector<sCellRect> &vecRegions)
 {
-	if (x >= 0 && x < m_nScreenWidth && y >= 0 && y < m_nScreenHeight)
+	if(!m_bDirtyTracking)
+	{
+		vecRegions.push_back({ 0, 0, short(m_nScreenWidth - 1), short(m_nScreenHeight - 1) });
+		for(sDirtySpan &span : m_vecDirtyRows)
+			span = { m_nScreenWidth, 0 };
+		return;
+	}
+
+	//-- Stack the row spans into rectangles. A row joins the rectangle above
+	//   it as long as that does not present many more cells than the spans
+	//   themselves cover; otherwise it starts a new rectangle.
+	static const int nSlack = 32;
+	sCellRect  rect    = { 0, 0, -1, -1 };
+	int        nCells  = 0;
+	bool       bOpen   = false;
+
+	for(int y = 0; y < m_nScreenHeight; ++y)
 	{
-		m_bufScreen[y * m_nScreenWidth + x].Char.UnicodeChar = c;
-		m_bufScreen[y * m_nScreenWidth + x].Attributes = col;
+		sDirtySpan &span = m_vecDirtyRows[y];
+		if(span.nMin >= span.nMax)
+		{
+			if(bOpen)
+				vecRegions.push_back(rect);
+			bOpen = false;
+			continue;
+		}
+
+		if(bOpen)
+		{
+			int l = span.nMin < rect.Left ? span.nMin : rect.Left;
+			int r = span.nMax - 1 > rect.Right ? span.nMax - 1 : rect.Right;
+			int nArea = (r - l + 1) * (y - rect.Top + 1);
+			if(nArea <= nCells + (span.nMax - span.nMin) + nSlack)
+			{
+				rect.Left   = short(l);
+				rect.Right  = short(r);
+				rect.Bottom = short(y);
+				nCells     += span.nMax - span.nMin;
+				span        = { m_nScreenWidth, 0 };
+				continue;
+			}
+			vecRegions.push_back(rect);
+		}
+
+		rect   = { short(span.nMin), short(y), short(span.nMax - 1), short(y) };
+		nCells = span.nMax - span.nMin;
+		bOpen  = true;
+		span   = { m_nScreenWidth, 0 };
 	}
+	if(bOpen)
+		vecRegions.push_back(rect);
 }
 //-----------------------------------------------------------------------------
 
-void olcConsoleGameEngine::Fill(int x1, int y1, int x2, int y2, wchar_t c, short col)
+void olcConsoleGameEngine::SetPresentMode(int nBuffers, PRESENT_POLICY policy)
 {
-	Clip(x1, y1);
-	Clip(x2, y2);
-	for(int x = x1; x < x2; ++x)
-		for(int y = y1; y < y2; ++y)
-			Draw(x, y, c, col);
+	m_nPresentBuffers = nBuffers < 1 ? 1 : nBuffers;
+	m_nPresentPolicy  = policy;
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::SetTargetFPS(float fFps)
+{
+	m_fTargetFrameTime = fFps > 0.0f ? 1.0f / fFps : 0.0f;
+	UpdateFramePacing();
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::SetFixedTimestep(float fStep)
+{
+	m_scheduler.SetFixedStep(fStep);
+	UpdateFramePacing();
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::UpdateFramePacing()
+{
+	m_scheduler.SetTargetFrameTime(m_fTargetFrameTime > 0.0f ? m_fTargetFrameTime : m_scheduler.FixedStep());
 }
 //-----------------------------------------------------------------------------
 
-void olcConsoleGameEngine::DrawString(int x, int y, std::wstring c, short col)
+void olcConsoleGameEngine::StartPresenter()
 {
-	for(size_t i = 0; i < c.size(); ++i)
+	while(int(m_vecFrames.size()) < m_nPresentBuffers)
 	{
-		m_bufScreen[y * m_nScreenWidth + x + i].Char.UnicodeChar = c[i];
-		m_bufScreen[y * m_nScreenWidth + x + i].Attributes       = col;
+		m_vecFrames.emplace_back();
+		m_vecFrames.back().buf.Resize(m_nScreenWidth, m_nScreenHeight);
+		m_vecFrames.back().vecStale.assign(1, { 0, 0, short(m_nScreenWidth - 1), short(m_nScreenHeight - 1) });
+		m_vecFrames.back().nState = FRAME_FREE;
 	}
+	//-- Growing the ring may have moved the frame being drawn
+	m_bufScreen = &m_vecFrames[m_nDrawFrame].buf;
+
+	m_nFramesDropped = 0;
+	m_bPresenterQuit = false;
+	if(m_vecFrames.size() > 1)
+		m_threadPresenter = std::thread(&olcConsoleGameEngine::PresenterThread, this);
 }
 //-----------------------------------------------------------------------------
 
-void olcConsoleGameEngine::DrawStringAlpha(int x, int y, std::wstring c, short col)
+void olcConsoleGameEngine::StopPresenter()
 {
-	for(size_t i = 0; i < c.size(); ++i)
+	if(!m_threadPresenter.joinable())
+		return;
+
+	//-- The presenter drains the queue before leaving
 	{
-		if(c[i] != L' ')
-		{
-			m_bufScreen[y * m_nScreenWidth + x + i].Char.UnicodeChar = c[i];
-			m_bufScreen[y * m_nScreenWidth + x + i].Attributes = col;
-		}
+		std::lock_guard<std::mutex> lck(m_muxPresent);
+		m_bPresenterQuit = true;
 	}
+	m_cvFrameQueued.notify_one();
+	m_threadPresenter.join();
 }
 //-----------------------------------------------------------------------------
 
-void olcConsoleGameEngine::Clip(int &x, int &y)
+void olcConsoleGameEngine::PresenterThread()
 {
-	if(x < 0) x = 0;
-	else if(x >= m_nScreenWidth) x = m_nScreenWidth;
-	if(y < 0) y = 0;
-	else if(y >= m_nScreenHeight) y = m_nScreenHeight;
+	olcProfiler::SetThreadName("Presenter");
+	std::unique_lock<std::mutex> lck(m_muxPresent);
+	while(true)
+	{
+		m_cvFrameQueued.wait(lck, [this] { return m_bPresenterQuit || !m_queuePresent.empty(); });
+		if(m_queuePresent.empty())
+			break;
+
+		sFrame &frame = m_vecFrames[m_queuePresent.front()];
+		m_queuePresent.pop_front();
+		frame.nState = FRAME_PRESENTING;
+
+		lck.unlock();
+		PresentFrame(frame);
+		lck.lock();
+
+		frame.vecRegions.clear();
+		frame.nState = FRAME_FREE;
+		m_cvFrameFree.notify_one();
+	}
 }
 //-----------------------------------------------------------------------------
 
-void olcConsoleGameEngine::DrawLine(int x1, int y1, int x2, int y2, wchar_t c, short col)
+void olcConsoleGameEngine::PresentFrame(sFrame &frame)
 {
-	int x, y, dx, dy, dx1, dy1, px, py, xe, ye, i;
-	dx  = x2 - x1;
-	dy  = y2 - y1;
-	dx1 = abs(dx);
-	dy1 = abs(dy);
-	px  = 2 * dy1 - dx1;
-	py  = 2 * dx1 - dy1;
-	if(dy1 <= dx1)
+	// Update Title & Present Screen Buffer
 	{
-		if(dx >= 0)
-		{
-			x  = x1;
-			y  = y1;
-			xe = x2;
-		}
+		OLC_PROFILE_ZONE("Title");
+		wchar_t s[128];
+		if(frame.fJitter > 0.0f)
+			swprintf(s, 128, L"OneLoneCoder.com - Console Game Engine - %ls - FPS: %3.2f - Jitter: %.2fms ", m_sAppName.c_str(), 1.0f / frame.fElapsedTime, frame.fJitter * 1000.0f);
 		else
-		{
-			x  = x2;
-			y  = y2;
-			xe = x1;
-		}
-		Draw(x, y, c, col);
-
-		for(i = 0; x < xe; ++i)
-		{
-			x = x + 1;
-			if(px < 0)
-				px = px + 2 * dy1;
-			else
-			{
-				if((dx < 0 && dy < 0) || (dx > 0 && dy > 0))
-					y = y + 1;
-				else
-					y = y - 1;
-				px = px + 2 * (dy1 - dx1);
-			}
-			Draw(x, y, c, col);
-		}
+			swprintf(s, 128, L"OneLoneCoder.com - Console Game Engine - %ls - FPS: %3.2f ", m_sAppName.c_str(), 1.0f / frame.fElapsedTime);
+		m_pBackend->SetTitle(s);
 	}
-	else
 	{
-		if(dy >= 0)
-		{
-			x = x1;
-			y = y1;
-			ye = y2;
-		}
-		else
-		{
-			x = x2;
-			y = y2;
-			ye = y1;
-		}
-		Draw(x, y, c, col);
+		OLC_PROFILE_ZONE("Present");
+		m_pBackend->Present(frame.buf, frame.vecRegions.data(), int(frame.vecRegions.size()));
+	}
 
-		for(i = 0; y < ye; ++i)
-		{
-			y = y + 1;
-			if(py <= 0)
-				py = py + 2 * dx1;
-			else
-			{
-				if((dx < 0 && dy < 0) || (dx > 0 && dy > 0))
-					x = x + 1;
-				else
-					x = x - 1;
-				py = py + 2 * (dx1 - dy1);
-			}
-			Draw(x, y, c, col);
-		}
+	std::lock_guard<std::mutex> lck(m_muxRecorder);
+	if(m_pRecorder)
+		m_pRecorder->Capture(frame.buf);
+}
+//-----------------------------------------------------------------------------
+
+bool olcConsoleGameEngine::StartRecording(const std::wstring &sFile)
+{
+	if(m_bufScreen == nullptr)
+		return false;
+
+	std::unique_ptr<olcFrameRecorder> pRecorder(new olcFrameRecorder());
+	if(!pRecorder->Open(sFile, m_nScreenWidth, m_nScreenHeight, m_nPresentPolicy))
+		return false;
+
+	std::lock_guard<std::mutex> lck(m_muxRecorder);
+	m_pRecorder = std::move(pRecorder);
+	return true;
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::StopRecording()
+{
+	std::unique_ptr<olcFrameRecorder> pRecorder;
+	{
+		std::lock_guard<std::mutex> lck(m_muxRecorder);
+		pRecorder = std::move(m_pRecorder);
 	}
+	//-- Closing waits for the writer, so do it outside the lock
+	if(pRecorder)
+		pRecorder->Close();
 }
 //-----------------------------------------------------------------------------
 
-void olcConsoleGameEngine::DrawSprite(int x, int y, olcSprite *sprite)
+uint64_t olcConsoleGameEngine::RecordingFramesDropped()
 {
-	if (sprite == nullptr)
+	std::lock_guard<std::mutex> lck(m_muxRecorder);
+	return m_pRecorder ? m_pRecorder->FramesDropped() : 0;
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::SubmitFrame(float fElapsedTime, PRESENT_POLICY policy)
+{
+	OLC_PROFILE_ZONE("SubmitFrame");
+	FlushDrawCommands();
+	PackPixels();
+	CompositeLayers();
+
+	sFrame &frame = m_vecFrames[m_nDrawFrame];
+	CollectDirtyRegions(frame.vecRegions);
+	frame.fElapsedTime = fElapsedTime;
+	frame.fJitter      = m_scheduler.Jitter();
+
+	if(m_vecFrames.size() == 1)
+	{
+		PresentFrame(frame);
+		frame.vecRegions.clear();
+		return;
+	}
+
+	auto findFree = [this]()
+	{
+		for(size_t i = 0; i < m_vecFrames.size(); ++i)
+			if(m_vecFrames[i].nState == FRAME_FREE)
+				return int(i);
+		return -1;
+	};
+
+	std::unique_lock<std::mutex> lck(m_muxPresent);
+	int nNext = findFree();
+
+	if(nNext < 0 && policy == PRESENT_DROP_OLDEST && !m_queuePresent.empty())
+	{
+		//-- Reuse the oldest queued frame. This one holds the newer contents,
+		//   so it just takes over the regions that would have been presented
+		nNext = m_queuePresent.front();
+		m_queuePresent.pop_front();
+		std::vector<sCellRect> &vecOld = m_vecFrames[nNext].vecRegions;
+		frame.vecRegions.insert(frame.vecRegions.end(), vecOld.begin(), vecOld.end());
+		vecOld.clear();
+		++m_nFramesDropped;
+	}
+
+	if(nNext < 0 && policy != PRESENT_BLOCK)
+	{
+		//-- Nothing to swap with: keep drawing into the same buffer and carry
+		//   its regions over to the next frame
+		if(frame.vecRegions.size() > size_t(m_nScreenHeight))
+			frame.vecRegions.assign(1, { 0, 0, short(m_nScreenWidth - 1), short(m_nScreenHeight - 1) });
+		++m_nFramesDropped;
 		return;
+	}
+
+	while(nNext < 0)
+	{
+		m_cvFrameFree.wait(lck);
+		nNext = findFree();
+	}
+
+	//-- Every other buffer is now behind on what this frame changed. Done
+	//   before queueing it, as the presenter clears the regions once shown
+	for(size_t i = 0; i < m_vecFrames.size(); ++i)
+	{
+		if(int(i) == m_nDrawFrame)
+			continue;
+		std::vector<sCellRect> &vecStale = m_vecFrames[i].vecStale;
+		if(vecStale.size() + frame.vecRegions.size() > size_t(m_nScreenHeight))
+			vecStale.assign(1, { 0, 0, short(m_nScreenWidth - 1), short(m_nScreenHeight - 1) });
+		else
+			vecStale.insert(vecStale.end(), frame.vecRegions.begin(), frame.vecRegions.end());
+	}
+
+	frame.nState = FRAME_QUEUED;
+	m_queuePresent.push_back(m_nDrawFrame);
+	m_vecFrames[nNext].nState = FRAME_DRAWING;
+	lck.unlock();
+	m_cvFrameQueued.notify_one();
 
-	for(int i = 0; i < sprite->nWidth; ++i)
+	//-- The next frame carries on from the contents of the one just finished,
+	//   which only needs the cells it has fallen behind on
+	sFrame &next = m_vecFrames[nNext];
+	for(const sCellRect &r : next.vecStale)
 	{
-		for(int j = 0; j < sprite->nHeight; ++j)
+		for(int y = r.Top; y <= r.Bottom; ++y)
 		{
-			if(sprite->GetGlyph(i, j) != L' ')
-				Draw(x + i, y + j, sprite->GetGlyph(i, j), sprite->GetColour(i, j));
+			size_t i = size_t(y) * size_t(m_nScreenWidth) + size_t(r.Left);
+			size_t n = size_t(r.Right - r.Left + 1);
+			memcpy(next.buf.Glyphs() + i, frame.buf.Glyphs() + i, sizeof(wchar_t) * n);
+			memcpy(next.buf.Attributes() + i, frame.buf.Attributes() + i, n);
 		}
 	}
+	next.vecStale.clear();
+	m_nDrawFrame = nNext;
+	m_bufScreen  = &next.buf;
 }
 //-----------------------------------------------------------------------------
 
-void olcConsoleGameEngine::DrawPartialSprite(int x, int y, olcSprite *sprite, int ox, int oy, int w, int h)
+//-- Layers. Each one is a screen sized cell buffer; the rows of a layer
+//   remember what was drawn since the last composite (vecDirty) and what
+//   may hold anything but L' ' (vecInk), so clearing and compositing only
+//   touch cells that can have changed.
+
+olcConsoleGameEngine::sLayer* olcConsoleGameEngine::FindLayer(const std::wstring &sName)
 {
-	if(sprite == nullptr)
+	for(std::unique_ptr<sLayer> &pLayer : m_vecLayers)
+		if(pLayer->sName == sName)
+			return pLayer.get();
+	return nullptr;
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::SortLayers()
+{
+	std::stable_sort(m_vecLayers.begin(), m_vecLayers.end(),
+		[](const std::unique_ptr<sLayer> &a, const std::unique_ptr<sLayer> &b) { return a->nZ < b->nZ; });
+	m_bLayersChanged = true;
+}
+//-----------------------------------------------------------------------------
+
+bool olcConsoleGameEngine::CreateLayer(const std::wstring &sName, int nZ)
+{
+	if(m_bufScreen == nullptr || sName.empty() || FindLayer(sName) != nullptr)
+		return false;
+
+	std::unique_ptr<sLayer> pLayer(new sLayer());
+	pLayer->sName    = sName;
+	pLayer->nZ       = nZ;
+	pLayer->bVisible = true;
+	pLayer->bDirty   = false;
+	pLayer->cells.Resize(m_nScreenWidth, m_nScreenHeight);
+	olcFillCells(pLayer->cells.Glyphs(), pLayer->cells.Attributes(), pLayer->cells.Size(), L' ', 0);
+	pLayer->vecDirty.assign(size_t(m_nScreenHeight), sDirtySpan{ m_nScreenWidth, 0 });
+	pLayer->vecInk.assign(size_t(m_nScreenHeight), sDirtySpan{ m_nScreenWidth, 0 });
+	m_vecLayers.push_back(std::move(pLayer));
+	SortLayers();
+	return true;
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::DeleteLayer(const std::wstring &sName)
+{
+	sLayer *pLayer = FindLayer(sName);
+	if(pLayer == nullptr)
 		return;
+	if(pLayer == m_pDrawLayer)
+		SetDrawLayer(L"");
+	m_vecLayers.erase(std::find_if(m_vecLayers.begin(), m_vecLayers.end(),
+		[pLayer](const std::unique_ptr<sLayer> &p) { return p.get() == pLayer; }));
+	m_bLayersChanged = true;
+}
+//-----------------------------------------------------------------------------
 
-	for(int i = 0; i < w; ++i)
+bool olcConsoleGameEngine::SetDrawLayer(const std::wstring &sName)
+{
+	sLayer *pLayer = nullptr;
+	if(!sName.empty() && (pLayer = FindLayer(sName)) == nullptr)
+		return false;
+
+	//-- Recorded commands go to the target they were recorded for
+	FlushDrawCommands();
+	m_pDrawLayer = pLayer;
+	return true;
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::SetLayerZ(const std::wstring &sName, int nZ)
+{
+	sLayer *pLayer = FindLayer(sName);
+	if(pLayer != nullptr && pLayer->nZ != nZ)
 	{
-		for(int j = 0; j < h; ++j)
-		{
-			if(sprite->GetGlyph(i+ox, j+oy) != L' ')
-				Draw(x + i, y + j, sprite->GetGlyph(i+ox, j+oy), sprite->GetColour(i+ox, j+oy));
+		pLayer->nZ = nZ;
+		SortLayers();
+	}
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::SetLayerVisible(const std::wstring &sName, bool bVisible)
+{
+	sLayer *pLayer = FindLayer(sName);
+	if(pLayer != nullptr && pLayer->bVisible != bVisible)
+	{
+		pLayer->bVisible = bVisible;
+		m_bLayersChanged = true;
+	}
+}
+//-----------------------------------------------------------------------------
+
+bool olcConsoleGameEngine::IsLayerDirty(const std::wstring &sName)
+{
+	sLayer *pLayer = FindLayer(sName);
+	if(pLayer == nullptr)
+		return false;
+	if(pLayer == m_pDrawLayer)
+		FlushDrawCommands();
+	return pLayer->bDirty;
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::ClearLayerInk(sLayer &layer)
+{
+	for(int y = 0; y < m_nScreenHeight; ++y)
+	{
+		sDirtySpan &ink = layer.vecInk[y];
+		sDirtySpan &dirty = layer.vecDirty[y];
+		int x1 = std::min(ink.nMin, dirty.nMin);
+		int x2 = std::max(ink.nMax, dirty.nMax);
+		if(x1 >= x2)
+			continue;
+		size_t nAt = size_t(y * m_nScreenWidth + x1);
+		olcFillCells(layer.cells.Glyphs() + nAt, layer.cells.Attributes() + nAt, size_t(x2 - x1), L' ', 0);
+		dirty = { x1, x2 };
+		ink   = { m_nScreenWidth, 0 };
+		layer.bDirty = true;
+	}
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::CompositeLayers()
+{
+	if(m_vecLayers.empty())
+		return;
+	OLC_PROFILE_ZONE("CompositeLayers");
+
+	//-- A row is recomposited over the union of what changed in it on any
+	//   layer, everything when the stack itself changed
+	for(int y = 0; y < m_nScreenHeight; ++y)
+	{
+		int x1 = m_bLayersChanged ? 0 : m_nScreenWidth;
+		int x2 = m_bLayersChanged ? m_nScreenWidth : 0;
+		for(std::unique_ptr<sLayer> &pLayer : m_vecLayers)
+		{
+			if(!pLayer->bDirty)
+				continue;
+			const sDirtySpan &dirty = pLayer->vecDirty[y];
+			x1 = std::min(x1, dirty.nMin);
+			x2 = std::max(x2, dirty.nMax);
+		}
+		if(m_bPixelMode)
+		{
+			x1 = std::min(x1, m_vecPixelDirty[y].nMin);
+			x2 = std::max(x2, m_vecPixelDirty[y].nMax);
+			m_vecPixelDirty[y] = { m_nScreenWidth, 0 };
+		}
+		if(x1 >= x2)
+			continue;
+
+		//-- Over the pixels, or nothing, top down, the first cell that is not
+		//   L' ' wins
+		size_t   nRow   = size_t(y * m_nScreenWidth);
+		wchar_t *glyphs = m_bufScreen->Glyphs() + nRow;
+		uint8_t *attrs  = m_bufScreen->Attributes() + nRow;
+		if(m_bPixelMode)
+		{
+			const uint8_t *pTop = m_vecPixels.data() + 2 * nRow;
+			olcPackHalfBlocks(pTop + x1, pTop + m_nScreenWidth + x1, size_t(x2 - x1), glyphs + x1, attrs + x1);
+		}
+		else
+			olcFillCells(glyphs + x1, attrs + x1, size_t(x2 - x1), L' ', 0);
+		for(int x = x1; x < x2; ++x)
+		{
+			for(auto it = m_vecLayers.rbegin(); it != m_vecLayers.rend(); ++it)
+			{
+				wchar_t c = (*it)->cells.Glyphs()[nRow + x];
+				if((*it)->bVisible && c != L' ')
+				{
+					glyphs[x] = c;
+					attrs[x]  = (*it)->cells.Attributes()[nRow + x];
+					break;
+				}
+			}
+		}
+		MarkDirtySpan(y, x1, x2);
+	}
+
+	//-- What was drawn is now part of the ink a Clear() has to wipe
+	for(std::unique_ptr<sLayer> &pLayer : m_vecLayers)
+	{
+		if(!pLayer->bDirty)
+			continue;
+		for(int y = 0; y < m_nScreenHeight; ++y)
+		{
+			sDirtySpan &dirty = pLayer->vecDirty[y];
+			sDirtySpan &ink   = pLayer->vecInk[y];
+			ink.nMin = std::min(ink.nMin, dirty.nMin);
+			ink.nMax = std::max(ink.nMax, dirty.nMax);
+			dirty    = { m_nScreenWidth, 0 };
+		}
+		pLayer->bDirty = false;
+	}
+	m_bLayersChanged = false;
+	m_bPixelsDirty   = false;
+}
+//-----------------------------------------------------------------------------
+
+//-- Pixel mode. Pixel row y lives in m_vecPixels at y * m_nScreenWidth; the
+//   dirty span of a screen row covers what changed in either of its pixel
+//   rows since they were last packed.
+
+void olcConsoleGameEngine::SetPixelMode(bool bEnable)
+{
+	m_bPixelMode   = bEnable;
+	m_bPixelsDirty = false;
+	if(bEnable)
+	{
+		m_vecPixels.assign(size_t(m_nScreenWidth) * size_t(m_nScreenHeight) * 2, 0);
+		m_vecPixelDirty.assign(size_t(m_nScreenHeight), sDirtySpan{ m_nScreenWidth, 0 });
+	}
+	else
+	{
+		m_vecPixels     = std::vector<uint8_t>();
+		m_vecPixelDirty = std::vector<sDirtySpan>();
+	}
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::PixelSpans(const std::vector<sSpan> &vecSpans, short col)
+{
+	for(const sSpan &span : vecSpans)
+	{
+		memset(m_vecPixels.data() + size_t(span.y * m_nScreenWidth + span.x1), col & 0x0F, size_t(span.x2 - span.x1));
+		MarkPixels(span.y, span.x1, span.x2);
+	}
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::PackPixels()
+{
+	//-- With layers the pixels are packed as the bottom of the composite
+	if(!m_bPixelsDirty || !m_vecLayers.empty())
+		return;
+	OLC_PROFILE_ZONE("PackPixels");
+
+	for(int y = 0; y < m_nScreenHeight; ++y)
+	{
+		sDirtySpan &span = m_vecPixelDirty[y];
+		if(span.nMin >= span.nMax)
+			continue;
+		size_t         nAt  = size_t(y * m_nScreenWidth + span.nMin);
+		const uint8_t *pTop = m_vecPixels.data() + size_t(2 * y * m_nScreenWidth + span.nMin);
+		olcPackHalfBlocks(pTop, pTop + m_nScreenWidth, size_t(span.nMax - span.nMin),
+		                  m_bufScreen->Glyphs() + nAt, m_bufScreen->Attributes() + nAt);
+		MarkDirtySpan(y, span.nMin, span.nMax);
+		span = { m_nScreenWidth, 0 };
+	}
+	m_bPixelsDirty = false;
+}
+//-----------------------------------------------------------------------------
+
+//-- Drawing. Every primitive is a Raster* routine that writes the cells it
+//   covers inside a target rectangle: the whole screen (or layer) when
+//   drawing right away, one tile when executing recorded commands. In
+//   deferred mode the public calls only record a command (see
+//   olcDrawCommands.h).
+
+olcConsoleGameEngine::sRasterTarget olcConsoleGameEngine::DrawTarget()
+{
+	if(m_pDrawLayer != nullptr)
+	{
+		m_pDrawLayer->bDirty = true;
+		olcCellBuffer &cells = m_pDrawLayer->cells;
+		return { 0, 0, m_nScreenWidth, m_nScreenHeight, cells.Glyphs(), cells.Attributes(), m_pDrawLayer->vecDirty.data() };
+	}
+
+	//-- Cells go on top of the pixels drawn so far
+	PackPixels();
+	return { 0, 0, m_nScreenWidth, m_nScreenHeight, m_bufScreen->Glyphs(), m_bufScreen->Attributes(), m_vecDirtyRows.data() };
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::Record(sDrawCommand &cmd, int x1, int y1, int x2, int y2)
+{
+	Clip(x1, y1);
+	Clip(x2, y2);
+	if(x1 >= x2 || y1 >= y2)
+		return;
+	cmd.bx1 = int16_t(x1);
+	cmd.by1 = int16_t(y1);
+	cmd.bx2 = int16_t(x2);
+	cmd.by2 = int16_t(y2);
+	m_drawCommands.Add(cmd);
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::SetDeferredDrawing(bool bEnable, int nWorkers)
+{
+	FlushDrawCommands();
+	m_bDeferredDrawing = bEnable;
+	if(bEnable)
+		m_poolDraw.Start(nWorkers);
+	else
+		m_poolDraw.Stop();
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::FlushDrawCommands()
+{
+	if(m_drawCommands.Empty())
+		return;
+	OLC_PROFILE_ZONE("FlushDrawCommands");
+
+	m_drawCommands.Bin();
+
+	//-- Each tile keeps its own dirty spans while the workers run, they are
+	//   merged into the target's once all tiles are done
+	const int nTileRows = olcDrawCommandBuffer::TILE_HEIGHT;
+	m_vecTileDirty.assign(size_t(m_drawCommands.Tiles() * nTileRows), sDirtySpan{ m_nScreenWidth, 0 });
+
+	sRasterTarget screen = DrawTarget();
+	m_poolDraw.Run(m_drawCommands.Tiles(), [this, &screen](int t)
+	{
+		const std::vector<uint32_t> &vecTile = m_drawCommands.Tile(t);
+		if(vecTile.empty())
+			return;
+		OLC_PROFILE_ZONE("DrawTile");
+
+		sRasterTarget target;
+		target.x1          = (t % m_drawCommands.TilesX()) * olcDrawCommandBuffer::TILE_WIDTH;
+		target.y1          = (t / m_drawCommands.TilesX()) * olcDrawCommandBuffer::TILE_HEIGHT;
+		target.x2          = std::min(target.x1 + olcDrawCommandBuffer::TILE_WIDTH,  m_nScreenWidth);
+		target.y2          = std::min(target.y1 + olcDrawCommandBuffer::TILE_HEIGHT, m_nScreenHeight);
+		target.pGlyphs     = screen.pGlyphs;
+		target.pAttributes = screen.pAttributes;
+		target.pDirty      = m_vecTileDirty.data() + size_t(t) * olcDrawCommandBuffer::TILE_HEIGHT;
+
+		for(uint32_t i : vecTile)
+			Execute(target, m_drawCommands.Command(i));
+	});
+
+	for(int t = 0; t < m_drawCommands.Tiles(); ++t)
+	{
+		int y1 = (t / m_drawCommands.TilesX()) * nTileRows;
+		for(int j = 0; j < nTileRows && y1 + j < m_nScreenHeight; ++j)
+		{
+			const sDirtySpan &span = m_vecTileDirty[size_t(t * nTileRows + j)];
+			if(span.nMin < span.nMax)
+				screen.MarkSpan(y1 + j, span.nMin, span.nMax);
+		}
+	}
+
+	m_drawCommands.Clear();
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::Execute(sRasterTarget &t, const sDrawCommand &cmd)
+{
+	switch(cmd.nType)
+	{
+	case DRAW_POINT:
+		RasterPoint(t, cmd.x1, cmd.y1, cmd.c, cmd.col);
+		break;
+	case DRAW_FILL:
+		RasterFill(t, cmd.x1, cmd.y1, cmd.x2, cmd.y2, cmd.c, cmd.col);
+		break;
+	case DRAW_LINE:
+		RasterLine(t, cmd.x1, cmd.y1, cmd.x2, cmd.y2, cmd.c, cmd.col);
+		break;
+	case DRAW_STRING:
+	case DRAW_STRING_ALPHA:
+		RasterString(t, cmd.x1, cmd.y1, m_drawCommands.Text(cmd.ox), cmd.x2, cmd.col, cmd.nType == DRAW_STRING_ALPHA);
+		break;
+	case DRAW_SPRITE:
+		RasterSprite(t, cmd.x1, cmd.y1, (const olcSprite*)cmd.pSprite, cmd.ox, cmd.oy, cmd.x2, cmd.y2);
+		break;
+	case DRAW_COMPILED_SPRITE:
+		RasterSprite(t, cmd.x1, cmd.y1, (const olcCompiledSprite*)cmd.pSprite, cmd.ox, cmd.oy, cmd.x2, cmd.y2);
+		break;
+	case DRAW_CIRCLE:
+	case DRAW_FILL_CIRCLE:
+		RasterCircle(t, cmd.x1, cmd.y1, cmd.x2, cmd.nType == DRAW_FILL_CIRCLE, cmd.c, cmd.col);
+		break;
+	case DRAW_FILL_TRIANGLE:
+		RasterTriangle(t, cmd.x1, cmd.y1, cmd.x2, cmd.y2, cmd.ox, cmd.oy, cmd.c, cmd.col);
+		break;
+	case DRAW_FILL_POLYGON:
+		RasterPolygon(t, m_drawCommands.Points(cmd.ox), cmd.x2, cmd.c, cmd.col);
+		break;
+	case DRAW_SPRITE_TRANSFORMED:
+		RasterSpriteTransformed(t, (const olcSprite*)cmd.pSprite, m_drawCommands.Transform(cmd.ox));
+		break;
+	}
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::RasterPoint(sRasterTarget &t, int x, int y, wchar_t c, short col)
+{
+	if (x >= t.x1 && x < t.x2 && y >= t.y1 && y < t.y2)
+	{
+		t.pGlyphs[y * m_nScreenWidth + x]     = c;
+		t.pAttributes[y * m_nScreenWidth + x] = uint8_t(col);
+		t.MarkSpan(y, x, x + 1);
+	}
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::RasterFill(sRasterTarget &t, int x1, int y1, int x2, int y2, wchar_t c, short col)
+{
+	x1 = std::max(x1, t.x1);
+	y1 = std::max(y1, t.y1);
+	x2 = std::min(x2, t.x2);
+	y2 = std::min(y2, t.y2);
+	if(x1 >= x2)
+		return;
+	for(int y = y1; y < y2; ++y)
+	{
+		size_t nAt = size_t(y * m_nScreenWidth + x1);
+		olcFillCells(t.pGlyphs + nAt, t.pAttributes + nAt, size_t(x2 - x1), c, uint8_t(col));
+		t.MarkSpan(y, x1, x2);
+	}
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::RasterSpans(sRasterTarget &t, const std::vector<sSpan> &vecSpans, wchar_t c, short col)
+{
+	for(const sSpan &span : vecSpans)
+	{
+		size_t nAt = size_t(span.y * m_nScreenWidth + span.x1);
+		olcFillCells(t.pGlyphs + nAt, t.pAttributes + nAt, size_t(span.x2 - span.x1), c, uint8_t(col));
+		t.MarkSpan(span.y, span.x1, span.x2);
+	}
+}
+//-----------------------------------------------------------------------------
+
+// The span list of the shape being drawn, one per thread for the tile workers
+static std::vector<sSpan>& ScratchSpans()
+{
+	thread_local std::vector<sSpan> vecSpans;
+	vecSpans.clear();
+	return vecSpans;
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::RasterLine(sRasterTarget &t, int x1, int y1, int x2, int y2, wchar_t c, short col)
+{
+	std::vector<sSpan> &vecSpans = ScratchSpans();
+	olcRasterLine(x1, y1, x2, y2, { t.x1, t.y1, t.x2, t.y2 }, vecSpans);
+	RasterSpans(t, vecSpans, c, col);
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::RasterCircle(sRasterTarget &t, int xc, int yc, int r, bool bFill, wchar_t c, short col)
+{
+	std::vector<sSpan> &vecSpans = ScratchSpans();
+	if(bFill)
+		olcRasterFillCircle(xc, yc, r, { t.x1, t.y1, t.x2, t.y2 }, vecSpans);
+	else
+		olcRasterCircle(xc, yc, r, { t.x1, t.y1, t.x2, t.y2 }, vecSpans);
+	RasterSpans(t, vecSpans, c, col);
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::RasterTriangle(sRasterTarget &t, int x1, int y1, int x2, int y2, int x3, int y3, wchar_t c, short col)
+{
+	std::vector<sSpan> &vecSpans = ScratchSpans();
+	olcRasterFillTriangle(x1, y1, x2, y2, x3, y3, { t.x1, t.y1, t.x2, t.y2 }, vecSpans);
+	RasterSpans(t, vecSpans, c, col);
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::RasterPolygon(sRasterTarget &t, const sRasterPoint *pPoints, int nPoints, wchar_t c, short col)
+{
+	std::vector<sSpan> &vecSpans = ScratchSpans();
+	olcRasterFillPolygon(pPoints, nPoints, { t.x1, t.y1, t.x2, t.y2 }, vecSpans);
+	RasterSpans(t, vecSpans, c, col);
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::RasterString(sRasterTarget &t, int x, int y, const wchar_t *s, int nLength, short col, bool bAlpha)
+{
+	if(y < t.y1 || y >= t.y2)
+		return;
+	int i1 = std::max(t.x1 - x, 0);
+	int i2 = std::min(t.x2 - x, nLength);
+	if(i1 >= i2)
+		return;
+
+	wchar_t *glyphs = t.pGlyphs + y * m_nScreenWidth + x;
+	uint8_t *attrs  = t.pAttributes + y * m_nScreenWidth + x;
+	if(!bAlpha)
+	{
+		memcpy(glyphs + i1, s + i1, sizeof(wchar_t) * size_t(i2 - i1));
+		memset(attrs + i1, uint8_t(col), size_t(i2 - i1));
+	}
+	else
+	{
+		for(int i = i1; i < i2; ++i)
+		{
+			if(s[i] != L' ')
+			{
+				glyphs[i] = s[i];
+				attrs[i]  = uint8_t(col);
+			}
+		}
+	}
+	t.MarkSpan(y, x + i1, x + i2);
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::RasterSprite(sRasterTarget &t, int x, int y, const olcSprite *sprite, int ox, int oy, int w, int h)
+{
+	//-- Clip the source rectangle to the sprite, then to the target
+	if(ox < 0) { x -= ox; w += ox; ox = 0; }
+	if(oy < 0) { y -= oy; h += oy; oy = 0; }
+	if(ox + w > sprite->nWidth)  w = sprite->nWidth  - ox;
+	if(oy + h > sprite->nHeight) h = sprite->nHeight - oy;
+
+	int i1 = std::max(t.x1 - x, 0);
+	int i2 = std::min(t.x2 - x, w);
+	int j1 = std::max(t.y1 - y, 0);
+	int j2 = std::min(t.y2 - y, h);
+	if(i1 >= i2)
+		return;
+
+	for(int j = j1; j < j2; ++j)
+	{
+		const wchar_t *glyphs  = sprite->Glyphs()  + (oy + j) * sprite->nWidth + ox;
+		const short   *colours = sprite->Colours() + (oy + j) * sprite->nWidth + ox;
+		wchar_t       *dstGlyphs = t.pGlyphs + (y + j) * m_nScreenWidth + x;
+		uint8_t       *dstAttrs  = t.pAttributes + (y + j) * m_nScreenWidth + x;
+		int            nMin    = i2;
+		int            nMax    = i1;
+
+		for(int i = i1; i < i2; ++i)
+		{
+			if(glyphs[i] != L' ')
+			{
+				dstGlyphs[i] = glyphs[i];
+				dstAttrs[i]  = uint8_t(colours[i]);
+				if(i < nMin) nMin = i;
+				nMax = i + 1;
+			}
+		}
+
+		if(nMin < nMax)
+			t.MarkSpan(y + j, x + nMin, x + nMax);
+	}
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::RasterSprite(sRasterTarget &t, int x, int y, const olcCompiledSprite *sprite, int ox, int oy, int w, int h)
+{
+	//-- Clip the source rectangle to the sprite, then to the target, once
+	if(ox < 0) { x -= ox; w += ox; ox = 0; }
+	if(oy < 0) { y -= oy; h += oy; oy = 0; }
+	if(ox + w > sprite->nWidth)  w = sprite->nWidth  - ox;
+	if(oy + h > sprite->nHeight) h = sprite->nHeight - oy;
+
+	int j0 = std::max(t.y1 - y, 0);
+	int j1 = std::min(t.y2 - y, h);
+	int sx0 = ox + std::max(t.x1 - x, 0);
+	int sx1 = ox + std::min(t.x2 - x, w);
+	if(sx0 >= sx1)
+		return;
+
+	for(int j = j0; j < j1; ++j)
+	{
+		int        sy     = oy + j;
+		int        dx     = x - ox;
+		wchar_t   *glyphs = t.pGlyphs + (y + j) * m_nScreenWidth + dx;
+		uint8_t   *attrs  = t.pAttributes + (y + j) * m_nScreenWidth + dx;
+		int        nMin   = sx1;
+		int        nMax   = sx0;
+
+		for(int r = sprite->vecRowStart[sy]; r < sprite->vecRowStart[sy + 1]; ++r)
+		{
+			const olcCompiledSprite::sRun &run = sprite->vecRuns[r];
+			int a = run.x > sx0 ? run.x : sx0;
+			int b = run.x + run.nLength < sx1 ? run.x + run.nLength : sx1;
+			if(a >= b)
+				continue;
+
+			memcpy(glyphs + a, &sprite->vecGlyphs[run.nCell + a - run.x], sizeof(wchar_t) * (b - a));
+			memcpy(attrs + a, &sprite->vecAttributes[run.nCell + a - run.x], size_t(b - a));
+			if(a < nMin) nMin = a;
+			if(b > nMax) nMax = b;
+		}
+
+		if(nMin < nMax)
+			t.MarkSpan(y + j, dx + nMin, dx + nMax);
+	}
+}
+//-----------------------------------------------------------------------------
+
+// Screen cells [x1, x2) x [y1, y2) the transformed sprite can cover
+static void TransformedBounds(const olcSprite *sprite, const olcTransform2D &transform, int &x1, int &y1, int &x2, int &y2)
+{
+	float fx[4], fy[4];
+	transform.Forward(0.0f,                  0.0f,                   fx[0], fy[0]);
+	transform.Forward(float(sprite->nWidth), 0.0f,                   fx[1], fy[1]);
+	transform.Forward(0.0f,                  float(sprite->nHeight), fx[2], fy[2]);
+	transform.Forward(float(sprite->nWidth), float(sprite->nHeight), fx[3], fy[3]);
+	x1 = int(std::floor(std::min({ fx[0], fx[1], fx[2], fx[3] })));
+	y1 = int(std::floor(std::min({ fy[0], fy[1], fy[2], fy[3] })));
+	x2 = int(std::ceil(std::max({ fx[0], fx[1], fx[2], fx[3] })));
+	y2 = int(std::ceil(std::max({ fy[0], fy[1], fy[2], fy[3] })));
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::RasterSpriteTransformed(sRasterTarget &t, const olcSprite *sprite, const olcTransform2D &transform)
+{
+	olcTransform2D inv;
+	if(!transform.Inverse(inv))
+		return;
+
+	//-- Clip the bounding box once, then every cell in it is inverse mapped
+	int x1, y1, x2, y2;
+	TransformedBounds(sprite, transform, x1, y1, x2, y2);
+	int xBase = x1;
+	x1 = std::max(x1, t.x1);
+	y1 = std::max(y1, t.y1);
+	x2 = std::min(x2, t.x2);
+	y2 = std::min(y2, t.y2);
+	if(x1 >= x2 || y1 >= y2)
+		return;
+
+	//-- Source coordinates in 16.16 fixed point: exact at the left edge of
+	//   the unclipped box on each row, stepped by a constant along it (so a
+	//   cell maps the same whichever tile draws it). Negative values turn
+	//   huge as unsigned, so one compare per axis tests both ends.
+	const double   ONE   = 65536.0;
+	const int64_t  dudx  = std::llround(inv.m[0][0] * ONE);
+	const int64_t  dvdx  = std::llround(inv.m[1][0] * ONE);
+	const uint64_t uEnd  = uint64_t(sprite->nWidth)  << 16;
+	const uint64_t vEnd  = uint64_t(sprite->nHeight) << 16;
+	const wchar_t *glyphs  = sprite->Glyphs();
+	const short   *colours = sprite->Colours();
+
+	for(int y = y1; y < y2; ++y)
+	{
+		double  cx = xBase + 0.5, cy = y + 0.5;
+		int64_t u  = std::llround((inv.m[0][0] * cx + inv.m[0][1] * cy + inv.m[0][2]) * ONE) + dudx * (x1 - xBase);
+		int64_t v  = std::llround((inv.m[1][0] * cx + inv.m[1][1] * cy + inv.m[1][2]) * ONE) + dvdx * (x1 - xBase);
+		wchar_t *dstGlyphs = t.pGlyphs + y * m_nScreenWidth;
+		uint8_t *dstAttrs  = t.pAttributes + y * m_nScreenWidth;
+		int      nMin      = x2;
+		int      nMax      = x1;
+
+		//-- Skip straight to the part of the row over the sprite, give or
+		//   take a cell; the compares below have the final say
+		double k0 = 0.0, k1 = double(x2 - x1);
+		auto narrow = [&](int64_t a, int64_t da, uint64_t nEnd)
+		{
+			if(da == 0)
+			{
+				if(uint64_t(a) >= nEnd)
+					k1 = -1.0;
+				return;
+			}
+			double f0 = -double(a) / double(da);
+			double f1 = (double(nEnd) - double(a)) / double(da);
+			k0 = std::max(k0, std::min(f0, f1) - 1.0);
+			k1 = std::min(k1, std::max(f0, f1) + 1.0);
+		};
+		narrow(u, dudx, uEnd);
+		narrow(v, dvdx, vEnd);
+		if(k0 >= k1)
+			continue;
+		int nSkip = int(k0);
+		int xEnd  = x1 + int(k1);
+		u += dudx * nSkip;
+		v += dvdx * nSkip;
+
+		for(int x = x1 + nSkip; x < xEnd; ++x, u += dudx, v += dvdx)
+		{
+			if(uint64_t(u) >= uEnd || uint64_t(v) >= vEnd)
+				continue;
+			int i = int(v >> 16) * sprite->nWidth + int(u >> 16);
+			if(glyphs[i] == L' ')
+				continue;
+			dstGlyphs[x] = glyphs[i];
+			dstAttrs[x]  = uint8_t(colours[i]);
+			if(x < nMin) nMin = x;
+			nMax = x + 1;
+		}
+
+		if(nMin < nMax)
+			t.MarkSpan(y, nMin, nMax);
+	}
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::Draw(int x, int y, wchar_t c, short col)
+{
+	if(DrawingPixels())
+	{
+		if(x >= 0 && x < PixelWidth() && y >= 0 && y < PixelHeight())
+		{
+			m_vecPixels[size_t(y * m_nScreenWidth + x)] = uint8_t(col & 0x0F);
+			MarkPixels(y, x, x + 1);
+		}
+		return;
+	}
+
+	if(m_bDeferredDrawing)
+	{
+		sDrawCommand cmd = {};
+		cmd.nType = DRAW_POINT;
+		cmd.x1 = x; cmd.y1 = y; cmd.c = c; cmd.col = col;
+		Record(cmd, x, y, x + 1, y + 1);
+		return;
+	}
+
+	sRasterTarget t = DrawTarget();
+	RasterPoint(t, x, y, c, col);
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::Fill(int x1, int y1, int x2, int y2, wchar_t c, short col)
+{
+	OLC_PROFILE_ZONE("Fill");
+	if(DrawingPixels())
+	{
+		x1 = std::max(x1, 0);
+		y1 = std::max(y1, 0);
+		x2 = std::min(x2, PixelWidth());
+		y2 = std::min(y2, PixelHeight());
+		if(x1 >= x2)
+			return;
+		for(int y = y1; y < y2; ++y)
+		{
+			memset(m_vecPixels.data() + size_t(y * m_nScreenWidth + x1), col & 0x0F, size_t(x2 - x1));
+			MarkPixels(y, x1, x2);
+		}
+		return;
+	}
+
+	Clip(x1, y1);
+	Clip(x2, y2);
+	if(m_bDeferredDrawing)
+	{
+		sDrawCommand cmd = {};
+		cmd.nType = DRAW_FILL;
+		cmd.x1 = x1; cmd.y1 = y1; cmd.x2 = x2; cmd.y2 = y2; cmd.c = c; cmd.col = col;
+		Record(cmd, x1, y1, x2, y2);
+		return;
+	}
+
+	sRasterTarget t = DrawTarget();
+	RasterFill(t, x1, y1, x2, y2, c, col);
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::Clear(wchar_t c, short col)
+{
+	OLC_PROFILE_ZONE("Clear");
+
+	//-- A layer cleared to transparent only needs what was drawn on it wiped
+	if(m_pDrawLayer != nullptr && c == L' ')
+	{
+		m_drawCommands.Clear();
+		ClearLayerInk(*m_pDrawLayer);
+		return;
+	}
+
+	//-- Pixels are cleared to the colour the cell would show
+	if(DrawingPixels())
+	{
+		m_drawCommands.Clear();
+		memset(m_vecPixels.data(), (c == L' ' ? col >> 4 : col) & 0x0F, m_vecPixels.size());
+		for(int y = 0; y < PixelHeight(); y += 2)
+			MarkPixels(y, 0, m_nScreenWidth);
+		return;
+	}
+
+	if(m_bDeferredDrawing)
+	{
+		//-- Nothing recorded before it can show, drop it
+		m_drawCommands.Clear();
+		Fill(0, 0, m_nScreenWidth, m_nScreenHeight, c, col);
+		return;
+	}
+
+	sRasterTarget t = DrawTarget();
+	olcFillCells(t.pGlyphs, t.pAttributes, size_t(m_nScreenWidth * m_nScreenHeight), c, uint8_t(col));
+	for(int y = 0; y < m_nScreenHeight; ++y)
+		t.MarkSpan(y, 0, m_nScreenWidth);
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::CopyRect(int x, int y, const olcCellBuffer &src, int sx, int sy, int w, int h)
+{
+	//-- The source may be the screen, so everything recorded so far has to
+	//   be in it first
+	FlushDrawCommands();
+
+	//-- Clip to the source, then the destination, moving the other along
+	if(sx < 0) { x -= sx; w += sx; sx = 0; }
+	if(sy < 0) { y -= sy; h += sy; sy = 0; }
+	if(sx + w > src.Width())  w = src.Width()  - sx;
+	if(sy + h > src.Height()) h = src.Height() - sy;
+	if(x < 0) { sx -= x; w += x; x = 0; }
+	if(y < 0) { sy -= y; h += y; y = 0; }
+	if(x + w > m_nScreenWidth)  w = m_nScreenWidth  - x;
+	if(y + h > m_nScreenHeight) h = m_nScreenHeight - y;
+	if(w <= 0 || h <= 0)
+		return;
+
+	//-- Walk the rows bottom up when copying downwards within the screen so
+	//   an overlapping source is read before it is overwritten
+	sRasterTarget  t         = DrawTarget();
+	wchar_t       *dstGlyphs = t.pGlyphs + y * m_nScreenWidth + x;
+	uint8_t       *dstAttrs  = t.pAttributes + y * m_nScreenWidth + x;
+	const wchar_t *srcGlyphs = src.Glyphs() + sy * src.Width() + sx;
+	const uint8_t *srcAttrs  = src.Attributes() + sy * src.Width() + sx;
+	bool bUp = std::less<const wchar_t*>()(srcGlyphs, dstGlyphs);
+	for(int j = 0; j < h; ++j)
+	{
+		int r = bUp ? h - 1 - j : j;
+		memmove(dstGlyphs + r * m_nScreenWidth, srcGlyphs + r * src.Width(), sizeof(wchar_t) * size_t(w));
+		memmove(dstAttrs + r * m_nScreenWidth, srcAttrs + r * src.Width(), size_t(w));
+		t.MarkSpan(y + r, x, x + w);
+	}
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::String(int x, int y, const wchar_t *s, int nLength, short col, bool bAlpha)
+{
+	if(m_bDeferredDrawing)
+	{
+		sDrawCommand cmd = {};
+		cmd.nType = bAlpha ? DRAW_STRING_ALPHA : DRAW_STRING;
+		cmd.x1 = x; cmd.y1 = y; cmd.x2 = nLength; cmd.col = col;
+		cmd.ox = m_drawCommands.AddText(std::wstring_view(s, size_t(nLength)));
+		Record(cmd, x, y, x + nLength, y + 1);
+		return;
+	}
+
+	sRasterTarget t = DrawTarget();
+	RasterString(t, x, y, s, nLength, col, bAlpha);
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::FontString(int x, int y, const wchar_t *s, int nLength, const olcFont &font, int nRows)
+{
+	//-- Only the characters that reach the screen are looked up
+	const int gw = font.GlyphWidth();
+	if(gw <= 0 || y >= m_nScreenHeight || y + nRows <= 0)
+		return;
+	int k1 = x < 0 ? -x / gw : 0;
+	int k2 = std::min(nLength, (m_nScreenWidth - x + gw - 1) / gw);
+	for(int k = k1; k < k2; ++k)
+	{
+		int ox, oy;
+		if(s[k] != L' ' && font.Locate(s[k], ox, oy))
+			DrawPartialSprite(x + k * gw, y, font.Atlas(), ox, oy, gw, nRows);
+	}
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::DrawString(int x, int y, std::wstring_view s, short col)
+{
+	OLC_PROFILE_ZONE("DrawString");
+	String(x, y, s.data(), int(s.size()), col, false);
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::DrawStringAlpha(int x, int y, std::wstring_view s, short col)
+{
+	OLC_PROFILE_ZONE("DrawString");
+	String(x, y, s.data(), int(s.size()), col, true);
+}
+//-----------------------------------------------------------------------------
+
+// The lines of the text being drawn, laid out afresh for each call
+static std::vector<sTextLine>& ScratchLines()
+{
+	thread_local std::vector<sTextLine> vecLines;
+	return vecLines;
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::DrawText(int x, int y, int w, int h, std::wstring_view s, short col, TEXT_ALIGN align, bool bAlpha)
+{
+	OLC_PROFILE_ZONE("DrawString");
+	std::vector<sTextLine> &vecLines = ScratchLines();
+	olcLayoutText(s, w, align, vecLines);
+
+	int nLines = h > 0 ? std::min(int(vecLines.size()), h) : int(vecLines.size());
+	for(int l = std::max(-y, 0); l < nLines && y + l < m_nScreenHeight; ++l)
+		String(x + vecLines[l].nOffset, y + l, s.data() + vecLines[l].nStart, vecLines[l].nLength, col, bAlpha);
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::DrawText(int x, int y, int w, int h, std::wstring_view s, const olcFont &font, TEXT_ALIGN align)
+{
+	OLC_PROFILE_ZONE("DrawString");
+	const int gh = font.GlyphHeight();
+	if(gh <= 0)
+		return;
+	std::vector<sTextLine> &vecLines = ScratchLines();
+	olcLayoutText(s, w, align, vecLines, font.GlyphWidth());
+
+	int nLines = h > 0 ? std::min(int(vecLines.size()), h / gh) : int(vecLines.size());
+	for(int l = 0; l < nLines; ++l)
+		FontString(x + vecLines[l].nOffset, y + l * gh, s.data() + vecLines[l].nStart, vecLines[l].nLength, font, gh);
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::DrawTextRun(int x, int y, const olcTextRun &run, short col, bool bAlpha)
+{
+	OLC_PROFILE_ZONE("DrawString");
+	const std::vector<sTextLine> &vecLines = run.Lines();
+	for(int l = std::max(-y, 0); l < int(vecLines.size()) && y + l < m_nScreenHeight; ++l)
+		String(x + vecLines[l].nOffset, y + l, run.Text().data() + vecLines[l].nStart, vecLines[l].nLength, col, bAlpha);
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::DrawTextRun(int x, int y, const olcTextRun &run, const olcFont &font)
+{
+	OLC_PROFILE_ZONE("DrawString");
+	const int gh = font.GlyphHeight();
+	const std::vector<sTextLine> &vecLines = run.Lines();
+	for(int l = 0; l < int(vecLines.size()); ++l)
+		FontString(x + vecLines[l].nOffset, y + l * gh, run.Text().data() + vecLines[l].nStart, vecLines[l].nLength, font, gh);
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::Clip(int &x, int &y)
+{
+	if(x < 0) x = 0;
+	else if(x >= m_nScreenWidth) x = m_nScreenWidth;
+	if(y < 0) y = 0;
+	else if(y >= m_nScreenHeight) y = m_nScreenHeight;
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::DrawLine(int x1, int y1, int x2, int y2, wchar_t c, short col)
+{
+	OLC_PROFILE_ZONE("DrawLine");
+	if(DrawingPixels())
+	{
+		std::vector<sSpan> &vecSpans = ScratchSpans();
+		olcRasterLine(x1, y1, x2, y2, { 0, 0, PixelWidth(), PixelHeight() }, vecSpans);
+		PixelSpans(vecSpans, col);
+		return;
+	}
+
+	if(m_bDeferredDrawing)
+	{
+		sDrawCommand cmd = {};
+		cmd.nType = DRAW_LINE;
+		cmd.x1 = x1; cmd.y1 = y1; cmd.x2 = x2; cmd.y2 = y2; cmd.c = c; cmd.col = col;
+		Record(cmd, std::min(x1, x2), std::min(y1, y2), std::max(x1, x2) + 1, std::max(y1, y2) + 1);
+		return;
+	}
+
+	sRasterTarget t = DrawTarget();
+	RasterLine(t, x1, y1, x2, y2, c, col);
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::DrawTriangle(int x1, int y1, int x2, int y2, int x3, int y3, wchar_t c, short col)
+{
+	DrawLine(x1, y1, x2, y2, c, col);
+	DrawLine(x2, y2, x3, y3, c, col);
+	DrawLine(x3, y3, x1, y1, c, col);
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::FillTriangle(int x1, int y1, int x2, int y2, int x3, int y3, wchar_t c, short col)
+{
+	OLC_PROFILE_ZONE("DrawShape");
+	if(DrawingPixels())
+	{
+		std::vector<sSpan> &vecSpans = ScratchSpans();
+		olcRasterFillTriangle(x1, y1, x2, y2, x3, y3, { 0, 0, PixelWidth(), PixelHeight() }, vecSpans);
+		PixelSpans(vecSpans, col);
+		return;
+	}
+
+	if(m_bDeferredDrawing)
+	{
+		sDrawCommand cmd = {};
+		cmd.nType = DRAW_FILL_TRIANGLE;
+		cmd.x1 = x1; cmd.y1 = y1; cmd.x2 = x2; cmd.y2 = y2; cmd.ox = x3; cmd.oy = y3; cmd.c = c; cmd.col = col;
+		Record(cmd, std::min({ x1, x2, x3 }), std::min({ y1, y2, y3 }), std::max({ x1, x2, x3 }) + 1, std::max({ y1, y2, y3 }) + 1);
+		return;
+	}
+
+	sRasterTarget t = DrawTarget();
+	RasterTriangle(t, x1, y1, x2, y2, x3, y3, c, col);
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::DrawCircle(int xc, int yc, int r, wchar_t c, short col)
+{
+	OLC_PROFILE_ZONE("DrawShape");
+	if(DrawingPixels())
+	{
+		std::vector<sSpan> &vecSpans = ScratchSpans();
+		olcRasterCircle(xc, yc, r, { 0, 0, PixelWidth(), PixelHeight() }, vecSpans);
+		PixelSpans(vecSpans, col);
+		return;
+	}
+
+	if(m_bDeferredDrawing)
+	{
+		sDrawCommand cmd = {};
+		cmd.nType = DRAW_CIRCLE;
+		cmd.x1 = xc; cmd.y1 = yc; cmd.x2 = r; cmd.c = c; cmd.col = col;
+		Record(cmd, xc - r, yc - r, xc + r + 1, yc + r + 1);
+		return;
+	}
+
+	sRasterTarget t = DrawTarget();
+	RasterCircle(t, xc, yc, r, false, c, col);
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::FillCircle(int xc, int yc, int r, wchar_t c, short col)
+{
+	OLC_PROFILE_ZONE("DrawShape");
+	if(DrawingPixels())
+	{
+		std::vector<sSpan> &vecSpans = ScratchSpans();
+		olcRasterFillCircle(xc, yc, r, { 0, 0, PixelWidth(), PixelHeight() }, vecSpans);
+		PixelSpans(vecSpans, col);
+		return;
+	}
+
+	if(m_bDeferredDrawing)
+	{
+		sDrawCommand cmd = {};
+		cmd.nType = DRAW_FILL_CIRCLE;
+		cmd.x1 = xc; cmd.y1 = yc; cmd.x2 = r; cmd.c = c; cmd.col = col;
+		Record(cmd, xc - r, yc - r, xc + r + 1, yc + r + 1);
+		return;
+	}
+
+	sRasterTarget t = DrawTarget();
+	RasterCircle(t, xc, yc, r, true, c, col);
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::DrawPolygon(const std::vector<sRasterPoint> &vecPoints, wchar_t c, short col)
+{
+	for(size_t i = 0; i < vecPoints.size(); ++i)
+	{
+		const sRasterPoint &a = vecPoints[i], &b = vecPoints[(i + 1) % vecPoints.size()];
+		DrawLine(a.x, a.y, b.x, b.y, c, col);
+	}
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::FillPolygon(const std::vector<sRasterPoint> &vecPoints, wchar_t c, short col)
+{
+	OLC_PROFILE_ZONE("DrawShape");
+	if(vecPoints.empty())
+		return;
+
+	if(DrawingPixels())
+	{
+		std::vector<sSpan> &vecSpans = ScratchSpans();
+		olcRasterFillPolygon(vecPoints.data(), int(vecPoints.size()), { 0, 0, PixelWidth(), PixelHeight() }, vecSpans);
+		PixelSpans(vecSpans, col);
+		return;
+	}
+
+	if(m_bDeferredDrawing)
+	{
+		int x1 = INT_MAX, y1 = INT_MAX, x2 = INT_MIN, y2 = INT_MIN;
+		for(const sRasterPoint &p : vecPoints)
+		{
+			x1 = std::min(x1, p.x); y1 = std::min(y1, p.y);
+			x2 = std::max(x2, p.x); y2 = std::max(y2, p.y);
+		}
+		sDrawCommand cmd = {};
+		cmd.nType = DRAW_FILL_POLYGON;
+		cmd.x2 = int(vecPoints.size()); cmd.c = c; cmd.col = col;
+		cmd.ox = m_drawCommands.AddPoints(vecPoints.data(), int(vecPoints.size()));
+		Record(cmd, x1, y1, x2 + 1, y2 + 1);
+		return;
+	}
+
+	sRasterTarget t = DrawTarget();
+	RasterPolygon(t, vecPoints.data(), int(vecPoints.size()), c, col);
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::DrawSprite(int x, int y, olcSprite *sprite)
+{
+	if (sprite == nullptr)
+		return;
+
+	DrawPartialSprite(x, y, sprite, 0, 0, sprite->nWidth, sprite->nHeight);
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::DrawPartialSprite(int x, int y, olcSprite *sprite, int ox, int oy, int w, int h)
+{
+	OLC_PROFILE_ZONE("DrawSprite");
+	if(sprite == nullptr)
+		return;
+
+	if(m_bDeferredDrawing)
+	{
+		sDrawCommand cmd = {};
+		cmd.nType = DRAW_SPRITE;
+		cmd.x1 = x; cmd.y1 = y; cmd.x2 = w; cmd.y2 = h; cmd.ox = ox; cmd.oy = oy;
+		cmd.pSprite = sprite;
+		Record(cmd, x, y, x + w, y + h);
+		return;
+	}
+
+	sRasterTarget t = DrawTarget();
+	RasterSprite(t, x, y, sprite, ox, oy, w, h);
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::DrawSpriteTransformed(olcSprite *sprite, const olcTransform2D &transform)
+{
+	OLC_PROFILE_ZONE("DrawSpriteTransformed");
+	if(sprite == nullptr || sprite->nWidth <= 0 || sprite->nHeight <= 0)
+		return;
+
+	if(m_bDeferredDrawing)
+	{
+		int x1, y1, x2, y2;
+		TransformedBounds(sprite, transform, x1, y1, x2, y2);
+		sDrawCommand cmd = {};
+		cmd.nType = DRAW_SPRITE_TRANSFORMED;
+		cmd.ox = m_drawCommands.AddTransform(transform);
+		cmd.pSprite = sprite;
+		Record(cmd, x1, y1, x2, y2);
+		return;
+	}
+
+	sRasterTarget t = DrawTarget();
+	RasterSpriteTransformed(t, sprite, transform);
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::DrawSprite(int x, int y, const olcCompiledSprite *sprite)
+{
+	if(sprite == nullptr)
+		return;
+
+	DrawPartialSprite(x, y, sprite, 0, 0, sprite->nWidth, sprite->nHeight);
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::DrawPartialSprite(int x, int y, const olcCompiledSprite *sprite, int ox, int oy, int w, int h)
+{
+	OLC_PROFILE_ZONE("DrawSprite");
+	if(sprite == nullptr)
+		return;
+
+	if(m_bDeferredDrawing)
+	{
+		sDrawCommand cmd = {};
+		cmd.nType = DRAW_COMPILED_SPRITE;
+		cmd.x1 = x; cmd.y1 = y; cmd.x2 = w; cmd.y2 = h; cmd.ox = ox; cmd.oy = oy;
+		cmd.pSprite = sprite;
+		Record(cmd, x, y, x + w, y + h);
+		return;
+	}
+
+	sRasterTarget t = DrawTarget();
+	RasterSprite(t, x, y, sprite, ox, oy, w, h);
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::DrawParticles(const olcParticleSystem &particles)
+{
+	OLC_PROFILE_ZONE("DrawParticles");
+	const size_t   n       = particles.Size();
+	const float   *px      = particles.X();
+	const float   *py      = particles.Y();
+	const wchar_t *glyphs  = particles.Glyphs();
+	const uint8_t *colours = particles.Colours();
+
+	//-- The float compares reject NaN too, and leave only positions that
+	//   truncate to a cell on screen
+	if(DrawingPixels())
+	{
+		const float fw = float(PixelWidth()), fh = float(PixelHeight());
+		for(size_t i = 0; i < n; ++i)
+		{
+			float x = px[i], y = py[i];
+			if(!(x >= 0.0f && x < fw && y >= 0.0f && y < fh))
+				continue;
+			int ix = int(x), iy = int(y);
+			m_vecPixels[size_t(iy * m_nScreenWidth + ix)] = colours[i] & 0x0F;
+			MarkPixels(iy, ix, ix + 1);
+		}
+		return;
+	}
+
+	FlushDrawCommands();
+	sRasterTarget t  = DrawTarget();
+	const float   fw = float(m_nScreenWidth), fh = float(m_nScreenHeight);
+	for(size_t i = 0; i < n; ++i)
+	{
+		float x = px[i], y = py[i];
+		if(!(x >= 0.0f && x < fw && y >= 0.0f && y < fh))
+			continue;
+		int    ix  = int(x), iy = int(y);
+		size_t nAt = size_t(iy * m_nScreenWidth + ix);
+		t.pGlyphs[nAt]     = glyphs[i];
+		t.pAttributes[nAt] = colours[i];
+		t.MarkSpan(iy, ix, ix + 1);
+	}
+}
+//-----------------------------------------------------------------------------
+
+// Copy n cells of a tile row. The usual tile widths get fixed size copies
+// the compiler can inline, a call per row would cost more than the copy.
+static inline void CopyTileRow(wchar_t *pGlyphs, uint8_t *pAttributes, const wchar_t *glyphs, const uint8_t *attributes, int n)
+{
+	switch(n)
+	{
+	case 4:
+		memcpy(pGlyphs, glyphs, 4 * sizeof(wchar_t));
+		memcpy(pAttributes, attributes, 4);
+		break;
+	case 8:
+		memcpy(pGlyphs, glyphs, 8 * sizeof(wchar_t));
+		memcpy(pAttributes, attributes, 8);
+		break;
+	case 16:
+		memcpy(pGlyphs, glyphs, 16 * sizeof(wchar_t));
+		memcpy(pAttributes, attributes, 16);
+		break;
+	default:
+		memcpy(pGlyphs, glyphs, size_t(n) * sizeof(wchar_t));
+		memcpy(pAttributes, attributes, size_t(n));
+		break;
+	}
+}
+//-----------------------------------------------------------------------------
+
+void olcConsoleGameEngine::DrawTilemap(olcTilemap &map, const olcTileset &tileset, float fCameraX, float fCameraY)
+{
+	OLC_PROFILE_ZONE("DrawTilemap");
+	const int tw = tileset.TileWidth(), th = tileset.TileHeight(), nTiles = tileset.Count();
+	const int cs = map.ChunkSize();
+	if(tw <= 0 || map.Width() <= 0)
+		return;
+
+	FlushDrawCommands();
+	sRasterTarget t = DrawTarget();
+
+	//-- World cell at (0, 0) of the screen, and the tiles under the target
+	const long long cx  = (long long)std::floor(fCameraX);
+	const long long cy  = (long long)std::floor(fCameraY);
+	auto floordiv = [](long long a, long long b) { return a >= 0 ? a / b : -((-a + b - 1) / b); };
+	const long long tx1 = std::max(floordiv(cx + t.x1, tw), 0LL);
+	const long long ty1 = std::max(floordiv(cy + t.y1, th), 0LL);
+	const long long tx2 = std::min(floordiv(cx + t.x2 - 1, tw), (long long)map.Width()  - 1);
+	const long long ty2 = std::min(floordiv(cy + t.y2 - 1, th), (long long)map.Height() - 1);
+	if(tx1 > tx2 || ty1 > ty2)
+		return;
+	map.Stream(int(tx1), int(ty1), int(tx2), int(ty2));
+
+	for(int y = t.y1; y < t.y2; ++y)
+	{
+		long long wy = cy + y;
+		if(wy < ty1 * th || wy >= (ty2 + 1) * th)
+			continue;
+		const int ty = int(wy / th), r = int(wy % th);
+		wchar_t  *pGlyphs     = t.pGlyphs     + size_t(y) * size_t(m_nScreenWidth);
+		uint8_t  *pAttributes = t.pAttributes + size_t(y) * size_t(m_nScreenWidth);
+		int       nMin = INT_MAX, nMax = INT_MIN;
+
+		//-- A chunk at a time, so each tile index is a plain array read
+		for(long long tx = tx1; tx <= tx2; )
+		{
+			const int       ncx    = int(tx / cs);
+			const long long nBase  = (long long)ncx * cs;
+			const long long txEnd  = std::min(nBase + cs - 1, tx2);
+			const uint16_t *pTiles = map.ViewRow(ncx, ty);
+			if(pTiles == nullptr)
+			{
+				tx = txEnd + 1;
+				continue;
+			}
+			for(; tx <= txEnd; ++tx)
+			{
+				const int n = pTiles[tx - nBase];
+				if(n >= nTiles)
+					continue;
+
+				//-- Only the tiles at the edges of the target are clipped
+				const int      sx         = int(tx * tw - cx);
+				const int      a          = std::max(sx, t.x1), b = std::min(sx + tw, t.x2);
+				const wchar_t *glyphs     = tileset.RowGlyphs(n, r)     + (a - sx);
+				const uint8_t *attributes = tileset.RowAttributes(n, r) + (a - sx);
+				if(tileset.RowSolid(n, r))
+					CopyTileRow(pGlyphs + a, pAttributes + a, glyphs, attributes, b - a);
+				else
+				{
+					for(int i = 0; i < b - a; ++i)
+					{
+						if(glyphs[i] == L' ')
+							continue;
+						pGlyphs[a + i]     = glyphs[i];
+						pAttributes[a + i] = attributes[i];
+					}
+				}
+				nMin = std::min(nMin, a);
+				nMax = std::max(nMax, b);
+			}
 		}
+		if(nMin < nMax)
+			t.MarkSpan(y, nMin, nMax);
 	}
 }
 //-----------------------------------------------------------------------------
@@ -582,7 +2204,8 @@ void olcConsoleGameEngine::Start()
 	std::thread t = std::thread(&olcConsoleGameEngine::GameThread, this);
 	// Wait for thread to be exited
 	auto lck = std::unique_lock<std::mutex>(m_muxGame);
-	m_cvGameFinished.wait(lck);
+	m_cvGameFinished.wait(lck, [this] { return !m_bAtomActive; });
+	lck.unlock();
 	// Tidy up
 	t.join();
 }
@@ -56,11 +56,22 @@ the application to close.
 Input is also handled for you - interrogate the m_keys[] array with the virtual
 keycode you want to know about. bPressed is set for the frame the key is pressed down
 in, bHeld is set if the key is held down, bReleased is set for the frame the key
-is released in.
+is released in. m_mouse[] does the same for the mouse buttons, and m_mousePosX/Y
+hold the mouse position in cells. The buttons also show up in m_keys[] as VK_LBUTTON,
+VK_RBUTTON, VK_MBUTTON, VK_XBUTTON1 and VK_XBUTTON2. Input is collected on its own
+thread, so even a press shorter than a frame shows up; GetInputEvents() gives the raw,
+timestamped events. Keys are read from the console's input rather than sampled, so
+they only register while the console window has focus.
 
 The draw routines treat characters like pixels. By default they are set to white solid
 blocks - but you can draw any unicode character, using any of the colours listed below.
 
+Frames are presented through a render backend (see olcRenderBackend.h). The default
+is the Windows console; call SetRenderBackend() before ConstructConsole() to use a
+different one, e.g. olcHeadlessBackend to run the engine without any terminal at all.
+Presenting happens on its own thread while the next frame is being drawn; see
+SetPresentMode() for the number of screen buffers and what happens when they run out.
+
 There may be bugs! 
 
 See my other videos for examples!
@@ -73,14 +84,31 @@ See my other videos for examples!
 #include <string>
 #include <atomic>
 #include <condition_variable>
+#include <deque>
+#include <memory>
 #include <mutex>
+#include <thread>
+#include <vector>
 //-----------------------------------------------------------------------------
 #include <filesystem>
 
 #define S2WS(x)		std::filesystem::path(x).wstring()
 #define WS2S(x)		std::filesystem::path(x).string()
 //-----------------------------------------------------------------------------
-#include <windows.h>
+#include "olcRenderBackend.h"
+#include "olcFrameScheduler.h"
+#include "olcDrawCommands.h"
+#include "olcWorkerPool.h"
+#include "olcInput.h"
+#include "olcSpscQueue.h"
+#include "olcFrameRecording.h"
+#include "olcProfiler.h"
+#include "olcText.h"
+#include "olcParticles.h"
+//-----------------------------------------------------------------------------
+
+class olcTileset;
+class olcTilemap;
 //-----------------------------------------------------------------------------
 
 enum COLOUR
@@ -132,10 +160,15 @@ class olcSprite
 private:
 	wchar_t* m_Glyphs  = nullptr;
 	short*   m_Colours = nullptr;
+	bool     m_bOwner  = true;
 
 	void Create(int w, int h);
 	void Destroy();
 
+	// Point the sprite at cell data it does not own (see olcSpritePack)
+	void View(int w, int h, wchar_t *glyphs, short *colours);
+	friend class olcSpritePack;
+
 public:
 	olcSprite()	                  {}
 	olcSprite(int w, int h)       { Create(w, h); }
@@ -153,28 +186,258 @@ public:
 
 	bool    Save(std::wstring sFile);
 	bool    Load(std::wstring sFile);
+
+	// Raw row-major cell data, nWidth * nHeight entries each
+	const wchar_t* Glyphs() const  { return m_Glyphs;  }
+	const short*   Colours() const { return m_Colours; }
+};
+//-----------------------------------------------------------------------------
+
+// A sprite pre-processed for drawing: every row is stored as runs of opaque
+// cells (anything but L' '), ready to be copied straight into the screen
+// buffer. It is a snapshot, recompile it if the source sprite changes.
+class olcCompiledSprite
+{
+public:
+	struct sRun
+	{
+		int x;			// first column of the run
+		int nLength;
+		int nCell;		// index of its first cell in vecGlyphs/vecAttributes
+	};
+
+	olcCompiledSprite() {}
+	olcCompiledSprite(const olcSprite *sprite) { Compile(sprite); }
+
+	void Compile(const olcSprite *sprite);
+
+	int nWidth  = 0;
+	int nHeight = 0;
+
+	// Runs of row y are vecRuns[vecRowStart[y]] .. vecRuns[vecRowStart[y + 1] - 1]
+	std::vector<sRun>      vecRuns;
+	std::vector<int>       vecRowStart;
+	std::vector<wchar_t>   vecGlyphs;
+	std::vector<uint8_t>   vecAttributes;
+};
+//-----------------------------------------------------------------------------
+
+// A bitmap font: a grid of glyph cells over an atlas sprite, holding the
+// characters from cFirst on, left to right and top to bottom. The atlas is
+// compiled when the font is created, so text is blitted as sprite runs in
+// the atlas' colours, L' ' transparent. Characters past the end of the
+// atlas are skipped.
+class olcFont
+{
+private:
+	olcCompiledSprite m_atlas;
+	int               m_nGlyphWidth  = 0;
+	int               m_nGlyphHeight = 0;
+	int               m_nColumns     = 0;
+	int               m_nGlyphs      = 0;
+	wchar_t           m_cFirst       = L' ';
+
+public:
+	olcFont() {}
+	olcFont(const olcSprite *atlas, int nGlyphWidth, int nGlyphHeight, wchar_t cFirst = L' ') { Create(atlas, nGlyphWidth, nGlyphHeight, cFirst); }
+
+	bool Create(const olcSprite *atlas, int nGlyphWidth, int nGlyphHeight, wchar_t cFirst = L' ');
+	bool Load(const std::wstring &sFile, int nGlyphWidth, int nGlyphHeight, wchar_t cFirst = L' ');
+
+	int GlyphWidth() const  { return m_nGlyphWidth;  }
+	int GlyphHeight() const { return m_nGlyphHeight; }
+
+	// Top left of the cell of c in the atlas, false if the font has none
+	inline bool Locate(wchar_t c, int &ox, int &oy) const
+	{
+		if(c < m_cFirst || int(c - m_cFirst) >= m_nGlyphs)
+			return false;
+		int n = int(c - m_cFirst);
+		ox = (n % m_nColumns) * m_nGlyphWidth;
+		oy = (n / m_nColumns) * m_nGlyphHeight;
+		return true;
+	}
+
+	const olcCompiledSprite* Atlas() const { return &m_atlas; }
 };
 //-----------------------------------------------------------------------------
 
 class olcConsoleGameEngine
 {
 private:
-	HANDLE                     m_hOriginalConsole;
-	CONSOLE_SCREEN_BUFFER_INFO m_OriginalConsoleInfo;
-	HANDLE                     m_hConsole;
-	SMALL_RECT                 m_rectWindow;
-	short*                     m_keyOldState;
-	short*                     m_keyNewState;
+	std::unique_ptr<olcRenderBackend> m_pBackend;
+
+	// Per row span [nMin, nMax) of the cells touched since the last present
+	struct sDirtySpan
+	{
+		int nMin;
+		int nMax;
+	};
+	std::vector<sDirtySpan>    m_vecDirtyRows;
+	bool                       m_bDirtyTracking;
+
+	// Screen buffers. The game draws into one of them (m_bufScreen) while the
+	// presenter thread writes out the ones queued at frame end.
+	enum FRAME_STATE
+	{
+		FRAME_FREE,
+		FRAME_DRAWING,
+		FRAME_QUEUED,
+		FRAME_PRESENTING,
+	};
+	struct sFrame
+	{
+		olcCellBuffer                buf;
+		std::vector<sCellRect>       vecRegions;
+		std::vector<sCellRect>       vecStale;	// where buf is behind the frame being drawn
+		float                        fElapsedTime;
+		float                        fJitter;
+		FRAME_STATE                  nState;
+	};
+	std::vector<sFrame>        m_vecFrames;
+	std::deque<int>            m_queuePresent;
+	int                        m_nDrawFrame;
+	int                        m_nPresentBuffers;
+	PRESENT_POLICY             m_nPresentPolicy;
+	uint64_t                   m_nFramesDropped;
+	bool                       m_bPresenterQuit;
+	std::thread                m_threadPresenter;
+	std::mutex                 m_muxPresent;
+	std::condition_variable    m_cvFrameQueued;
+	std::condition_variable    m_cvFrameFree;
 
 	void GameThread();
+	void CollectDirtyRegions(std::vector<sCellRect> &vecRegions);
+
+	void StartPresenter();
+	void StopPresenter();
+	void PresenterThread();
+	void SubmitFrame(float fElapsedTime, PRESENT_POLICY policy);
+	void PresentFrame(sFrame &frame);
+
+	inline void MarkDirtySpan(int y, int x1, int x2)
+	{
+		sDirtySpan &span = m_vecDirtyRows[y];
+		if(x1 < span.nMin) span.nMin = x1;
+		if(x2 > span.nMax) span.nMax = x2;
+	}
+
+	olcFrameScheduler          m_scheduler;
+	float                      m_fTargetFrameTime;
+
+	// Pace to the target frame time, or to the fixed step without one
+	void UpdateFramePacing();
 
-	void handleKeyboardInput();
-	void handleMouseInput();
+	// Where a Raster* routine may write: [x1, x2) x [y1, y2) of the planes
+	// (rows one screen width apart), with the dirty span of row y in
+	// pDirty[y - y1]
+	struct sRasterTarget
+	{
+		int         x1, y1, x2, y2;
+		wchar_t*    pGlyphs;
+		uint8_t*    pAttributes;
+		sDirtySpan* pDirty;
+
+		inline void MarkSpan(int y, int a, int b)
+		{
+			sDirtySpan &span = pDirty[y - y1];
+			if(a < span.nMin) span.nMin = a;
+			if(b > span.nMax) span.nMax = b;
+		}
+	};
+
+	// Deferred drawing: commands recorded during the update, drawn tile by
+	// tile on the worker pool when the frame is submitted
+	bool                       m_bDeferredDrawing;
+	olcDrawCommandBuffer       m_drawCommands;
+	olcWorkerPool              m_poolDraw;
+	std::vector<sDirtySpan>    m_vecTileDirty;
+
+	// Layers, sorted by z-order, bottom first
+	struct sLayer
+	{
+		std::wstring            sName;
+		int                     nZ;
+		bool                    bVisible;
+		bool                    bDirty;		// drawn into since the last composite
+		olcCellBuffer           cells;
+		std::vector<sDirtySpan> vecDirty;	// per row, drawn since the last composite
+		std::vector<sDirtySpan> vecInk;		// per row, may hold anything but L' '
+	};
+	std::vector<std::unique_ptr<sLayer>> m_vecLayers;
+	sLayer*                    m_pDrawLayer;
+	bool                       m_bLayersChanged;
+
+	// Pixel mode: a colour per pixel, two pixel rows to a screen row, packed
+	// into half block cells where they changed before anything else draws
+	// on the screen (or under the layers, when there are any)
+	bool                       m_bPixelMode;
+	bool                       m_bPixelsDirty;
+	std::vector<uint8_t>       m_vecPixels;
+	std::vector<sDirtySpan>    m_vecPixelDirty;	// per screen row
+
+	inline bool DrawingPixels() const { return m_bPixelMode && m_pDrawLayer == nullptr; }
+	inline void MarkPixels(int y, int x1, int x2)
+	{
+		sDirtySpan &span = m_vecPixelDirty[y >> 1];
+		if(x1 < span.nMin) span.nMin = x1;
+		if(x2 > span.nMax) span.nMax = x2;
+		m_bPixelsDirty = true;
+	}
+	void PixelSpans(const std::vector<sSpan> &vecSpans, short col);
+	void PackPixels();
+
+	sLayer* FindLayer(const std::wstring &sName);
+	void SortLayers();
+	void ClearLayerInk(sLayer &layer);
+	void CompositeLayers();
+
+	sRasterTarget DrawTarget();
+	void Record(sDrawCommand &cmd, int x1, int y1, int x2, int y2);
+	void Execute(sRasterTarget &t, const sDrawCommand &cmd);
+
+	void RasterPoint(sRasterTarget &t, int x, int y, wchar_t c, short col);
+	void RasterFill(sRasterTarget &t, int x1, int y1, int x2, int y2, wchar_t c, short col);
+	void RasterSpans(sRasterTarget &t, const std::vector<sSpan> &vecSpans, wchar_t c, short col);
+	void RasterLine(sRasterTarget &t, int x1, int y1, int x2, int y2, wchar_t c, short col);
+	void RasterCircle(sRasterTarget &t, int xc, int yc, int r, bool bFill, wchar_t c, short col);
+	void RasterTriangle(sRasterTarget &t, int x1, int y1, int x2, int y2, int x3, int y3, wchar_t c, short col);
+	void RasterPolygon(sRasterTarget &t, const sRasterPoint *pPoints, int nPoints, wchar_t c, short col);
+	void RasterString(sRasterTarget &t, int x, int y, const wchar_t *s, int nLength, short col, bool bAlpha);
+	void RasterSprite(sRasterTarget &t, int x, int y, const olcSprite *sprite, int ox, int oy, int w, int h);
+	void RasterSprite(sRasterTarget &t, int x, int y, const olcCompiledSprite *sprite, int ox, int oy, int w, int h);
+	void RasterSpriteTransformed(sRasterTarget &t, const olcSprite *sprite, const olcTransform2D &transform);
+
+	void String(int x, int y, const wchar_t *s, int nLength, short col, bool bAlpha);
+	void FontString(int x, int y, const wchar_t *s, int nLength, const olcFont &font, int nRows);
+
+	// Input events travel from the input thread to the game thread
+	olcSpscQueue<olcInputEvent> m_queueInput;
+	std::thread                m_threadInput;
+	std::atomic<bool>          m_bInputQuit;
+	std::vector<olcInputEvent> m_vecInputPending;
+	std::vector<olcInputEvent> m_vecInputEvents;
+	int                        m_nMouseLatchX;
+	int                        m_nMouseLatchY;
+
+	void StartInput();
+	void StopInput();
+	void InputThread();
+
+	void handleInput();
+	void commitInput();
+
+	// Every presented frame goes to the recorder, if one is running
+	std::unique_ptr<olcFrameRecorder> m_pRecorder;
+	std::mutex                 m_muxRecorder;
+
+	// Reads the screens and key states of the instances it steps
+	friend class olcEngineBatch;
 
 protected:
 	int                        m_nScreenWidth;
 	int                        m_nScreenHeight;
-	CHAR_INFO*                 m_bufScreen;
+	olcCellBuffer*             m_bufScreen;
 	std::atomic<bool>          m_bAtomActive;
 	std::condition_variable    m_cvGameFinished;
 	std::mutex                 m_muxGame;
@@ -185,10 +448,19 @@ protected:
 		bool bPressed;
 		bool bReleased;
 		bool bHeld;
-	} m_keys[256];
+	} m_keys[256], m_mouse[5];
 
+	int                        m_mousePosX;
+	int                        m_mousePosY;
 
-	int Error(wchar_t *msg);
+private:
+	sKeyState                  m_keyLatch[256];
+	sKeyState                  m_mouseLatch[5];
+
+	static void latchButton(sKeyState &latch, bool bDown);
+
+protected:
+	int Error(const wchar_t *msg);
 
 public:
 	olcConsoleGameEngine();
@@ -196,20 +468,147 @@ public:
 
 	inline int ScreenWidth()  { return m_nScreenWidth;  }
 	inline int ScreenHeight() {	return m_nScreenHeight;	}
+	inline int GetMouseX()    { return m_mousePosX; }
+	inline int GetMouseY()    { return m_mousePosY; }
+
+	// Every input event delivered to the current update, oldest first
+	const std::vector<olcInputEvent>& GetInputEvents() const { return m_vecInputEvents; }
+	// Feed an event in as if the backend had reported it. Only possible for
+	// backends without input of their own (the headless one), returns false
+	// otherwise or when the queue is full.
+	bool InjectInput(const olcInputEvent &e);
+
+	// Replace the output sink. Must be called before ConstructConsole()
+	void SetRenderBackend(std::unique_ptr<olcRenderBackend> pBackend);
+	olcRenderBackend* RenderBackend() { return m_pBackend.get(); }
 
 	int ConstructConsole(int width, int height, int fontw = 12, int fonth = 12);
 
 	void Draw(int x, int y, wchar_t c = 0x2588, short col = 0x000F);
-	void DrawString(int x, int y, std::wstring c, short col = 0x000F);
-	void DrawStringAlpha(int x, int y, std::wstring c, short col = 0x000F);
+	void DrawString(int x, int y, std::wstring_view s, short col = 0x000F);
+	void DrawStringAlpha(int x, int y, std::wstring_view s, short col = 0x000F);
+	// Text in the w x h box at (x, y), 0 for no limit: laid out as by
+	// olcLayoutText() (so wrapped at w), the lines that do not fit in h left
+	// out. With a font, w and h are still in cells and only whole lines are
+	// drawn; the font must outlive the frame when drawing is deferred.
+	void DrawText(int x, int y, int w, int h, std::wstring_view s, short col = 0x000F, TEXT_ALIGN align = TEXT_LEFT, bool bAlpha = false);
+	void DrawText(int x, int y, int w, int h, std::wstring_view s, const olcFont &font, TEXT_ALIGN align = TEXT_LEFT);
+	// Text laid out beforehand, one line per row. For a font the run must
+	// have been laid out with its GlyphWidth() as the advance.
+	void DrawTextRun(int x, int y, const olcTextRun &run, short col = 0x000F, bool bAlpha = false);
+	void DrawTextRun(int x, int y, const olcTextRun &run, const olcFont &font);
 	void DrawLine(int x1, int y1, int x2, int y2, wchar_t c = 0x2588, short col = 0x000F);
+	void DrawTriangle(int x1, int y1, int x2, int y2, int x3, int y3, wchar_t c = 0x2588, short col = 0x000F);
+	void FillTriangle(int x1, int y1, int x2, int y2, int x3, int y3, wchar_t c = 0x2588, short col = 0x000F);
+	void DrawCircle(int xc, int yc, int r, wchar_t c = 0x2588, short col = 0x000F);
+	void FillCircle(int xc, int yc, int r, wchar_t c = 0x2588, short col = 0x000F);
+	// Closed outline / even-odd fill (convex or concave, outline included)
+	void DrawPolygon(const std::vector<sRasterPoint> &vecPoints, wchar_t c = 0x2588, short col = 0x000F);
+	void FillPolygon(const std::vector<sRasterPoint> &vecPoints, wchar_t c = 0x2588, short col = 0x000F);
 	void DrawSprite(int x, int y, olcSprite *sprite);
 	void DrawPartialSprite(int x, int y, olcSprite *sprite, int ox, int oy, int w, int h);
+	void DrawSprite(int x, int y, const olcCompiledSprite *sprite);
+	void DrawPartialSprite(int x, int y, const olcCompiledSprite *sprite, int ox, int oy, int w, int h);
+	// Draw a rotated/scaled/sheared sprite, nearest cell, L' ' transparent
+	void DrawSpriteTransformed(olcSprite *sprite, const olcTransform2D &transform);
+	// Every particle of the system at its cell (its pixel in pixel mode), in
+	// one pass. Always drawn right away, over anything recorded so far.
+	void DrawParticles(const olcParticleSystem &particles);
+	// The tiles of a map that fall under the draw target, with the world
+	// cell (fCameraX, fCameraY) at its top left. The map scrolls a cell at
+	// a time, the camera can rest anywhere in between. Streamed maps load
+	// the chunks coming into view as a side effect. Always drawn right away.
+	void DrawTilemap(olcTilemap &map, const olcTileset &tileset, float fCameraX, float fCameraY);
 
 	void Fill(int x1, int y1, int x2, int y2, wchar_t c = 0x2588, short col = 0x000F);
+	void Clear(wchar_t c = L' ', short col = 0x0000);
+	// Copy the w x h block at (sx, sy) of src to (x, y). The source may be
+	// (and may overlap with) the screen buffer itself.
+	void CopyRect(int x, int y, const olcCellBuffer &src, int sx, int sy, int w, int h);
 	void Clip(int &x, int &y);
+
+	// Only the cells touched by the Draw/Fill routines are presented each
+	// frame. Code writing into m_bufScreen directly must mark what it changed
+	// (x2/y2 exclusive), or switch tracking off to present the whole screen.
+	void MarkDirty(int x1, int y1, int x2, int y2);
+	void SetDirtyTracking(bool bEnable) { m_bDirtyTracking = bEnable; }
+
+	// Record the Draw/Fill/DrawLine/DrawString/DrawSprite calls instead of
+	// drawing right away, and draw them in tiles on nWorkers threads (plus
+	// the game thread; negative uses all cores) when the frame ends. Sprites
+	// must stay alive until then, and m_bufScreen only holds the recorded
+	// drawing after FlushDrawCommands().
+	void SetDeferredDrawing(bool bEnable, int nWorkers = -1);
+	void FlushDrawCommands();
+
+	// Named layers, each a screen sized buffer that keeps its contents from
+	// frame to frame. Higher z is on top and L' ' is transparent, as with
+	// DrawSprite(). At frame end the screen is recomposited only where some
+	// layer was drawn into, so a layer left alone costs nothing; Clear() on
+	// a layer only wipes what was drawn on it. The screen is overwritten
+	// wherever a layer changes, so once layers are used draw into layers.
+	// Create them after ConstructConsole().
+	bool CreateLayer(const std::wstring &sName, int nZ = 0);
+	void DeleteLayer(const std::wstring &sName);
+	// Direct the drawing routines at a layer, L"" for the screen itself
+	bool SetDrawLayer(const std::wstring &sName);
+	void SetLayerZ(const std::wstring &sName, int nZ);
+	void SetLayerVisible(const std::wstring &sName, bool bVisible);
+	bool IsLayerDirty(const std::wstring &sName);
+
+	// Pixel mode doubles the vertical resolution. Draw, Fill, DrawLine and
+	// the other shape routines then plot PixelWidth() x PixelHeight() pixels
+	// in the foreground colour of col (the glyph is ignored), and every cell
+	// shows the pixel pair it covers as an upper half block. Cell drawing
+	// (strings, sprites) still works and lands on top of the pixels drawn
+	// before it; with deferred drawing, on top of all of them. While a layer
+	// is the draw target the routines draw cells on it as usual, and the
+	// pixels sit under every layer.
+	void SetPixelMode(bool bEnable);
+	bool IsPixelMode() const { return m_bPixelMode; }
+	inline int PixelWidth()  { return m_nScreenWidth;      }
+	inline int PixelHeight() { return m_nScreenHeight * 2; }
+
+	// Record every presented frame to sFile (see olcFrameRecording.h), to be
+	// replayed with olcFramePlayer or the olcCGE_replay tool. Dropped frames
+	// are never presented, so they are not recorded either. When the disk
+	// falls behind, the present policy also decides what happens to frames
+	// the recording has no room for. Call after ConstructConsole().
+	bool     StartRecording(const std::wstring &sFile);
+	void     StopRecording();
+	// Frames the current recording has left out to keep up
+	uint64_t RecordingFramesDropped();
+
+	// Number of screen buffers (1 presents on the game thread, 2 or 3 hand
+	// finished frames to a presenter thread) and what to do when all of them
+	// are in use. Call before Start().
+	void     SetPresentMode(int nBuffers, PRESENT_POLICY policy = PRESENT_BLOCK);
+	uint64_t FramesDropped() const { return m_nFramesDropped; }
+
+	// Pace the loop to fFps frames per second (0 runs flat out, the default).
+	// Idle time is slept away, input keeps arriving on its own thread. Takes
+	// effect from the next frame, also when called from OnUserUpdate().
+	void  SetTargetFPS(float fFps);
+	// Call OnUserUpdate() with this fixed step instead of the frame time (0
+	// turns it off). Without a target FPS frames are paced to the step.
+	void  SetFixedTimestep(float fStep);
+	// How far between the last fixed update and the next one this frame is
+	float GetInterpolationAlpha() const { return m_scheduler.Alpha(); }
+	// Mean/worst deviation from the target frame time over the last second
+	float GetFrameJitter() const        { return m_scheduler.Jitter(); }
+	float GetFrameJitterMax() const     { return m_scheduler.JitterMax(); }
+
 	void Start();
 
+	// Run the game from the caller's own loop instead of Start(), e.g. for
+	// simulations (see olcEngineBatch). BeginStepping() calls OnUserCreate(),
+	// then each Step() runs one update of fElapsedTime seconds and presents
+	// the frame, all on the calling thread. No presenter or input thread is
+	// started, feed input in with InjectInput(). Both return false once the
+	// game has ended.
+	bool BeginStepping();
+	bool Step(float fElapsedTime);
+
 	// User MUST OVERRIDE THESE!!
 	virtual bool OnUserCreate() = 0;
 	virtual bool OnUserUpdate(float fElapsedTime) = 0;
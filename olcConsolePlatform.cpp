@@ -0,0 +1,27 @@
+//-----------------------------------------------------------------------------
+#include "olcConsolePlatform.h"
+
+#include <cwchar>
+#include <string>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+//-----------------------------------------------------------------------------
+
+int olcReportError(const wchar_t *msg)
+{
+#ifdef _WIN32
+	wchar_t buf[256];
+	FormatMessageW(FORMAT_MESSAGE_FROM_SYSTEM, NULL, GetLastError(), MAKELANGID(LANG_NEUTRAL, SUBLANG_DEFAULT), buf, 256, NULL);
+	wprintf(L"[ERROR] %ls: %ls\n", msg, buf);
+
+	std::wstring txt(msg);
+	txt += std::wstring(L":\n") + std::wstring(buf);
+	MessageBoxW(NULL, txt.c_str(), L"OLC Console Game Engine Error", MB_OK | MB_ICONERROR);
+#else
+	fwprintf(stderr, L"[ERROR] %ls\n", msg);
+#endif
+	return -1;
+}
+//-----------------------------------------------------------------------------
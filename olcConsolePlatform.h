@@ -0,0 +1,16 @@
+//---------------------------------------------------------------------------//
+//  Platform glue for the console game engine.
+//
+//  The engine itself only uses its own cell types (see olcCellBuffer.h), so
+//  none of its headers pull in <windows.h>; the Win32 specific parts live in
+//  translation units and in olcWin32Backend.h.
+//---------------------------------------------------------------------------//
+
+//-----------------------------------------------------------------------------
+#pragma once
+//-----------------------------------------------------------------------------
+
+// Report an error to the user. On Windows the last system error is appended
+// to the message and shown in a message box. Always returns -1.
+int olcReportError(const wchar_t *msg);
+//-----------------------------------------------------------------------------
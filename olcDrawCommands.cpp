@@ -0,0 +1,60 @@
+//-----------------------------------------------------------------------------
+#include "olcDrawCommands.h"
+//-----------------------------------------------------------------------------
+
+void olcDrawCommandBuffer::Resize(int nScreenWidth, int nScreenHeight)
+{
+	m_nTilesX = (nScreenWidth  + TILE_WIDTH  - 1) / TILE_WIDTH;
+	m_nTilesY = (nScreenHeight + TILE_HEIGHT - 1) / TILE_HEIGHT;
+	m_vecTiles.assign(size_t(m_nTilesX * m_nTilesY), std::vector<uint32_t>());
+	Clear();
+}
+//-----------------------------------------------------------------------------
+
+int olcDrawCommandBuffer::AddText(std::wstring_view s)
+{
+	int nOffset = int(m_vecText.size());
+	m_vecText.insert(m_vecText.end(), s.begin(), s.end());
+	return nOffset;
+}
+//-----------------------------------------------------------------------------
+
+int olcDrawCommandBuffer::AddPoints(const sRasterPoint *pPoints, int nPoints)
+{
+	int nOffset = int(m_vecPoints.size());
+	m_vecPoints.insert(m_vecPoints.end(), pPoints, pPoints + nPoints);
+	return nOffset;
+}
+//-----------------------------------------------------------------------------
+
+void olcDrawCommandBuffer::Clear()
+{
+	m_vecCommands.clear();
+	m_vecText.clear();
+	m_vecPoints.clear();
+	m_vecTransforms.clear();
+	for(std::vector<uint32_t> &tile : m_vecTiles)
+		tile.clear();
+}
+//-----------------------------------------------------------------------------
+
+void olcDrawCommandBuffer::Bin()
+{
+	for(std::vector<uint32_t> &tile : m_vecTiles)
+		tile.clear();
+
+	//-- Commands are visited in recording order, so every tile list comes
+	//   out in painter's order
+	for(uint32_t i = 0; i < uint32_t(m_vecCommands.size()); ++i)
+	{
+		const sDrawCommand &cmd = m_vecCommands[i];
+		int tx1 = cmd.bx1 / TILE_WIDTH;
+		int ty1 = cmd.by1 / TILE_HEIGHT;
+		int tx2 = (cmd.bx2 - 1) / TILE_WIDTH;
+		int ty2 = (cmd.by2 - 1) / TILE_HEIGHT;
+		for(int ty = ty1; ty <= ty2; ++ty)
+			for(int tx = tx1; tx <= tx2; ++tx)
+				m_vecTiles[size_t(ty * m_nTilesX + tx)].push_back(i);
+	}
+}
+//-----------------------------------------------------------------------------
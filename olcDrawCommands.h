@@ -0,0 +1,103 @@
+//---------------------------------------------------------------------------//
+//  Draw command buffer.
+//
+//  In deferred mode the engine's drawing calls are recorded here instead of
+//  being executed. At frame end the commands are binned into screen tiles:
+//  every tile gets the list of commands whose bounds touch it, in the order
+//  they were recorded. Tiles never share cells, so each one can then be
+//  drawn by a different thread without locks while painter's order holds
+//  within it.
+//---------------------------------------------------------------------------//
+
+//-----------------------------------------------------------------------------
+#pragma once
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+//-----------------------------------------------------------------------------
+#include "olcRasterizer.h"
+#include "olcTransform2D.h"
+//-----------------------------------------------------------------------------
+
+enum DRAW_COMMAND
+{
+	DRAW_POINT,
+	DRAW_FILL,
+	DRAW_LINE,
+	DRAW_STRING,
+	DRAW_STRING_ALPHA,
+	DRAW_SPRITE,
+	DRAW_COMPILED_SPRITE,
+	DRAW_CIRCLE,
+	DRAW_FILL_CIRCLE,
+	DRAW_FILL_TRIANGLE,
+	DRAW_FILL_POLYGON,
+	DRAW_SPRITE_TRANSFORMED,
+};
+//-----------------------------------------------------------------------------
+
+struct sDrawCommand
+{
+	// Cells the command may touch, already clipped to the screen (x2/y2
+	// exclusive)
+	int16_t     bx1, by1, bx2, by2;
+	uint8_t     nType;
+	short       col;
+	wchar_t     c;
+	// POINT: (x1, y1). FILL, LINE: (x1, y1) - (x2, y2).
+	// STRING: at (x1, y1), x2 characters from the text buffer at ox.
+	// SPRITE: at (x1, y1), the x2 by y2 block of pSprite at (ox, oy).
+	// CIRCLE: centre (x1, y1), radius x2.
+	// TRIANGLE: (x1, y1), (x2, y2), (ox, oy).
+	// POLYGON: x2 points from the point buffer at ox.
+	// SPRITE_TRANSFORMED: pSprite through the transform at ox.
+	int         x1, y1, x2, y2;
+	int         ox, oy;
+	const void* pSprite;
+};
+//-----------------------------------------------------------------------------
+
+class olcDrawCommandBuffer
+{
+public:
+	static const int TILE_WIDTH  = 64;
+	static const int TILE_HEIGHT = 16;
+
+private:
+	std::vector<sDrawCommand>          m_vecCommands;
+	std::vector<wchar_t>               m_vecText;
+	std::vector<sRasterPoint>          m_vecPoints;
+	std::vector<olcTransform2D>        m_vecTransforms;
+	std::vector<std::vector<uint32_t>> m_vecTiles;
+	int                                m_nTilesX = 0;
+	int                                m_nTilesY = 0;
+
+public:
+	// Size the tile grid for a screen, dropping anything recorded
+	void Resize(int nScreenWidth, int nScreenHeight);
+
+	void Add(const sDrawCommand &cmd) { m_vecCommands.push_back(cmd); }
+	// Keep a copy of a string for a STRING command, returns its offset
+	int  AddText(std::wstring_view s);
+	// Same for the points of a POLYGON command
+	int  AddPoints(const sRasterPoint *pPoints, int nPoints);
+	int  AddTransform(const olcTransform2D &t) { m_vecTransforms.push_back(t); return int(m_vecTransforms.size()) - 1; }
+
+	bool Empty() const { return m_vecCommands.empty(); }
+	void Clear();
+
+	// Fill in the per tile command lists
+	void Bin();
+
+	int  TilesX() const { return m_nTilesX; }
+	int  TilesY() const { return m_nTilesY; }
+	int  Tiles() const  { return m_nTilesX * m_nTilesY; }
+	const std::vector<uint32_t>& Tile(int t) const      { return m_vecTiles[t]; }
+	const sDrawCommand&          Command(uint32_t i) const { return m_vecCommands[i]; }
+	const wchar_t*               Text(int nOffset) const  { return m_vecText.data() + nOffset; }
+	const sRasterPoint*          Points(int nOffset) const { return m_vecPoints.data() + nOffset; }
+	const olcTransform2D&        Transform(int i) const   { return m_vecTransforms[i]; }
+};
+//-----------------------------------------------------------------------------
@@ -0,0 +1,133 @@
+//-----------------------------------------------------------------------------
+#include "olcEngineBatch.h"
+
+#include <cstring>
+//-----------------------------------------------------------------------------
+
+const int olcEngineBatch::KEYS;
+//-----------------------------------------------------------------------------
+
+bool olcEngineBatch::Create(int nInstances, int nWidth, int nHeight,
+                            const std::function<std::unique_ptr<olcConsoleGameEngine>(int)> &fnCreate, int nWorkers)
+{
+	Destroy();
+	if(nInstances <= 0 || nWidth <= 0 || nHeight <= 0)
+		return false;
+
+	for(int i = 0; i < nInstances; ++i)
+	{
+		std::unique_ptr<olcConsoleGameEngine> pInstance = fnCreate(i);
+		if(!pInstance)
+		{
+			Destroy();
+			return false;
+		}
+		pInstance->SetRenderBackend(std::unique_ptr<olcRenderBackend>(new olcHeadlessBackend()));
+		if(pInstance->ConstructConsole(nWidth, nHeight) < 0)
+		{
+			Destroy();
+			return false;
+		}
+		m_vecInstances.push_back(std::move(pInstance));
+	}
+
+	m_nWidth  = nWidth;
+	m_nHeight = nHeight;
+	size_t nCells = size_t(nWidth) * size_t(nHeight) * size_t(nInstances);
+	m_vecGlyphs.assign(nCells, L' ');
+	m_vecAttributes.assign(nCells, 0);
+	m_vecKeys.assign(size_t(KEYS) * size_t(nInstances), 0);
+	m_vecKeyInput.assign(size_t(KEYS) * size_t(nInstances), 0);
+	m_vecKeySent.assign(size_t(KEYS) * size_t(nInstances), 0);
+	m_vecActive.assign(size_t(nInstances), 0);
+
+	//-- OnUserCreate() may load a level, so it runs on the pool too
+	m_pool.Start(nWorkers);
+	m_pool.Run(nInstances, [&](int i)
+	{
+		m_vecActive[size_t(i)] = m_vecInstances[size_t(i)]->BeginStepping();
+		Gather(i);
+	});
+	return true;
+}
+//-----------------------------------------------------------------------------
+
+void olcEngineBatch::Destroy()
+{
+	m_pool.Stop();
+	m_vecInstances.clear();
+	m_vecActive.clear();
+	m_vecGlyphs.clear();
+	m_vecAttributes.clear();
+	m_vecKeys.clear();
+	m_vecKeyInput.clear();
+	m_vecKeySent.clear();
+	m_nWidth = m_nHeight = 0;
+}
+//-----------------------------------------------------------------------------
+
+void olcEngineBatch::Gather(int i)
+{
+	const olcConsoleGameEngine &e = *m_vecInstances[size_t(i)];
+	size_t nCells = size_t(m_nWidth) * size_t(m_nHeight);
+	memcpy(m_vecGlyphs.data()     + size_t(i) * nCells, e.m_bufScreen->Glyphs(),     nCells * sizeof(wchar_t));
+	memcpy(m_vecAttributes.data() + size_t(i) * nCells, e.m_bufScreen->Attributes(), nCells);
+
+	uint8_t *pKeys = m_vecKeys.data() + size_t(i) * KEYS;
+	for(int k = 0; k < KEYS; ++k)
+		pKeys[k] = uint8_t((e.m_keys[k].bPressed  ? BATCH_KEY_PRESSED  : 0) |
+		                   (e.m_keys[k].bReleased ? BATCH_KEY_RELEASED : 0) |
+		                   (e.m_keys[k].bHeld     ? BATCH_KEY_HELD     : 0));
+}
+//-----------------------------------------------------------------------------
+
+void olcEngineBatch::StepInstance(int i, float fElapsedTime)
+{
+	if(!m_vecActive[size_t(i)])
+		return;
+	olcConsoleGameEngine &e = *m_vecInstances[size_t(i)];
+
+	//-- A key event for every held flag that changed since the last step
+	const uint8_t *pInput = m_vecKeyInput.data() + size_t(i) * KEYS;
+	uint8_t       *pSent  = m_vecKeySent.data()  + size_t(i) * KEYS;
+	for(int k = 0; k < KEYS; ++k)
+	{
+		uint8_t bHeld = pInput[k] != 0;
+		if(bHeld == pSent[k])
+			continue;
+		olcInputEvent event;
+		event.tpTime = std::chrono::steady_clock::now();
+		event.nType  = bHeld ? INPUT_KEY_DOWN : INPUT_KEY_UP;
+		event.nKey   = k;
+		event.x      = 0;
+		event.y      = 0;
+		if(e.InjectInput(event))
+			pSent[k] = bHeld;
+	}
+
+	m_vecActive[size_t(i)] = e.Step(fElapsedTime);
+	Gather(i);
+}
+//-----------------------------------------------------------------------------
+
+int olcEngineBatch::Step(float fElapsedTime)
+{
+	m_pool.Run(Instances(), [&](int i) { StepInstance(i, fElapsedTime); });
+
+	int nActive = 0;
+	for(uint8_t bActive : m_vecActive)
+		nActive += bActive;
+	return nActive;
+}
+//-----------------------------------------------------------------------------
+
+int olcEngineBatch::Step(const float *pElapsedTimes)
+{
+	m_pool.Run(Instances(), [&](int i) { StepInstance(i, pElapsedTimes[i]); });
+
+	int nActive = 0;
+	for(uint8_t bActive : m_vecActive)
+		nActive += bActive;
+	return nActive;
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,94 @@
+//---------------------------------------------------------------------------//
+//  Batched instances.
+//
+//  olcEngineBatch runs many headless games in one process, e.g. for
+//  simulations or training bots. It creates the instances, steps every one
+//  still running with a time step of the caller's choosing, and gathers
+//  their screens and key states into contiguous arrays, instance after
+//  instance, for reading out in bulk.
+//
+//  Instances are stepped in parallel on an olcWorkerPool. Workers take the
+//  next instance from a shared counter, so one that takes longer to step
+//  only holds up its own worker, and the others carry on with the rest.
+//  Each worker copies out the screen and keys of the instances it stepped.
+//
+//  Input goes the other way through KeyInput(), a held flag per key and
+//  instance: before every step, each flag that changed is sent to its
+//  instance as a key down or key up event.
+//---------------------------------------------------------------------------//
+
+//-----------------------------------------------------------------------------
+#pragma once
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+//-----------------------------------------------------------------------------
+#include "olcConsoleGameEngine.h"
+//-----------------------------------------------------------------------------
+
+// Flags of each entry of olcEngineBatch::Keys()
+enum BATCH_KEY
+{
+	BATCH_KEY_PRESSED  = 0x01,
+	BATCH_KEY_RELEASED = 0x02,
+	BATCH_KEY_HELD     = 0x04,
+};
+//-----------------------------------------------------------------------------
+
+class olcEngineBatch
+{
+public:
+	static const int KEYS = 256;
+
+private:
+	std::vector<std::unique_ptr<olcConsoleGameEngine>> m_vecInstances;
+	std::vector<uint8_t> m_vecActive;
+	int                  m_nWidth  = 0;
+	int                  m_nHeight = 0;
+	std::vector<wchar_t> m_vecGlyphs;
+	std::vector<uint8_t> m_vecAttributes;
+	std::vector<uint8_t> m_vecKeys;
+	std::vector<uint8_t> m_vecKeyInput;
+	std::vector<uint8_t> m_vecKeySent;		// the held flags sent so far
+	olcWorkerPool        m_pool;
+
+	void StepInstance(int i, float fElapsedTime);
+	void Gather(int i);
+
+public:
+	olcEngineBatch() {}
+	~olcEngineBatch() { Destroy(); }
+	olcEngineBatch(const olcEngineBatch&) = delete;
+	olcEngineBatch& operator=(const olcEngineBatch&) = delete;
+
+	// Create nInstances games with fnCreate(i), give each a headless
+	// nWidth x nHeight console and call their OnUserCreate(). Stepped on
+	// nWorkers threads besides the caller (negative uses all cores).
+	bool Create(int nInstances, int nWidth, int nHeight,
+	            const std::function<std::unique_ptr<olcConsoleGameEngine>(int)> &fnCreate, int nWorkers = -1);
+	void Destroy();
+
+	int  Instances() const { return int(m_vecInstances.size()); }
+	int  Width() const     { return m_nWidth;  }
+	int  Height() const    { return m_nHeight; }
+	olcConsoleGameEngine* Instance(int i) { return m_vecInstances[size_t(i)].get(); }
+	// False once the game has ended, it is not stepped any more
+	bool Active(int i) const { return m_vecActive[size_t(i)] != 0; }
+
+	// Step every active instance once, by the same time or by its own entry
+	// of pElapsedTimes. Returns how many are still active.
+	int  Step(float fElapsedTime);
+	int  Step(const float *pElapsedTimes);
+
+	// The screens after the last step, Width() * Height() cells per
+	// instance, row by row
+	const wchar_t* Glyphs() const     { return m_vecGlyphs.data();     }
+	const uint8_t* Attributes() const { return m_vecAttributes.data(); }
+	// The keys as the last update saw them, KEYS BATCH_KEY flags per instance
+	const uint8_t* Keys() const       { return m_vecKeys.data(); }
+	// Held flags to send before the next step, KEYS per instance
+	uint8_t*       KeyInput()         { return m_vecKeyInput.data(); }
+};
+//-----------------------------------------------------------------------------
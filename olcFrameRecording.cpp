@@ -0,0 +1,485 @@
+//-----------------------------------------------------------------------------
+#include "olcFrameRecording.h"
+#include "olcConsoleGameEngine.h"
+
+#include <algorithm>
+#include <cstring>
+//-----------------------------------------------------------------------------
+
+enum RECORD_FRAME
+{
+	RECORD_KEYFRAME = 0,
+	RECORD_DELTA    = 1,
+};
+
+// Shortest repeat worth coding as a run rather than as literals
+static const int RECORD_MIN_REPEAT = 3;
+//-----------------------------------------------------------------------------
+
+static inline bool SameCell(const olcCellBuffer &a, size_t i, const olcCellBuffer &b, size_t j)
+{
+	return a.Glyphs()[i] == b.Glyphs()[j] && a.Attributes()[i] == b.Attributes()[j];
+}
+//-----------------------------------------------------------------------------
+
+static void PutVarint(std::vector<uint8_t> &out, uint64_t n)
+{
+	while(n >= 0x80)
+	{
+		out.push_back(uint8_t(n | 0x80));
+		n >>= 7;
+	}
+	out.push_back(uint8_t(n));
+}
+//-----------------------------------------------------------------------------
+
+static bool GetVarint(const uint8_t *&p, const uint8_t *pEnd, uint64_t &n)
+{
+	n = 0;
+	for(int nShift = 0; p < pEnd && nShift < 64; nShift += 7)
+	{
+		uint8_t b = *p++;
+		n |= uint64_t(b & 0x7F) << nShift;
+		if((b & 0x80) == 0)
+			return true;
+	}
+	return false;
+}
+//-----------------------------------------------------------------------------
+
+static void PutCell(std::vector<uint8_t> &out, const olcCellBuffer &buf, size_t i)
+{
+	PutVarint(out, uint32_t(buf.Glyphs()[i]));
+	out.push_back(buf.Attributes()[i]);
+}
+//-----------------------------------------------------------------------------
+
+static bool GetCell(const uint8_t *&p, const uint8_t *pEnd, wchar_t &c, uint8_t &attr)
+{
+	uint64_t n;
+	if(!GetVarint(p, pEnd, n) || pEnd - p < 1)
+		return false;
+	c    = wchar_t(n);
+	attr = *p++;
+	return true;
+}
+//-----------------------------------------------------------------------------
+
+static void PutU32(std::vector<uint8_t> &out, uint32_t n)
+{
+	for(int i = 0; i < 4; ++i)
+		out.push_back(uint8_t(n >> (8 * i)));
+}
+//-----------------------------------------------------------------------------
+
+static uint64_t GetLE(const uint8_t *p, int nBytes)
+{
+	uint64_t n = 0;
+	for(int i = 0; i < nBytes; ++i)
+		n |= uint64_t(p[i]) << (8 * i);
+	return n;
+}
+//-----------------------------------------------------------------------------
+
+// Code the cells of cur that differ from prev (all of them against nullptr)
+static void EncodeFrame(const olcCellBuffer *prev, const olcCellBuffer &cur, std::vector<uint8_t> &out)
+{
+	auto changed = [&](size_t i)
+	{
+		return prev ? !SameCell(*prev, i, cur, i) : cur.Glyphs()[i] != 0 || cur.Attributes()[i] != 0;
+	};
+
+	//-- Unchanged rows are ruled out a plane at a time
+	const size_t nWidth = size_t(cur.Width());
+	auto rowChanged = [&](size_t y)
+	{
+		size_t nAt = y * nWidth;
+		if(prev == nullptr)
+			return true;
+		return memcmp(prev->Glyphs() + nAt, cur.Glyphs() + nAt, nWidth * sizeof(wchar_t)) != 0 ||
+		       memcmp(prev->Attributes() + nAt, cur.Attributes() + nAt, nWidth) != 0;
+	};
+
+	const size_t n = cur.Size();
+	size_t nLast = 0;
+	size_t i     = 0;
+	while(i < n)
+	{
+		if(i % nWidth == 0 && !rowChanged(i / nWidth))
+		{
+			i += nWidth;
+			continue;
+		}
+		if(!changed(i))
+		{
+			++i;
+			continue;
+		}
+
+		//-- A changed run, cut into repeats and literal stretches
+		size_t nEnd = i;
+		while(nEnd < n && changed(nEnd))
+			++nEnd;
+
+		while(i < nEnd)
+		{
+			size_t nRepeat = 1;
+			while(i + nRepeat < nEnd && SameCell(cur, i + nRepeat, cur, i))
+				++nRepeat;
+
+			if(nRepeat >= RECORD_MIN_REPEAT)
+			{
+				PutVarint(out, uint64_t(i - nLast));
+				PutVarint(out, (uint64_t(nRepeat) << 1) | 1);
+				PutCell(out, cur, i);
+				i += nRepeat;
+			}
+			else
+			{
+				//-- Literals up to the next repeat worth its own op
+				size_t j = i;
+				while(j < nEnd)
+				{
+					size_t r = 1;
+					while(j + r < nEnd && r < RECORD_MIN_REPEAT && SameCell(cur, j + r, cur, j))
+						++r;
+					if(r >= RECORD_MIN_REPEAT)
+						break;
+					j += r;
+				}
+				PutVarint(out, uint64_t(i - nLast));
+				PutVarint(out, uint64_t(j - i) << 1);
+				for(size_t k = i; k < j; ++k)
+					PutCell(out, cur, k);
+				i = j;
+			}
+			nLast = i;
+		}
+	}
+
+	//-- An empty op ends the frame
+	PutVarint(out, 0);
+	PutVarint(out, 0);
+}
+//-----------------------------------------------------------------------------
+
+olcFrameRecorder::~olcFrameRecorder()
+{
+	Close();
+}
+//-----------------------------------------------------------------------------
+
+bool olcFrameRecorder::Open(const std::wstring &sFile, int nWidth, int nHeight, PRESENT_POLICY policy, int nMaxQueued)
+{
+	Close();
+	if(nWidth <= 0 || nHeight <= 0)
+		return false;
+
+	m_file.open(WS2S(sFile).c_str(), std::ios_base::binary);
+	if(!m_file.is_open())
+		return false;
+
+	std::vector<uint8_t> header;
+	header.insert(header.end(), { 'O', 'L', 'C', 'R' });
+	header.push_back(uint8_t(VERSION));
+	header.push_back(uint8_t(VERSION >> 8));
+	header.push_back(0);
+	header.push_back(0);
+	PutU32(header, uint32_t(nWidth));
+	PutU32(header, uint32_t(nHeight));
+	m_file.write((const char*)header.data(), std::streamsize(header.size()));
+
+	m_nWidth  = nWidth;
+	m_nHeight = nHeight;
+	m_tpStart = std::chrono::steady_clock::now();
+	m_nPolicy = policy;
+	m_nMaxQueued     = size_t(nMaxQueued > 0 ? nMaxQueued : 1);
+	m_nFramesDropped = 0;
+	m_bQuit   = false;
+	m_bFailed = !m_file.good();
+	m_threadWriter = std::thread(&olcFrameRecorder::WriterThread, this);
+	return !m_bFailed;
+}
+//-----------------------------------------------------------------------------
+
+void olcFrameRecorder::Close()
+{
+	if(m_threadWriter.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lck(m_mux);
+			m_bQuit = true;
+		}
+		m_cv.notify_one();
+		m_threadWriter.join();
+	}
+	if(m_file.is_open())
+		m_file.close();
+	m_queue.clear();
+	m_vecFree.clear();
+}
+//-----------------------------------------------------------------------------
+
+bool olcFrameRecorder::Good()
+{
+	std::lock_guard<std::mutex> lck(m_mux);
+	return !m_bFailed;
+}
+//-----------------------------------------------------------------------------
+
+uint64_t olcFrameRecorder::FramesDropped()
+{
+	std::lock_guard<std::mutex> lck(m_mux);
+	return m_nFramesDropped;
+}
+//-----------------------------------------------------------------------------
+
+void olcFrameRecorder::Capture(const olcCellBuffer &buf)
+{
+	if(!IsOpen() || buf.Width() != m_nWidth || buf.Height() != m_nHeight)
+		return;
+
+	uint64_t nTimeUs = uint64_t(std::chrono::duration_cast<std::chrono::microseconds>(
+		std::chrono::steady_clock::now() - m_tpStart).count());
+
+	//-- Copy into a recycled buffer. With the queue full, wait for the
+	//   writer, give up this frame or take back the oldest one waiting.
+	sCapture capture;
+	{
+		std::unique_lock<std::mutex> lck(m_mux);
+		if(m_queue.size() >= m_nMaxQueued)
+		{
+			switch(m_nPolicy)
+			{
+			case PRESENT_BLOCK:
+				m_cvSpace.wait(lck, [this] { return m_queue.size() < m_nMaxQueued; });
+				break;
+			case PRESENT_DROP_NEWEST:
+				++m_nFramesDropped;
+				return;
+			case PRESENT_DROP_OLDEST:
+				capture = std::move(m_queue.front());
+				m_queue.pop_front();
+				++m_nFramesDropped;
+				break;
+			}
+		}
+		if(capture.cells.Size() == 0 && !m_vecFree.empty())
+		{
+			capture = std::move(m_vecFree.back());
+			m_vecFree.pop_back();
+		}
+	}
+	capture.cells = buf;
+	capture.nTimeUs = nTimeUs;
+
+	{
+		std::lock_guard<std::mutex> lck(m_mux);
+		m_queue.push_back(std::move(capture));
+	}
+	m_cv.notify_one();
+}
+//-----------------------------------------------------------------------------
+
+void olcFrameRecorder::WriterThread()
+{
+	olcCellBuffer          prev;
+	std::vector<uint8_t>   vecOut;
+	uint64_t               nFrame = 0;
+
+	std::unique_lock<std::mutex> lck(m_mux);
+	while(true)
+	{
+		m_cv.wait(lck, [this] { return m_bQuit || !m_queue.empty(); });
+		if(m_queue.empty())
+			break;
+
+		sCapture capture = std::move(m_queue.front());
+		m_queue.pop_front();
+		lck.unlock();
+		m_cvSpace.notify_one();
+
+		//-- Frame header, then the cells
+		bool bKeyframe = nFrame % KEYFRAME_INTERVAL == 0;
+		vecOut.assign(16, 0);
+		EncodeFrame(bKeyframe ? nullptr : &prev, capture.cells, vecOut);
+
+		uint32_t nPayload = uint32_t(vecOut.size() - 16);
+		for(int i = 0; i < 4; ++i)
+			vecOut[size_t(i)] = uint8_t(nPayload >> (8 * i));
+		vecOut[4] = uint8_t(bKeyframe ? RECORD_KEYFRAME : RECORD_DELTA);
+		for(int i = 0; i < 8; ++i)
+			vecOut[size_t(8 + i)] = uint8_t(capture.nTimeUs >> (8 * i));
+
+		m_file.write((const char*)vecOut.data(), std::streamsize(vecOut.size()));
+		bool bGood = m_file.good();
+		std::swap(prev, capture.cells);
+		++nFrame;
+
+		lck.lock();
+		m_bFailed |= !bGood;
+		m_vecFree.push_back(std::move(capture));
+	}
+	lck.unlock();
+	m_file.flush();
+}
+//-----------------------------------------------------------------------------
+
+bool olcFramePlayer::Open(const std::wstring &sFile)
+{
+	m_file.close();
+	m_file.clear();
+	m_file.open(WS2S(sFile).c_str(), std::ios_base::binary);
+	if(!m_file.is_open())
+		return false;
+
+	uint8_t header[16];
+	if(!m_file.read((char*)header, sizeof(header)) || memcmp(header, "OLCR", 4) != 0 ||
+	   GetLE(header + 4, 2) != olcFrameRecorder::VERSION)
+		return false;
+
+	m_nWidth  = int(GetLE(header + 8, 4));
+	m_nHeight = int(GetLE(header + 12, 4));
+	if(m_nWidth <= 0 || m_nHeight <= 0 || m_nWidth > 0x7FFF || m_nHeight > 0x7FFF)
+		return false;
+
+	m_cells.Resize(m_nWidth, m_nHeight);
+	m_nFrame = 0;
+	return true;
+}
+//-----------------------------------------------------------------------------
+
+bool olcFramePlayer::NextFrame()
+{
+	uint8_t header[16];
+	if(!m_file.read((char*)header, sizeof(header)))
+		return false;
+
+	uint32_t nPayload = uint32_t(GetLE(header, 4));
+	m_bKeyframe = header[4] == RECORD_KEYFRAME;
+	m_nTimeUs   = GetLE(header + 8, 8);
+
+	m_vecPayload.resize(nPayload);
+	if(!m_file.read((char*)m_vecPayload.data(), std::streamsize(nPayload)))
+		return false;
+
+	if(!Decode())
+		return false;
+	++m_nFrame;
+	return true;
+}
+//-----------------------------------------------------------------------------
+
+bool olcFramePlayer::Decode()
+{
+	if(m_bKeyframe)
+		m_cells.Resize(m_nWidth, m_nHeight);
+
+	//-- Apply the ops, noting the changed span of every row
+	std::vector<std::pair<int, int>> vecRows(size_t(m_nHeight), { m_nWidth, 0 });
+	auto mark = [&](int a, int b)
+	{
+		for(int y = a / m_nWidth; y <= (b - 1) / m_nWidth; ++y)
+		{
+			int x1 = std::max(a - y * m_nWidth, 0);
+			int x2 = std::min(b - y * m_nWidth, m_nWidth);
+			vecRows[size_t(y)].first  = std::min(vecRows[size_t(y)].first, x1);
+			vecRows[size_t(y)].second = std::max(vecRows[size_t(y)].second, x2);
+		}
+	};
+
+	const uint8_t *p    = m_vecPayload.data();
+	const uint8_t *pEnd = p + m_vecPayload.size();
+	size_t         nAt  = 0;
+	size_t         nCells = m_cells.Size();
+	wchar_t       *glyphs = m_cells.Glyphs();
+	uint8_t       *attrs  = m_cells.Attributes();
+	while(true)
+	{
+		uint64_t nSkip, nOp;
+		if(!GetVarint(p, pEnd, nSkip) || !GetVarint(p, pEnd, nOp))
+			return false;
+		uint64_t nLength = nOp >> 1;
+		if(nLength == 0)
+			break;
+		if(nSkip > nCells - nAt || nLength > nCells - nAt - nSkip)
+			return false;
+		nAt += size_t(nSkip);
+
+		if(nOp & 1)
+		{
+			wchar_t c;
+			uint8_t attr;
+			if(!GetCell(p, pEnd, c, attr))
+				return false;
+			std::fill_n(glyphs + nAt, size_t(nLength), c);
+			memset(attrs + nAt, attr, size_t(nLength));
+		}
+		else
+		{
+			for(size_t k = nAt; k < nAt + size_t(nLength); ++k)
+				if(!GetCell(p, pEnd, glyphs[k], attrs[k]))
+					return false;
+		}
+		mark(int(nAt), int(nAt + nLength));
+		nAt += size_t(nLength);
+	}
+
+	m_vecRegions.clear();
+	if(m_bKeyframe)
+	{
+		m_vecRegions.push_back({ 0, 0, short(m_nWidth - 1), short(m_nHeight - 1) });
+		return true;
+	}
+	for(int y = 0; y < m_nHeight; ++y)
+		if(vecRows[size_t(y)].first < vecRows[size_t(y)].second)
+			m_vecRegions.push_back({ short(vecRows[size_t(y)].first), short(y),
+			                         short(vecRows[size_t(y)].second - 1), short(y) });
+	return true;
+}
+//-----------------------------------------------------------------------------
+
+long long olcFramePlayer::Play(olcRenderBackend &backend, bool bRealtime)
+{
+	int nWidth = m_nWidth, nHeight = m_nHeight;
+	if(backend.Construct(nWidth, nHeight, 8, 8) < 0)
+		return -1;
+
+	//-- A backend smaller than the recording gets the top left of it
+	std::vector<sCellRect> vecClipped;
+	olcCellBuffer          view;
+	std::chrono::steady_clock::time_point tpStart = std::chrono::steady_clock::now();
+	long long nFrames = 0;
+	while(NextFrame())
+	{
+		if(bRealtime)
+			std::this_thread::sleep_until(tpStart + std::chrono::microseconds(m_nTimeUs));
+
+		vecClipped.clear();
+		for(sCellRect r : m_vecRegions)
+		{
+			r.Right  = std::min<short>(r.Right,  short(nWidth - 1));
+			r.Bottom = std::min<short>(r.Bottom, short(nHeight - 1));
+			if(r.Left <= r.Right && r.Top <= r.Bottom)
+				vecClipped.push_back(r);
+		}
+
+		if(nWidth == m_nWidth && nHeight == m_nHeight)
+			backend.Present(m_cells, vecClipped.data(), int(vecClipped.size()));
+		else
+		{
+			if(view.Width() != nWidth || view.Height() != nHeight)
+				view.Resize(nWidth, nHeight);
+			for(int y = 0; y < nHeight; ++y)
+			{
+				size_t nSrc = size_t(y) * size_t(m_nWidth), nDst = size_t(y) * size_t(nWidth);
+				memcpy(view.Glyphs() + nDst, m_cells.Glyphs() + nSrc, sizeof(wchar_t) * size_t(nWidth));
+				memcpy(view.Attributes() + nDst, m_cells.Attributes() + nSrc, size_t(nWidth));
+			}
+			backend.Present(view, vecClipped.data(), int(vecClipped.size()));
+		}
+		++nFrames;
+	}
+	return nFrames;
+}
+//-----------------------------------------------------------------------------
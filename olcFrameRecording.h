@@ -0,0 +1,134 @@
+//---------------------------------------------------------------------------//
+//  Frame recording and replay.
+//
+//  A recording holds every presented frame of a session:
+//
+//    header              magic "OLCR", version, width, height
+//    frames              size, type, microseconds since the recording began,
+//                        then the cells that changed
+//
+//  The first frame (and every KEYFRAME_INTERVAL-th after it) is a keyframe,
+//  coded against an all zero screen; the others against the frame before.
+//  Changed cells are coded as ops: cells to skip, then either a run of one
+//  repeated cell or a run of literal cells. A cell is its glyph as a varint
+//  (so plain text costs a byte per glyph and the file does not depend on
+//  wchar_t) and its attribute byte.
+//
+//  olcFrameRecorder only copies the frame on the calling thread; diffing,
+//  coding and writing happen on its writer thread. At most a few frames wait
+//  for the writer; when the disk falls further behind, a PRESENT_POLICY
+//  decides whether the caller waits or frames are left out (and counted). olcFramePlayer streams a
+//  recording back, frame by frame or straight into a render backend.
+//---------------------------------------------------------------------------//
+
+//-----------------------------------------------------------------------------
+#pragma once
+//-----------------------------------------------------------------------------
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+//-----------------------------------------------------------------------------
+#include "olcRenderBackend.h"
+//-----------------------------------------------------------------------------
+
+class olcFrameRecorder
+{
+public:
+	static const uint16_t VERSION            = 2;
+	static const int      KEYFRAME_INTERVAL  = 600;
+
+private:
+	struct sCapture
+	{
+		olcCellBuffer          cells;
+		uint64_t               nTimeUs;
+	};
+
+	std::ofstream              m_file;
+	int                        m_nWidth  = 0;
+	int                        m_nHeight = 0;
+	std::chrono::steady_clock::time_point m_tpStart;
+
+	std::thread                m_threadWriter;
+	std::mutex                 m_mux;
+	std::condition_variable    m_cv;
+	std::condition_variable    m_cvSpace;
+	std::deque<sCapture>       m_queue;
+	std::vector<sCapture>      m_vecFree;
+	size_t                     m_nMaxQueued = 8;
+	PRESENT_POLICY             m_nPolicy    = PRESENT_BLOCK;
+	uint64_t                   m_nFramesDropped = 0;
+	bool                       m_bQuit   = false;
+	bool                       m_bFailed = false;
+
+	void WriterThread();
+
+public:
+	olcFrameRecorder() {}
+	~olcFrameRecorder();
+	olcFrameRecorder(const olcFrameRecorder&) = delete;
+	olcFrameRecorder& operator=(const olcFrameRecorder&) = delete;
+
+	// Up to nMaxQueued frames wait for the writer, policy says what happens
+	// to the next one
+	bool Open(const std::wstring &sFile, int nWidth, int nHeight,
+	          PRESENT_POLICY policy = PRESENT_BLOCK, int nMaxQueued = 8);
+	// Write out everything captured so far and close the file
+	void Close();
+	bool IsOpen() const { return m_threadWriter.joinable(); }
+	// False once a write has failed
+	bool Good();
+
+	// Queue a frame of the size the recording was opened with, timestamped
+	// now
+	void Capture(const olcCellBuffer &buf);
+	// Frames left out because the queue was full
+	uint64_t FramesDropped();
+};
+//-----------------------------------------------------------------------------
+
+class olcFramePlayer
+{
+private:
+	std::ifstream              m_file;
+	int                        m_nWidth  = 0;
+	int                        m_nHeight = 0;
+	olcCellBuffer              m_cells;
+	std::vector<uint8_t>       m_vecPayload;
+	std::vector<sCellRect>     m_vecRegions;
+	uint64_t                   m_nTimeUs = 0;
+	uint64_t                   m_nFrame  = 0;
+	bool                       m_bKeyframe = false;
+
+	bool Decode();
+
+public:
+	bool Open(const std::wstring &sFile);
+	void Close() { m_file.close(); }
+
+	int  Width() const  { return m_nWidth;  }
+	int  Height() const { return m_nHeight; }
+
+	// Step to the next frame, false at the end of the recording (or if it is
+	// damaged)
+	bool NextFrame();
+
+	// The current frame, its time and the rows it changed
+	const olcCellBuffer&           Cells() const     { return m_cells; }
+	double                         Time() const      { return double(m_nTimeUs) / 1e6; }
+	uint64_t                       Frame() const     { return m_nFrame; }
+	bool                           IsKeyframe() const { return m_bKeyframe; }
+	const std::vector<sCellRect>&  Regions() const   { return m_vecRegions; }
+
+	// Construct the backend at the recording's size and present every frame
+	// through it, at the recorded pace or as fast as it takes them. Returns
+	// the number of frames played, -1 if the backend cannot be constructed.
+	long long Play(olcRenderBackend &backend, bool bRealtime);
+};
+//-----------------------------------------------------------------------------
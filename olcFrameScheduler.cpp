@@ -0,0 +1,119 @@
+//-----------------------------------------------------------------------------
+#include "olcFrameScheduler.h"
+
+#include <cmath>
+#include <thread>
+//-----------------------------------------------------------------------------
+
+// Never feed more than this to the accumulator in one frame, so a long stall
+// (debugger, window drag) does not turn into hundreds of catch-up updates
+static const float SCHEDULER_MAX_FRAME_TIME = 0.25f;
+
+// Weight of the newest sleep in the sleep length estimate
+static const double SCHEDULER_SLEEP_WEIGHT = 1.0 / 16.0;
+//-----------------------------------------------------------------------------
+
+void olcFrameScheduler::Reset()
+{
+	m_tpLast         = clock::now();
+	m_tpNext         = m_tpLast;
+	m_tpJitterWindow = m_tpLast;
+	m_fAccumulator   = 0.0f;
+	m_dJitterSum     = 0.0;
+	m_fJitterPeak    = 0.0f;
+	m_nJitterFrames  = 0;
+	m_fJitter        = 0.0f;
+	m_fJitterMax     = 0.0f;
+}
+//-----------------------------------------------------------------------------
+
+float olcFrameScheduler::BeginFrame()
+{
+	clock::time_point tpNow = clock::now();
+	float fElapsed = std::chrono::duration<float>(tpNow - m_tpLast).count();
+	m_tpLast = tpNow;
+
+	if(m_fFixedStep > 0.0f)
+		m_fAccumulator += fElapsed < SCHEDULER_MAX_FRAME_TIME ? fElapsed : SCHEDULER_MAX_FRAME_TIME;
+
+	//-- Jitter is the distance from the target frame time
+	if(m_fTargetFrameTime > 0.0f)
+	{
+		float fDeviation = std::fabs(fElapsed - m_fTargetFrameTime);
+		m_dJitterSum += fDeviation;
+		if(fDeviation > m_fJitterPeak)
+			m_fJitterPeak = fDeviation;
+		++m_nJitterFrames;
+	}
+
+	if(tpNow - m_tpJitterWindow >= std::chrono::seconds(1))
+	{
+		m_fJitter        = m_nJitterFrames > 0 ? float(m_dJitterSum / m_nJitterFrames) : 0.0f;
+		m_fJitterMax     = m_fJitterPeak;
+		m_dJitterSum     = 0.0;
+		m_fJitterPeak    = 0.0f;
+		m_nJitterFrames  = 0;
+		m_tpJitterWindow = tpNow;
+	}
+
+	return fElapsed;
+}
+//-----------------------------------------------------------------------------
+
+bool olcFrameScheduler::ConsumeStep()
+{
+	if(m_fAccumulator < m_fFixedStep)
+		return false;
+	m_fAccumulator -= m_fFixedStep;
+	return true;
+}
+//-----------------------------------------------------------------------------
+
+float olcFrameScheduler::Alpha() const
+{
+	return m_fFixedStep > 0.0f ? m_fAccumulator / m_fFixedStep : 0.0f;
+}
+//-----------------------------------------------------------------------------
+
+void olcFrameScheduler::SleepSlice()
+{
+	clock::time_point tpStart = clock::now();
+	std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	double dSlept = std::chrono::duration<double>(clock::now() - tpStart).count();
+
+	//-- Exponentially weighted mean/variance of the real sleep length
+	double dDelta = dSlept - m_dSleepMean;
+	m_dSleepMean += SCHEDULER_SLEEP_WEIGHT * dDelta;
+	m_dSleepVar   = (1.0 - SCHEDULER_SLEEP_WEIGHT) * (m_dSleepVar + SCHEDULER_SLEEP_WEIGHT * dDelta * dDelta);
+}
+//-----------------------------------------------------------------------------
+
+void olcFrameScheduler::WaitForNextFrame()
+{
+	if(m_fTargetFrameTime <= 0.0f)
+		return;
+
+	clock::time_point tpNow = clock::now();
+	auto target = std::chrono::duration_cast<clock::duration>(std::chrono::duration<float>(m_fTargetFrameTime));
+	m_tpNext += target;
+
+	//-- Running late: start counting from now instead of rushing frames out
+	//   to catch up
+	if(m_tpNext < tpNow)
+		m_tpNext = tpNow;
+
+	//-- Sleep while a sleep is certain to finish in time...
+	while(true)
+	{
+		double dRemaining = std::chrono::duration<double>(m_tpNext - clock::now()).count();
+		double dSleepCost = m_dSleepMean + std::sqrt(m_dSleepVar);
+		if(dRemaining <= dSleepCost)
+			break;
+		SleepSlice();
+	}
+
+	//-- ...and spin away the rest
+	while(clock::now() < m_tpNext)
+		std::this_thread::yield();
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,74 @@
+//---------------------------------------------------------------------------//
+//  Frame scheduler.
+//
+//  Paces the game loop to a target frame time on the monotonic steady_clock
+//  and drives fixed-step updates:
+//
+//   - waits sleep in short slices and spin only for the last stretch, where
+//     the spin is sized from how much the recent sleeps have overshot
+//   - fixed steps are taken from an accumulator; what is left over is the
+//     interpolation alpha between the last two updates
+//   - the deviation of every frame from the target is reported as jitter
+//---------------------------------------------------------------------------//
+
+//-----------------------------------------------------------------------------
+#pragma once
+//-----------------------------------------------------------------------------
+#include <chrono>
+//-----------------------------------------------------------------------------
+
+class olcFrameScheduler
+{
+public:
+	typedef std::chrono::steady_clock clock;
+
+private:
+	clock::time_point m_tpLast;
+	clock::time_point m_tpNext;
+	float             m_fTargetFrameTime = 0.0f;
+	float             m_fFixedStep       = 0.0f;
+	float             m_fAccumulator     = 0.0f;
+
+	// How long a 1ms sleep really takes lately: exponentially weighted mean
+	// and variance, so the estimate follows changes in system load
+	double            m_dSleepMean  = 0.002;
+	double            m_dSleepVar   = 0.0;
+
+	// Jitter over the current one second window, and the last full window
+	double            m_dJitterSum    = 0.0;
+	float             m_fJitterPeak   = 0.0f;
+	int               m_nJitterFrames = 0;
+	clock::time_point m_tpJitterWindow;
+	float             m_fJitter       = 0.0f;
+	float             m_fJitterMax    = 0.0f;
+
+	void SleepSlice();
+
+public:
+	// Seconds per frame the loop is paced to. 0 runs as fast as possible.
+	void  SetTargetFrameTime(float fSeconds) { m_fTargetFrameTime = fSeconds > 0.0f ? fSeconds : 0.0f; }
+	// Seconds per update step. 0 gives one variable length step per frame.
+	void  SetFixedStep(float fSeconds)       { m_fFixedStep = fSeconds > 0.0f ? fSeconds : 0.0f; }
+	float TargetFrameTime() const            { return m_fTargetFrameTime; }
+	float FixedStep() const                  { return m_fFixedStep; }
+
+	void  Reset();
+
+	// Start a frame, returns the seconds elapsed since the previous one
+	float BeginFrame();
+
+	// With a fixed step, returns true (and consumes one step) while there is
+	// a whole step of time in the accumulator
+	bool  ConsumeStep();
+	// Fraction of a step left in the accumulator, for interpolated drawing
+	float Alpha() const;
+
+	// Wait until the next frame is due
+	void  WaitForNextFrame();
+
+	// Mean and worst absolute deviation from the target frame time over the
+	// last second, in seconds. Zero when the loop is not paced.
+	float Jitter() const    { return m_fJitter; }
+	float JitterMax() const { return m_fJitterMax; }
+};
+//-----------------------------------------------------------------------------
@@ -0,0 +1,34 @@
+//---------------------------------------------------------------------------//
+//  Input events.
+//
+//  Render backends report keyboard and mouse activity as timestamped events
+//  (see olcRenderBackend::WaitInput()). The engine collects them on its own
+//  input thread and turns them into m_keys[] / m_mouse[] at the start of
+//  every update; the raw stream is available through GetInputEvents().
+//---------------------------------------------------------------------------//
+
+//-----------------------------------------------------------------------------
+#pragma once
+//-----------------------------------------------------------------------------
+#include <chrono>
+//-----------------------------------------------------------------------------
+
+enum INPUT_EVENT_TYPE
+{
+	INPUT_KEY_DOWN   = 0,
+	INPUT_KEY_UP     = 1,
+	INPUT_MOUSE_MOVE = 2,
+	INPUT_MOUSE_DOWN = 3,
+	INPUT_MOUSE_UP   = 4,
+};
+//-----------------------------------------------------------------------------
+
+struct olcInputEvent
+{
+	std::chrono::steady_clock::time_point tpTime;
+	INPUT_EVENT_TYPE nType;
+	int              nKey;	// virtual key code, or mouse button 0-4
+	int              x;		// mouse position in cells
+	int              y;
+};
+//-----------------------------------------------------------------------------
@@ -0,0 +1,151 @@
+//-----------------------------------------------------------------------------
+#include "olcParticles.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#define OLC_PARTICLES_AVX
+#define OLC_PARTICLES_SSE
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OLC_PARTICLES_SSE
+#endif
+//-----------------------------------------------------------------------------
+
+void olcParticleSystem::Reserve(size_t nParticles)
+{
+	m_vecX.reserve(nParticles);
+	m_vecY.reserve(nParticles);
+	m_vecVX.reserve(nParticles);
+	m_vecVY.reserve(nParticles);
+	m_vecLife.reserve(nParticles);
+	m_vecGlyphs.reserve(nParticles);
+	m_vecColours.reserve(nParticles);
+}
+//-----------------------------------------------------------------------------
+
+void olcParticleSystem::Clear()
+{
+	m_vecX.clear();
+	m_vecY.clear();
+	m_vecVX.clear();
+	m_vecVY.clear();
+	m_vecLife.clear();
+	m_vecGlyphs.clear();
+	m_vecColours.clear();
+}
+//-----------------------------------------------------------------------------
+
+size_t olcParticleSystem::Emit(float x, float y, float vx, float vy, float fLife, wchar_t c, short col)
+{
+	m_vecX.push_back(x);
+	m_vecY.push_back(y);
+	m_vecVX.push_back(vx);
+	m_vecVY.push_back(vy);
+	m_vecLife.push_back(fLife);
+	m_vecGlyphs.push_back(c);
+	m_vecColours.push_back(uint8_t(col));
+	return m_vecX.size() - 1;
+}
+//-----------------------------------------------------------------------------
+
+void olcParticleSystem::Kill(size_t i)
+{
+	size_t nLast = m_vecX.size() - 1;
+	m_vecX[i]       = m_vecX[nLast];
+	m_vecY[i]       = m_vecY[nLast];
+	m_vecVX[i]      = m_vecVX[nLast];
+	m_vecVY[i]      = m_vecVY[nLast];
+	m_vecLife[i]    = m_vecLife[nLast];
+	m_vecGlyphs[i]  = m_vecGlyphs[nLast];
+	m_vecColours[i] = m_vecColours[nLast];
+	m_vecX.pop_back();
+	m_vecY.pop_back();
+	m_vecVX.pop_back();
+	m_vecVY.pop_back();
+	m_vecLife.pop_back();
+	m_vecGlyphs.pop_back();
+	m_vecColours.pop_back();
+}
+//-----------------------------------------------------------------------------
+
+void olcParticleSystem::Update(float fElapsedTime)
+{
+	//-- Semi-implicit Euler: velocity first, then position with the new one
+	const size_t n   = Size();
+	const float  dt  = fElapsedTime;
+	const float  dvx = m_fAccelX * dt, dvy = m_fAccelY * dt;
+	float *x = m_vecX.data(), *y = m_vecY.data(), *vx = m_vecVX.data(), *vy = m_vecVY.data(), *life = m_vecLife.data();
+	size_t i = 0;
+
+#if defined(OLC_PARTICLES_AVX)
+	const __m256 t8 = _mm256_set1_ps(dt), ax8 = _mm256_set1_ps(dvx), ay8 = _mm256_set1_ps(dvy);
+	for(; i + 8 <= n; i += 8)
+	{
+		__m256 u = _mm256_add_ps(_mm256_loadu_ps(vx + i), ax8);
+		__m256 v = _mm256_add_ps(_mm256_loadu_ps(vy + i), ay8);
+		_mm256_storeu_ps(vx + i, u);
+		_mm256_storeu_ps(vy + i, v);
+		_mm256_storeu_ps(x + i, _mm256_add_ps(_mm256_loadu_ps(x + i), _mm256_mul_ps(u, t8)));
+		_mm256_storeu_ps(y + i, _mm256_add_ps(_mm256_loadu_ps(y + i), _mm256_mul_ps(v, t8)));
+		_mm256_storeu_ps(life + i, _mm256_sub_ps(_mm256_loadu_ps(life + i), t8));
+	}
+#endif
+#if defined(OLC_PARTICLES_SSE)
+	const __m128 t4 = _mm_set1_ps(dt), ax4 = _mm_set1_ps(dvx), ay4 = _mm_set1_ps(dvy);
+	for(; i + 4 <= n; i += 4)
+	{
+		__m128 u = _mm_add_ps(_mm_loadu_ps(vx + i), ax4);
+		__m128 v = _mm_add_ps(_mm_loadu_ps(vy + i), ay4);
+		_mm_storeu_ps(vx + i, u);
+		_mm_storeu_ps(vy + i, v);
+		_mm_storeu_ps(x + i, _mm_add_ps(_mm_loadu_ps(x + i), _mm_mul_ps(u, t4)));
+		_mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y + i), _mm_mul_ps(v, t4)));
+		_mm_storeu_ps(life + i, _mm_sub_ps(_mm_loadu_ps(life + i), t4));
+	}
+#endif
+	for(; i < n; ++i)
+	{
+		vx[i]   += dvx;
+		vy[i]   += dvy;
+		x[i]    += vx[i] * dt;
+		y[i]    += vy[i] * dt;
+		life[i] -= dt;
+	}
+
+	//-- Swap-remove the expired ones. Whole registers of live particles are
+	//   stepped over with a single compare.
+	i = 0;
+	size_t nLive = n;
+	while(i < nLive)
+	{
+#if defined(OLC_PARTICLES_SSE)
+		if(i + 4 <= nLive && _mm_movemask_ps(_mm_cmple_ps(_mm_loadu_ps(life + i), _mm_setzero_ps())) == 0)
+		{
+			i += 4;
+			continue;
+		}
+#endif
+		if(life[i] > 0.0f)
+		{
+			++i;
+			continue;
+		}
+		--nLive;
+		x[i]            = x[nLive];
+		y[i]            = y[nLive];
+		vx[i]           = vx[nLive];
+		vy[i]           = vy[nLive];
+		life[i]         = life[nLive];
+		m_vecGlyphs[i]  = m_vecGlyphs[nLive];
+		m_vecColours[i] = m_vecColours[nLive];
+	}
+
+	m_vecX.resize(nLive);
+	m_vecY.resize(nLive);
+	m_vecVX.resize(nLive);
+	m_vecVY.resize(nLive);
+	m_vecLife.resize(nLive);
+	m_vecGlyphs.resize(nLive);
+	m_vecColours.resize(nLive);
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,69 @@
+//---------------------------------------------------------------------------//
+//  Particle system.
+//
+//  Particles are kept as a structure of arrays: position, velocity and
+//  remaining lifetime in float arrays of their own, glyph and colour beside
+//  them. Update() integrates a whole register of particles at a time (SSE,
+//  or AVX when the compiler targets it) and then removes the expired ones
+//  by moving the last particle into their slot, so the arrays stay dense
+//  and particle order is not preserved. Indices are therefore only stable
+//  until the next Update() or Kill().
+//
+//  The engine draws a whole system with DrawParticles(), in one pass over
+//  the arrays that clips and writes each live particle.
+//---------------------------------------------------------------------------//
+
+//-----------------------------------------------------------------------------
+#pragma once
+//-----------------------------------------------------------------------------
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+//-----------------------------------------------------------------------------
+
+class olcParticleSystem
+{
+private:
+	std::vector<float>   m_vecX;
+	std::vector<float>   m_vecY;
+	std::vector<float>   m_vecVX;
+	std::vector<float>   m_vecVY;
+	std::vector<float>   m_vecLife;
+	std::vector<wchar_t> m_vecGlyphs;
+	std::vector<uint8_t> m_vecColours;
+	float                m_fAccelX = 0.0f;
+	float                m_fAccelY = 0.0f;
+
+public:
+	void   Reserve(size_t nParticles);
+	size_t Size() const { return m_vecX.size(); }
+	void   Clear();
+
+	// Add a particle living for fLife seconds, returns its index
+	size_t Emit(float x, float y, float vx, float vy, float fLife, wchar_t c = 0x2588, short col = 0x000F);
+	// Remove particle i, the last one takes its index
+	void   Kill(size_t i);
+
+	// Acceleration applied to every particle, e.g. gravity
+	void   SetAcceleration(float ax, float ay) { m_fAccelX = ax; m_fAccelY = ay; }
+
+	// Move every particle on by fElapsedTime and drop the ones that expire
+	void   Update(float fElapsedTime);
+
+	// The arrays, Size() entries each
+	float*         X()             { return m_vecX.data();    }
+	float*         Y()             { return m_vecY.data();    }
+	float*         VX()            { return m_vecVX.data();   }
+	float*         VY()            { return m_vecVY.data();   }
+	float*         Life()          { return m_vecLife.data(); }
+	wchar_t*       Glyphs()        { return m_vecGlyphs.data();  }
+	uint8_t*       Colours()       { return m_vecColours.data(); }
+	const float*   X() const       { return m_vecX.data();    }
+	const float*   Y() const       { return m_vecY.data();    }
+	const float*   VX() const      { return m_vecVX.data();   }
+	const float*   VY() const      { return m_vecVY.data();   }
+	const float*   Life() const    { return m_vecLife.data(); }
+	const wchar_t* Glyphs() const  { return m_vecGlyphs.data();  }
+	const uint8_t* Colours() const { return m_vecColours.data(); }
+};
+//-----------------------------------------------------------------------------
@@ -0,0 +1,375 @@
+//-----------------------------------------------------------------------------
+#include "olcProfiler.h"
+#include "olcConsoleGameEngine.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+//-----------------------------------------------------------------------------
+
+//-- A thread's zones. Only the owning thread writes, as a seqlock per slot:
+//   nSeq goes to 0, the fields are stored with release, then nSeq becomes
+//   the zone's index + 1 (release). Readers load nSeq (acquire), the fields
+//   (acquire) and nSeq again, and keep the copy only if both name the zone
+//   they were after. A field from a later write synchronises with that
+//   write, so the second load then sees its 0 or a later index.
+struct sProfileEvent
+{
+	std::atomic<uint64_t>    nSeq{ 0 };
+	std::atomic<const char*> sName{ nullptr };
+	std::atomic<int64_t>     nStart{ 0 };
+	std::atomic<int64_t>     nEnd{ 0 };
+	std::atomic<uint64_t>    nFrame{ 0 };
+};
+
+struct sProfileRing
+{
+	sProfileEvent          events[olcProfiler::RING_SIZE];
+	std::atomic<uint64_t>  nHead{ 0 };
+	std::atomic<uint64_t>  nCleared{ 0 };
+	std::string            sThreadName;	// Guarded by the registry lock
+	int                    nThread = 0;
+};
+
+struct sProfileCopy
+{
+	const char *sName;
+	int64_t     nStart;
+	int64_t     nEnd;
+	uint64_t    nFrame;
+	int         nThread;
+};
+//-----------------------------------------------------------------------------
+
+static std::atomic<bool>     s_bEnabled{ false };
+static std::atomic<uint64_t> s_nFrame{ 0 };
+
+//-- Rings are never freed, the zones of finished threads stay in traces
+static std::mutex                                 s_muxRings;
+static std::vector<std::unique_ptr<sProfileRing>> s_vecRings;
+static thread_local sProfileRing                 *t_pRing = nullptr;
+static thread_local std::string                   t_sThreadName;
+
+static std::mutex   s_muxSpike;
+static double       s_fSpikeMs = 0.0;
+static std::wstring s_sSpikeFile;
+static int64_t      s_nLastSpikeDump = -1;
+//-----------------------------------------------------------------------------
+
+static bool WriteChromeTrace(const std::wstring &sFile, const std::vector<std::pair<int, std::string>> &vecThreads,
+                             const std::vector<sProfileCopy> &vecEvents);
+
+//-- Spike traces are written on a thread of their own, so formatting and
+//   writing the file does not add to the frame that ran long. A snapshot
+//   still waiting when the next one comes is replaced by it.
+struct sSpikeWriter
+{
+	std::mutex                                mux;
+	std::condition_variable                   cv;
+	std::thread                               thread;
+	bool                                      bQuit    = false;
+	bool                                      bPending = false;
+	std::wstring                              sFile;
+	std::vector<std::pair<int, std::string>>  vecThreads;
+	std::vector<sProfileCopy>                 vecEvents;
+
+	~sSpikeWriter()
+	{
+		{
+			std::lock_guard<std::mutex> lck(mux);
+			bQuit = true;
+		}
+		cv.notify_one();
+		if(thread.joinable())
+			thread.join();
+	}
+
+	void Post(const std::wstring &sTraceFile, std::vector<std::pair<int, std::string>> &&vecTraceThreads,
+	          std::vector<sProfileCopy> &&vecTraceEvents)
+	{
+		{
+			std::lock_guard<std::mutex> lck(mux);
+			sFile      = sTraceFile;
+			vecThreads = std::move(vecTraceThreads);
+			vecEvents  = std::move(vecTraceEvents);
+			bPending   = true;
+			if(!thread.joinable())
+				thread = std::thread(&sSpikeWriter::Run, this);
+		}
+		cv.notify_one();
+	}
+
+	void Run()
+	{
+		std::unique_lock<std::mutex> lck(mux);
+		while(true)
+		{
+			cv.wait(lck, [this] { return bQuit || bPending; });
+			if(!bPending)
+				break;
+			std::wstring sTraceFile = std::move(sFile);
+			std::vector<std::pair<int, std::string>> vecTraceThreads = std::move(vecThreads);
+			std::vector<sProfileCopy> vecTraceEvents = std::move(vecEvents);
+			bPending = false;
+			lck.unlock();
+			WriteChromeTrace(sTraceFile, vecTraceThreads, vecTraceEvents);
+			lck.lock();
+		}
+	}
+};
+
+static sSpikeWriter s_spikeWriter;
+//-----------------------------------------------------------------------------
+
+static sProfileRing* ThreadRing()
+{
+	if(t_pRing == nullptr)
+	{
+		std::lock_guard<std::mutex> lck(s_muxRings);
+		s_vecRings.emplace_back(new sProfileRing());
+		t_pRing = s_vecRings.back().get();
+		t_pRing->nThread     = int(s_vecRings.size());
+		t_pRing->sThreadName = t_sThreadName;
+	}
+	return t_pRing;
+}
+//-----------------------------------------------------------------------------
+
+// Copy out whatever the rings hold that is still intact
+static std::vector<sProfileCopy> Snapshot(std::vector<std::pair<int, std::string>> *pThreads = nullptr)
+{
+	std::vector<sProfileCopy> vecEvents;
+	std::lock_guard<std::mutex> lck(s_muxRings);
+	for(std::unique_ptr<sProfileRing> &pRing : s_vecRings)
+	{
+		if(pThreads)
+			pThreads->push_back({ pRing->nThread, pRing->sThreadName });
+
+		uint64_t nHead  = pRing->nHead.load(std::memory_order_acquire);
+		uint64_t nFirst = std::max(nHead > uint64_t(olcProfiler::RING_SIZE) ? nHead - olcProfiler::RING_SIZE : 0,
+		                           pRing->nCleared.load(std::memory_order_relaxed));
+		for(uint64_t i = nFirst; i < nHead; ++i)
+		{
+			//-- Slots the writer has lapped (or is in) meanwhile are dropped
+			sProfileEvent &e = pRing->events[i % olcProfiler::RING_SIZE];
+			if(e.nSeq.load(std::memory_order_acquire) != i + 1)
+				continue;
+			sProfileCopy copy = { e.sName.load(std::memory_order_acquire), e.nStart.load(std::memory_order_acquire),
+			                      e.nEnd.load(std::memory_order_acquire), e.nFrame.load(std::memory_order_acquire),
+			                      pRing->nThread };
+			if(e.nSeq.load(std::memory_order_relaxed) == i + 1)
+				vecEvents.push_back(copy);
+		}
+	}
+	return vecEvents;
+}
+//-----------------------------------------------------------------------------
+
+void olcProfiler::Enable(bool bEnable)
+{
+	s_bEnabled.store(bEnable, std::memory_order_relaxed);
+}
+//-----------------------------------------------------------------------------
+
+bool olcProfiler::IsEnabled()
+{
+	return s_bEnabled.load(std::memory_order_relaxed);
+}
+//-----------------------------------------------------------------------------
+
+int64_t olcProfiler::Now()
+{
+	static const std::chrono::steady_clock::time_point tpEpoch = std::chrono::steady_clock::now();
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - tpEpoch).count();
+}
+//-----------------------------------------------------------------------------
+
+void olcProfiler::Record(const char *sName, int64_t nStart, int64_t nEnd)
+{
+	sProfileRing *pRing = ThreadRing();
+	uint64_t      nHead = pRing->nHead.load(std::memory_order_relaxed);
+	sProfileEvent &e    = pRing->events[nHead % RING_SIZE];
+	e.nSeq.store(0, std::memory_order_relaxed);
+	e.sName.store(sName, std::memory_order_release);
+	e.nStart.store(nStart, std::memory_order_release);
+	e.nEnd.store(nEnd, std::memory_order_release);
+	e.nFrame.store(s_nFrame.load(std::memory_order_relaxed), std::memory_order_release);
+	e.nSeq.store(nHead + 1, std::memory_order_release);
+	pRing->nHead.store(nHead + 1, std::memory_order_release);
+}
+//-----------------------------------------------------------------------------
+
+void olcProfiler::SetThreadName(const std::string &sName)
+{
+	//-- Threads that never record do not get a ring just for their name
+	t_sThreadName = sName;
+	if(t_pRing != nullptr)
+	{
+		std::lock_guard<std::mutex> lck(s_muxRings);
+		t_pRing->sThreadName = sName;
+	}
+}
+//-----------------------------------------------------------------------------
+
+int64_t olcProfiler::BeginFrame()
+{
+	s_nFrame.fetch_add(1, std::memory_order_relaxed);
+	return IsEnabled() ? Now() : -1;
+}
+//-----------------------------------------------------------------------------
+
+void olcProfiler::EndFrame(int64_t nStart)
+{
+	if(nStart < 0)
+		return;
+
+	int64_t nEnd = Now();
+	Record("Frame", nStart, nEnd);
+
+	std::wstring sFile;
+	{
+		std::lock_guard<std::mutex> lck(s_muxSpike);
+		if(s_fSpikeMs <= 0.0 || double(nEnd - nStart) < s_fSpikeMs * 1e6 ||
+		   (s_nLastSpikeDump >= 0 && nEnd - s_nLastSpikeDump < 1000000000))
+			return;
+		s_nLastSpikeDump = nEnd;
+		sFile = s_sSpikeFile;
+	}
+
+	//-- Only the copy is made here, the writer thread does the rest
+	std::vector<std::pair<int, std::string>> vecThreads;
+	std::vector<sProfileCopy> vecEvents = Snapshot(&vecThreads);
+	s_spikeWriter.Post(sFile, std::move(vecThreads), std::move(vecEvents));
+}
+//-----------------------------------------------------------------------------
+
+void olcProfiler::SetSpikeTrace(double fMs, const std::wstring &sFile)
+{
+	std::lock_guard<std::mutex> lck(s_muxSpike);
+	s_fSpikeMs       = fMs;
+	s_sSpikeFile     = sFile;
+	s_nLastSpikeDump = -1;
+}
+//-----------------------------------------------------------------------------
+
+std::vector<sProfileStats> olcProfiler::Statistics()
+{
+	std::vector<sProfileCopy> vecEvents = Snapshot();
+
+	//-- Total each zone per frame. Zones are keyed by name, not pointer, as
+	//   the same literal may live at several addresses.
+	std::map<std::string, std::map<uint64_t, int64_t>> mapFrames;
+	std::map<std::string, uint64_t>                    mapCalls;
+	for(const sProfileCopy &e : vecEvents)
+	{
+		mapFrames[e.sName][e.nFrame] += e.nEnd - e.nStart;
+		mapCalls[e.sName]++;
+	}
+
+	std::vector<sProfileStats> vecStats;
+	std::vector<int64_t> vecTotals;
+	for(auto &zone : mapFrames)
+	{
+		vecTotals.clear();
+		int64_t nSum = 0;
+		for(auto &frame : zone.second)
+		{
+			vecTotals.push_back(frame.second);
+			nSum += frame.second;
+		}
+		std::sort(vecTotals.begin(), vecTotals.end());
+
+		sProfileStats s;
+		s.sName   = zone.first;
+		s.nFrames = vecTotals.size();
+		s.nCalls  = mapCalls[zone.first];
+		s.fMin    = double(vecTotals.front()) / 1e6;
+		s.fMax    = double(vecTotals.back()) / 1e6;
+		s.fAvg    = double(nSum) / double(vecTotals.size()) / 1e6;
+		s.fP99    = double(vecTotals[(vecTotals.size() - 1) * 99 / 100]) / 1e6;
+		vecStats.push_back(s);
+	}
+
+	std::sort(vecStats.begin(), vecStats.end(),
+		[](const sProfileStats &a, const sProfileStats &b) { return a.fAvg > b.fAvg; });
+	return vecStats;
+}
+//-----------------------------------------------------------------------------
+
+static void WriteJsonString(std::ofstream &f, const std::string &s)
+{
+	f << '"';
+	for(char c : s)
+	{
+		if(c == '"' || c == '\\')
+			f << '\\' << c;
+		else if((unsigned char)c < 0x20)
+		{
+			char sEscape[8];
+			snprintf(sEscape, sizeof(sEscape), "\\u%04x", unsigned(c));
+			f << sEscape;
+		}
+		else
+			f << c;
+	}
+	f << '"';
+}
+//-----------------------------------------------------------------------------
+
+static bool WriteChromeTrace(const std::wstring &sFile, const std::vector<std::pair<int, std::string>> &vecThreads,
+                             const std::vector<sProfileCopy> &vecEvents)
+{
+	std::ofstream f(WS2S(sFile).c_str(), std::ios_base::binary);
+	if(!f.is_open())
+		return false;
+
+	//-- Complete ("X") events in microseconds, plus the thread names
+	f << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+	bool bFirst = true;
+	for(const auto &thread : vecThreads)
+	{
+		if(thread.second.empty())
+			continue;
+		f << (bFirst ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << thread.first << ",\"args\":{\"name\":";
+		WriteJsonString(f, thread.second);
+		f << "}}";
+		bFirst = false;
+	}
+
+	char sNumbers[96];
+	for(const sProfileCopy &e : vecEvents)
+	{
+		f << (bFirst ? "\n" : ",\n") << "{\"name\":";
+		WriteJsonString(f, e.sName);
+		snprintf(sNumbers, sizeof(sNumbers), ",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f",
+		         e.nThread, double(e.nStart) / 1e3, double(e.nEnd - e.nStart) / 1e3);
+		f << sNumbers << ",\"args\":{\"frame\":" << e.nFrame << "}}";
+		bFirst = false;
+	}
+	f << "\n]}\n";
+	return bool(f);
+}
+//-----------------------------------------------------------------------------
+
+bool olcProfiler::DumpChromeTrace(const std::wstring &sFile)
+{
+	std::vector<std::pair<int, std::string>> vecThreads;
+	std::vector<sProfileCopy> vecEvents = Snapshot(&vecThreads);
+	return WriteChromeTrace(sFile, vecThreads, vecEvents);
+}
+//-----------------------------------------------------------------------------
+
+void olcProfiler::Reset()
+{
+	std::lock_guard<std::mutex> lck(s_muxRings);
+	for(std::unique_ptr<sProfileRing> &pRing : s_vecRings)
+		pRing->nCleared.store(pRing->nHead.load(std::memory_order_acquire), std::memory_order_relaxed);
+}
+//-----------------------------------------------------------------------------
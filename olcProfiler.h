@@ -0,0 +1,109 @@
+//---------------------------------------------------------------------------//
+//  Per-frame phase profiler.
+//
+//  Scoped zones time what runs inside them:
+//
+//      {
+//          OLC_PROFILE_ZONE("Pathfinding");
+//          ...
+//      }
+//
+//  The engine already wraps the phases of its frame (input, OnUserUpdate,
+//  the drawing routines by category, composite, title, present, wait), and
+//  user zones nest inside those. Every thread records into a ring buffer of
+//  its own, with no locks and no allocation, so zones cost two clock reads
+//  while profiling is enabled and a single flag test while it is not (the
+//  default). Define OLCCGE_NO_PROFILER to compile them out altogether.
+//
+//  The rings keep the last RING_SIZE zones of each thread. From them the
+//  profiler reports per frame statistics of every zone (a zone entered more
+//  than once in a frame counts as its total) and writes Chrome trace JSON,
+//  to load in chrome://tracing or Perfetto. Given a spike threshold it
+//  writes the trace by itself whenever a frame runs over it: the frame's
+//  thread only copies the rings, a thread of the profiler's own writes the
+//  file.
+//
+//  Zone names must be string literals, or otherwise outlive the profiler.
+//---------------------------------------------------------------------------//
+
+//-----------------------------------------------------------------------------
+#pragma once
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <string>
+#include <vector>
+//-----------------------------------------------------------------------------
+
+struct sProfileStats
+{
+	std::string sName;
+	uint64_t    nFrames;	// Frames the zone was entered in
+	uint64_t    nCalls;
+	double      fMin;		// Milliseconds per frame
+	double      fAvg;
+	double      fP99;
+	double      fMax;
+};
+//-----------------------------------------------------------------------------
+
+class olcProfiler
+{
+public:
+	static const int RING_SIZE = 16384;
+
+	static void Enable(bool bEnable);
+	static bool IsEnabled();
+
+	// Nanoseconds on the profiler's clock
+	static int64_t Now();
+
+	// Record a finished zone on the calling thread's ring
+	static void Record(const char *sName, int64_t nStart, int64_t nEnd);
+
+	// Name the calling thread in traces
+	static void SetThreadName(const std::string &sName);
+
+	// Bracket a frame of the main loop. BeginFrame() returns the start time
+	// to hand to EndFrame(), which records the "Frame" zone.
+	static int64_t BeginFrame();
+	static void    EndFrame(int64_t nStart);
+
+	// Write the trace to sFile whenever a frame takes longer than fMs (at
+	// most once a second), 0 to stop
+	static void SetSpikeTrace(double fMs, const std::wstring &sFile);
+
+	// Per frame statistics over what the rings hold, slowest zone first
+	static std::vector<sProfileStats> Statistics();
+	static bool DumpChromeTrace(const std::wstring &sFile);
+	// Forget everything recorded so far
+	static void Reset();
+};
+//-----------------------------------------------------------------------------
+
+class olcProfileZone
+{
+private:
+	const char *m_sName;
+	int64_t     m_nStart;
+
+public:
+	explicit olcProfileZone(const char *sName)
+		: m_sName(sName), m_nStart(olcProfiler::IsEnabled() ? olcProfiler::Now() : -1) {}
+	~olcProfileZone()
+	{
+		if(m_nStart >= 0)
+			olcProfiler::Record(m_sName, m_nStart, olcProfiler::Now());
+	}
+	olcProfileZone(const olcProfileZone&) = delete;
+	olcProfileZone& operator=(const olcProfileZone&) = delete;
+};
+//-----------------------------------------------------------------------------
+
+#ifdef OLCCGE_NO_PROFILER
+#define OLC_PROFILE_ZONE(name)	((void)0)
+#else
+#define OLC_PROFILE_CONCAT2(a, b)	a##b
+#define OLC_PROFILE_CONCAT(a, b)	OLC_PROFILE_CONCAT2(a, b)
+#define OLC_PROFILE_ZONE(name)	olcProfileZone OLC_PROFILE_CONCAT(olcProfileZone_, __LINE__)(name)
+#endif
+//-----------------------------------------------------------------------------
@@ -0,0 +1,265 @@
+//-----------------------------------------------------------------------------
+#include "olcRasterizer.h"
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+//-----------------------------------------------------------------------------
+
+static inline int64_t CeilDiv(int64_t a, int64_t b)
+{
+	// b > 0
+	return a >= 0 ? (a + b - 1) / b : -((-a) / b);
+}
+//-----------------------------------------------------------------------------
+
+static inline void AddSpan(std::vector<sSpan> &vecSpans, const sClipRect &clip, int y, int x1, int x2)
+{
+	if(y < clip.y1 || y >= clip.y2)
+		return;
+	if(x1 < clip.x1) x1 = clip.x1;
+	if(x2 > clip.x2) x2 = clip.x2;
+	if(x1 < x2)
+		vecSpans.push_back({ y, x1, x2 });
+}
+//-----------------------------------------------------------------------------
+
+// Call fn(y, x1, x2) with the run of each row the Bresenham line from (x1, y1)
+// to (x2, y2) plots inside clip, as the engine's original DrawLine walks it.
+//
+// Walking from the start point, step k (0..major length) moves one cell
+// along the major axis and the minor axis has moved m(k) cells:
+//   x major:  m(k) = floor((2*dy*k + dx) / (2*dx))
+//   y major:  m(k) = floor((2*dx*k + dy - 1) / (2*dy))
+// (dx, dy absolute). Both invert, which gives the first step with m(k) >= M
+// and so the step range in the clip rectangle without walking to it.
+template<typename F>
+static void LineRuns(int x1, int y1, int x2, int y2, const sClipRect &clip, F fn)
+{
+	int64_t dx  = int64_t(x2) - x1;
+	int64_t dy  = int64_t(y2) - y1;
+	int64_t dx1 = std::llabs(dx);
+	int64_t dy1 = std::llabs(dy);
+	int     s   = ((dx < 0 && dy < 0) || (dx > 0 && dy > 0)) ? 1 : -1;
+
+	if(dy1 <= dx1)
+	{
+		int64_t xs = dx >= 0 ? x1 : x2;
+		int64_t ys = dx >= 0 ? y1 : y2;
+
+		// First step whose minor offset reaches M
+		auto first = [&](int64_t M) { return dy1 == 0 ? (M <= 0 ? 0 : INT64_MAX / 4) : CeilDiv(2 * dx1 * M - dx1, 2 * dy1); };
+
+		int64_t mLo = s > 0 ? clip.y1 - ys     : ys - (clip.y2 - 1);
+		int64_t mHi = s > 0 ? clip.y2 - 1 - ys : ys - clip.y1;
+		if(mHi < 0 || mLo > mHi)
+			return;
+
+		int64_t k0 = std::max<int64_t>({ 0, clip.x1 - xs, first(mLo) });
+		int64_t k1 = std::min<int64_t>({ dx1, clip.x2 - 1 - xs, first(mHi + 1) - 1 });
+		if(k0 > k1)
+			return;
+
+		int64_t m  = dy1 == 0 ? 0 : (2 * dy1 * k0 + dx1) / (2 * dx1);
+		int64_t k  = k0;
+		while(k <= k1)
+		{
+			int64_t kEnd = std::min(k1, first(m + 1) - 1);
+			fn(int(ys + s * m), int(xs + k), int(xs + kEnd + 1));
+			k = kEnd + 1;
+			++m;
+		}
+	}
+	else
+	{
+		int64_t xs = dy >= 0 ? x1 : x2;
+		int64_t ys = dy >= 0 ? y1 : y2;
+
+		auto first = [&](int64_t M) { return dx1 == 0 ? (M <= 0 ? 0 : INT64_MAX / 4) : CeilDiv(2 * dy1 * M - dy1 + 1, 2 * dx1); };
+
+		int64_t mLo = s > 0 ? clip.x1 - xs     : xs - (clip.x2 - 1);
+		int64_t mHi = s > 0 ? clip.x2 - 1 - xs : xs - clip.x1;
+		if(mHi < 0 || mLo > mHi)
+			return;
+
+		int64_t k0 = std::max<int64_t>({ 0, clip.y1 - ys, first(mLo) });
+		int64_t k1 = std::min<int64_t>({ dy1, clip.y2 - 1 - ys, first(mHi + 1) - 1 });
+		if(k0 > k1)
+			return;
+
+		//-- One cell per row, the minor offset kept as quotient + remainder
+		int64_t num = 2 * dx1 * k0 + dy1 - 1;
+		int64_t m   = num / (2 * dy1);
+		int64_t rem = num % (2 * dy1);
+		for(int64_t k = k0; k <= k1; ++k)
+		{
+			int x = int(xs + s * m);
+			fn(int(ys + k), x, x + 1);
+			rem += 2 * dx1;
+			if(rem >= 2 * dy1)
+			{
+				rem -= 2 * dy1;
+				++m;
+			}
+		}
+	}
+}
+//-----------------------------------------------------------------------------
+
+void olcRasterLine(int x1, int y1, int x2, int y2, const sClipRect &clip, std::vector<sSpan> &vecSpans)
+{
+	LineRuns(x1, y1, x2, y2, clip, [&](int y, int a, int b) { vecSpans.push_back({ y, a, b }); });
+}
+//-----------------------------------------------------------------------------
+
+void olcRasterCircle(int xc, int yc, int r, const sClipRect &clip, std::vector<sSpan> &vecSpans)
+{
+	if(r < 0 || xc + r < clip.x1 || xc - r >= clip.x2 || yc + r < clip.y1 || yc - r >= clip.y2)
+		return;
+
+	int x = 0, y = r, p = 3 - 2 * r;
+	while(y >= x)
+	{
+		AddSpan(vecSpans, clip, yc - y, xc - x, xc - x + 1);
+		AddSpan(vecSpans, clip, yc - x, xc - y, xc - y + 1);
+		AddSpan(vecSpans, clip, yc - x, xc + y, xc + y + 1);
+		AddSpan(vecSpans, clip, yc - y, xc + x, xc + x + 1);
+		AddSpan(vecSpans, clip, yc + y, xc - x, xc - x + 1);
+		AddSpan(vecSpans, clip, yc + x, xc - y, xc - y + 1);
+		AddSpan(vecSpans, clip, yc + x, xc + y, xc + y + 1);
+		AddSpan(vecSpans, clip, yc + y, xc + x, xc + x + 1);
+		if(p < 0)
+			p += 4 * x++ + 6;
+		else
+			p += 4 * (x++ - y--) + 10;
+	}
+}
+//-----------------------------------------------------------------------------
+
+void olcRasterFillCircle(int xc, int yc, int r, const sClipRect &clip, std::vector<sSpan> &vecSpans)
+{
+	if(r < 0 || xc + r < clip.x1 || xc - r >= clip.x2 || yc + r < clip.y1 || yc - r >= clip.y2)
+		return;
+
+	int x = 0, y = r, p = 3 - 2 * r;
+	while(y >= x)
+	{
+		AddSpan(vecSpans, clip, yc - y, xc - x, xc + x + 1);
+		AddSpan(vecSpans, clip, yc - x, xc - y, xc + y + 1);
+		AddSpan(vecSpans, clip, yc + y, xc - x, xc + x + 1);
+		AddSpan(vecSpans, clip, yc + x, xc - y, xc + y + 1);
+		if(p < 0)
+			p += 4 * x++ + 6;
+		else
+			p += 4 * (x++ - y--) + 10;
+	}
+}
+//-----------------------------------------------------------------------------
+
+void olcRasterFillTriangle(int x1, int y1, int x2, int y2, int x3, int y3, const sClipRect &clip, std::vector<sSpan> &vecSpans)
+{
+	//-- Rows of the triangle inside the clip rectangle
+	int yMin = std::max(std::min({ y1, y2, y3 }), clip.y1);
+	int yMax = std::min(std::max({ y1, y2, y3 }), clip.y2 - 1);
+	if(yMin > yMax || std::max({ x1, x2, x3 }) < clip.x1 || std::min({ x1, x2, x3 }) >= clip.x2)
+		return;
+
+	//-- Every row's extent over the three edges. The edges are only clipped
+	//   to those rows: a part left or right of the rectangle still counts.
+	thread_local std::vector<int> vecMin, vecMax;
+	vecMin.assign(size_t(yMax - yMin + 1), INT_MAX);
+	vecMax.assign(size_t(yMax - yMin + 1), INT_MIN);
+
+	sClipRect rows = { INT_MIN / 2, yMin, INT_MAX / 2, yMax + 1 };
+	auto extend = [&](int y, int a, int b)
+	{
+		int &lo = vecMin[size_t(y - yMin)], &hi = vecMax[size_t(y - yMin)];
+		if(a < lo) lo = a;
+		if(b > hi) hi = b;
+	};
+	LineRuns(x1, y1, x2, y2, rows, extend);
+	LineRuns(x2, y2, x3, y3, rows, extend);
+	LineRuns(x3, y3, x1, y1, rows, extend);
+
+	for(int y = yMin; y <= yMax; ++y)
+		if(vecMin[size_t(y - yMin)] < vecMax[size_t(y - yMin)])
+			AddSpan(vecSpans, clip, y, vecMin[size_t(y - yMin)], vecMax[size_t(y - yMin)]);
+}
+//-----------------------------------------------------------------------------
+
+void olcRasterFillPolygon(const sRasterPoint *pPoints, int nPoints, const sClipRect &clip, std::vector<sSpan> &vecSpans)
+{
+	if(pPoints == nullptr || nPoints <= 0)
+		return;
+
+	//-- Non horizontal edges, top end first, sorted by their top row
+	struct sEdge
+	{
+		int    yTop, yBottom;	// rows yTop .. yBottom - 1 are crossed
+		double x, dxdy;			// x at the current row
+	};
+	thread_local std::vector<sEdge> vecEdges, vecActive;
+	thread_local std::vector<double> vecCrossings;
+	vecEdges.clear();
+	vecActive.clear();
+
+	int yMin = INT_MAX, yMax = INT_MIN;
+	for(int i = 0; i < nPoints; ++i)
+	{
+		sRasterPoint a = pPoints[i], b = pPoints[(i + 1) % nPoints];
+		yMin = std::min(yMin, a.y);
+		yMax = std::max(yMax, a.y);
+		if(a.y == b.y)
+			continue;
+		if(a.y > b.y)
+			std::swap(a, b);
+		double dxdy = double(b.x - a.x) / double(b.y - a.y);
+		vecEdges.push_back({ a.y, b.y, double(a.x), dxdy });
+	}
+	std::sort(vecEdges.begin(), vecEdges.end(), [](const sEdge &a, const sEdge &b) { return a.yTop < b.yTop; });
+
+	//-- Interior, sampled at each row and paired up even-odd
+	int yFirst = std::max(yMin, clip.y1);
+	int yLast  = std::min(yMax, clip.y2 - 1);
+	size_t nNext = 0;
+	for(int y = yFirst; y <= yLast; ++y)
+	{
+		while(nNext < vecEdges.size() && vecEdges[nNext].yTop <= y)
+		{
+			sEdge e = vecEdges[nNext++];
+			if(e.yBottom <= y)
+				continue;
+			e.x += e.dxdy * double(y - e.yTop);
+			vecActive.push_back(e);
+		}
+		vecActive.erase(std::remove_if(vecActive.begin(), vecActive.end(),
+			[y](const sEdge &e) { return e.yBottom <= y; }), vecActive.end());
+
+		vecCrossings.clear();
+		for(sEdge &e : vecActive)
+		{
+			vecCrossings.push_back(e.x);
+			e.x += e.dxdy;
+		}
+		std::sort(vecCrossings.begin(), vecCrossings.end());
+		for(size_t i = 0; i + 1 < vecCrossings.size(); i += 2)
+		{
+			double a = vecCrossings[i], b = vecCrossings[i + 1];
+			if(b < double(clip.x1) || a >= double(clip.x2))
+				continue;
+			a = std::max(a, double(clip.x1) - 1.0);
+			b = std::min(b, double(clip.x2));
+			AddSpan(vecSpans, clip, y, int(std::ceil(a)), int(std::floor(b)) + 1);
+		}
+	}
+
+	//-- The outline, so the filled shape covers its edges
+	for(int i = 0; i < nPoints; ++i)
+	{
+		const sRasterPoint &a = pPoints[i], &b = pPoints[(i + 1) % nPoints];
+		olcRasterLine(a.x, a.y, b.x, b.y, clip, vecSpans);
+	}
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,54 @@
+//---------------------------------------------------------------------------//
+//  Shape rasterizer.
+//
+//  Turns lines, circles, triangles and polygons into horizontal spans of
+//  cells, already clipped to a rectangle, for the drawing routines to fill
+//  a row run at a time:
+//
+//   - lines are clipped analytically before anything is walked: the part
+//     of a line inside the rectangle is found from the Bresenham error term
+//     in closed form, and each row's run is computed directly, so the cells
+//     are exactly the ones a full Bresenham walk would plot and the off
+//     screen part costs nothing
+//   - circles use the midpoint algorithm, one span per row pair and octant
+//   - triangles take each row's extent from their Bresenham edges, so a
+//     filled triangle covers its outline exactly
+//   - polygons (convex or concave, even-odd rule) are scan converted with an
+//     active edge list and include their outline
+//
+//  Spans are appended to the caller's vector, which is never cleared.
+//---------------------------------------------------------------------------//
+
+//-----------------------------------------------------------------------------
+#pragma once
+//-----------------------------------------------------------------------------
+#include <vector>
+//-----------------------------------------------------------------------------
+
+// Cells [x1, x2) of row y
+struct sSpan
+{
+	int y;
+	int x1;
+	int x2;
+};
+
+// [x1, x2) x [y1, y2)
+struct sClipRect
+{
+	int x1, y1, x2, y2;
+};
+
+struct sRasterPoint
+{
+	int x;
+	int y;
+};
+//-----------------------------------------------------------------------------
+
+void olcRasterLine(int x1, int y1, int x2, int y2, const sClipRect &clip, std::vector<sSpan> &vecSpans);
+void olcRasterCircle(int xc, int yc, int r, const sClipRect &clip, std::vector<sSpan> &vecSpans);
+void olcRasterFillCircle(int xc, int yc, int r, const sClipRect &clip, std::vector<sSpan> &vecSpans);
+void olcRasterFillTriangle(int x1, int y1, int x2, int y2, int x3, int y3, const sClipRect &clip, std::vector<sSpan> &vecSpans);
+void olcRasterFillPolygon(const sRasterPoint *pPoints, int nPoints, const sClipRect &clip, std::vector<sSpan> &vecSpans);
+//-----------------------------------------------------------------------------
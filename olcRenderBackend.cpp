@@ -0,0 +1,96 @@
+//-----------------------------------------------------------------------------
+#include "olcRenderBackend.h"
+#include "olcWin32Backend.h"
+
+#include <cstring>
+#include <thread>
+//-----------------------------------------------------------------------------
+
+void olcRenderBackend::PollKeyboard(short *pKeyState)
+{
+	memset(pKeyState, 0, 256 * sizeof(short));
+}
+//-----------------------------------------------------------------------------
+
+int olcRenderBackend::WaitInput(olcInputEvent *pEvents, int nMax, int nTimeoutMs)
+{
+	auto tpEnd = std::chrono::steady_clock::now() + std::chrono::milliseconds(nTimeoutMs);
+	short keys[256];
+	while(true)
+	{
+		PollKeyboard(keys);
+		auto tpNow = std::chrono::steady_clock::now();
+
+		//-- Report every key that changed since the last poll. Changes that
+		//   do not fit are left for the next call.
+		int n = 0;
+		for(int i = 0; i < 256 && n < nMax; ++i)
+		{
+			bool bDown = (keys[i] & 0x8000) != 0;
+			if(bDown == m_bPolledKeys[i])
+				continue;
+			m_bPolledKeys[i] = bDown;
+			pEvents[n++] = { tpNow, bDown ? INPUT_KEY_DOWN : INPUT_KEY_UP, i, 0, 0 };
+		}
+
+		if(n > 0 || tpNow >= tpEnd)
+			return n;
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+}
+//-----------------------------------------------------------------------------
+
+
+
+
+
+
+
+
+
+
+
+
+//-----------------------------------------------------------------------------
+
+int olcHeadlessBackend::Construct(int &width, int &height, int, int)
+{
+	if(width <= 0 || height <= 0)
+		return olcReportError(L"olcHeadlessBackend: invalid screen size");
+	m_nFramesPresented = 0;
+	m_nCellsPresented  = 0;
+	return 1;
+}
+//-----------------------------------------------------------------------------
+
+void olcHeadlessBackend::Present(const olcCellBuffer &, const sCellRect *pRegions, int nRegions)
+{
+	++m_nFramesPresented;
+	for(int i = 0; i < nRegions; ++i)
+		m_nCellsPresented += uint64_t(pRegions[i].Right - pRegions[i].Left + 1)
+		                   * uint64_t(pRegions[i].Bottom - pRegions[i].Top + 1);
+}
+//-----------------------------------------------------------------------------
+
+
+
+
+
+
+
+
+
+
+
+
+//-----------------------------------------------------------------------------
+
+std::unique_ptr<olcRenderBackend> olcCreateDefaultBackend()
+{
+#ifdef _WIN32
+	return std::unique_ptr<olcRenderBackend>(new olcWin32ConsoleBackend());
+#else
+	return std::unique_ptr<olcRenderBackend>(new olcHeadlessBackend());
+#endif
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,90 @@
+//---------------------------------------------------------------------------//
+//  Render backends.
+//
+//  The engine never talks to an output device directly. Everything it needs
+//  to put a frame on screen (creating the surface, presenting the screen
+//  buffer, updating the title, reading the keyboard and mouse) goes through
+//  an olcRenderBackend, so the sink can be swapped before ConstructConsole().
+//
+//  olcHeadlessBackend   - keeps the frame in memory and presents nothing.
+//                         Used for simulations, CI and benchmarking.
+//  olcWin32ConsoleBackend - the original Win32 console output (Windows only,
+//                         see olcWin32Backend.h).
+//---------------------------------------------------------------------------//
+
+//-----------------------------------------------------------------------------
+#pragma once
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <memory>
+#include <string>
+//-----------------------------------------------------------------------------
+#include "olcCellBuffer.h"
+#include "olcConsolePlatform.h"
+#include "olcInput.h"
+//-----------------------------------------------------------------------------
+
+// What the game thread does at frame end when every screen buffer is still
+// waiting to be presented (and the recorder when its queue is full)
+enum PRESENT_POLICY
+{
+	PRESENT_BLOCK       = 0,	// wait for the presenter to free a buffer
+	PRESENT_DROP_OLDEST = 1,	// replace the oldest frame not yet presented
+	PRESENT_DROP_NEWEST = 2,	// skip presenting the frame just finished
+};
+//-----------------------------------------------------------------------------
+
+class olcRenderBackend
+{
+private:
+	bool m_bPolledKeys[256] = {};
+
+public:
+	virtual ~olcRenderBackend() {}
+
+	// Create the output surface. width and height may be reduced by the
+	// backend to what the device allows. Returns 1 on success, -1 on error.
+	virtual int  Construct(int &width, int &height, int fontw, int fonth) = 0;
+
+	// Put the regions (inclusive cell rectangles) of the frame that changed
+	// since the last present on the output. nRegions may be 0.
+	virtual void Present(const olcCellBuffer &buf, const sCellRect *pRegions, int nRegions) = 0;
+
+	virtual void SetTitle(const std::wstring &) {}
+
+	// Fill pKeyState[256] with the state of every virtual key. Bit 0x8000
+	// is set while a key is held down. Backends without a keyboard report
+	// every key as released.
+	virtual void PollKeyboard(short *pKeyState);
+
+	// Called from the engine's input thread: wait up to nTimeoutMs for input
+	// and store at most nMax events in pEvents, returning how many. The
+	// default turns PollKeyboard() sampled every millisecond into events.
+	virtual int  WaitInput(olcInputEvent *pEvents, int nMax, int nTimeoutMs);
+
+	// Backends returning false get no input thread at all
+	virtual bool HasInput() const { return true; }
+};
+//-----------------------------------------------------------------------------
+
+class olcHeadlessBackend : public olcRenderBackend
+{
+private:
+	uint64_t m_nFramesPresented = 0;
+	uint64_t m_nCellsPresented  = 0;
+
+public:
+	int  Construct(int &width, int &height, int fontw, int fonth) override;
+	void Present(const olcCellBuffer &buf, const sCellRect *pRegions, int nRegions) override;
+
+	bool     HasInput() const override { return false; }
+
+	uint64_t FramesPresented() const { return m_nFramesPresented; }
+	uint64_t CellsPresented()  const { return m_nCellsPresented;  }
+};
+//-----------------------------------------------------------------------------
+
+// The backend the engine starts with: the Win32 console on Windows, the
+// headless backend everywhere else.
+std::unique_ptr<olcRenderBackend> olcCreateDefaultBackend();
+//-----------------------------------------------------------------------------
@@ -0,0 +1,294 @@
+//-----------------------------------------------------------------------------
+#include "olcSpritePack.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+//-----------------------------------------------------------------------------
+
+static uint64_t AlignUp(uint64_t n, uint64_t nAlign)
+{
+	return (n + nAlign - 1) / nAlign * nAlign;
+}
+//-----------------------------------------------------------------------------
+
+// Whether nLength bytes at nOffset fit in nSize, written so that nothing a
+// crafted file holds can wrap around
+static bool InRange(uint64_t nOffset, uint64_t nLength, uint64_t nSize)
+{
+	return nOffset <= nSize && nLength <= nSize - nOffset;
+}
+//-----------------------------------------------------------------------------
+
+olcSpritePack::~olcSpritePack()
+{
+	Close();
+}
+//-----------------------------------------------------------------------------
+
+bool olcSpritePack::Map(const std::wstring &sFile)
+{
+#ifdef _WIN32
+	HANDLE hFile = CreateFileW(sFile.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if(hFile == INVALID_HANDLE_VALUE)
+		return false;
+	m_hFile = hFile;
+
+	LARGE_INTEGER size;
+	if(!GetFileSizeEx(m_hFile, &size) || size.QuadPart == 0)
+		return false;
+	m_nSize = size_t(size.QuadPart);
+
+	m_hMapping = CreateFileMappingW(m_hFile, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+	if(m_hMapping == NULL)
+		return false;
+	m_pData = (uint8_t*)MapViewOfFile(m_hMapping, FILE_MAP_COPY, 0, 0, 0);
+	return m_pData != nullptr;
+#else
+	int fd = open(WS2S(sFile).c_str(), O_RDONLY);
+	if(fd < 0)
+		return false;
+
+	struct stat st;
+	if(fstat(fd, &st) != 0 || st.st_size == 0)
+	{
+		close(fd);
+		return false;
+	}
+	m_nSize = size_t(st.st_size);
+
+	void *p = mmap(nullptr, m_nSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if(p == MAP_FAILED)
+		return false;
+	m_pData = (uint8_t*)p;
+	return true;
+#endif
+}
+//-----------------------------------------------------------------------------
+
+void olcSpritePack::Unmap()
+{
+#ifdef _WIN32
+	if(m_pData)
+		UnmapViewOfFile(m_pData);
+	if(m_hMapping != nullptr)
+		CloseHandle(m_hMapping);
+	if(m_hFile != nullptr)
+		CloseHandle(m_hFile);
+	m_hMapping = nullptr;
+	m_hFile    = nullptr;
+#else
+	if(m_pData)
+		munmap(m_pData, m_nSize);
+#endif
+	m_pData = nullptr;
+	m_nSize = 0;
+}
+//-----------------------------------------------------------------------------
+
+bool olcSpritePack::Validate()
+{
+	if(m_nSize < sizeof(sPackHeader))
+		return false;
+
+	const sPackHeader *pHeader = (const sPackHeader*)m_pData;
+	if(memcmp(pHeader->magic, "OLCP", 4) != 0 ||
+	   pHeader->nVersion   != VERSION ||
+	   pHeader->nGlyphSize != sizeof(wchar_t) ||
+	   pHeader->nAlignment == 0 || pHeader->nAlignment % alignof(wchar_t) != 0)
+		return false;
+
+	if(pHeader->nIndexOffset % alignof(sPackEntry) != 0 ||
+	   !InRange(pHeader->nIndexOffset, uint64_t(pHeader->nSprites) * sizeof(sPackEntry), m_nSize) ||
+	   !InRange(pHeader->nNamesOffset, pHeader->nNamesSize, m_nSize))
+		return false;
+
+	//-- Check every entry up front so drawing never has to
+	const sPackEntry *pEntries = (const sPackEntry*)(m_pData + pHeader->nIndexOffset);
+	for(uint32_t i = 0; i < pHeader->nSprites; ++i)
+	{
+		const sPackEntry &e = pEntries[i];
+		if(e.nWidth <= 0 || e.nHeight <= 0 ||
+		   !InRange(e.nNameOffset, e.nNameLength, pHeader->nNamesSize) ||
+		   e.nColoursOffset % alignof(short) != 0 || e.nGlyphsOffset % alignof(wchar_t) != 0)
+			return false;
+
+		//-- No sprite has more cells than the file has bytes, which also
+		//   keeps the sizes below from overflowing
+		uint64_t nCells = uint64_t(e.nWidth) * uint64_t(e.nHeight);
+		if(nCells > m_nSize ||
+		   !InRange(e.nColoursOffset, nCells * sizeof(short),   m_nSize) ||
+		   !InRange(e.nGlyphsOffset,  nCells * sizeof(wchar_t), m_nSize))
+			return false;
+	}
+
+	m_pEntries = pEntries;
+	m_nSprites = pHeader->nSprites;
+	return true;
+}
+//-----------------------------------------------------------------------------
+
+bool olcSpritePack::Open(const std::wstring &sFile)
+{
+	Close();
+	if(!Map(sFile) || !Validate())
+	{
+		Close();
+		return false;
+	}
+	m_vecSprites.resize(m_nSprites);
+	return true;
+}
+//-----------------------------------------------------------------------------
+
+void olcSpritePack::Close()
+{
+	m_vecSprites.clear();
+	m_pEntries = nullptr;
+	m_nSprites = 0;
+	Unmap();
+}
+//-----------------------------------------------------------------------------
+
+std::string olcSpritePack::Name(int i) const
+{
+	if(i < 0 || i >= Count())
+		return std::string();
+	const sPackHeader *pHeader = (const sPackHeader*)m_pData;
+	const char *pNames = (const char*)(m_pData + pHeader->nNamesOffset);
+	return std::string(pNames + m_pEntries[i].nNameOffset, m_pEntries[i].nNameLength);
+}
+//-----------------------------------------------------------------------------
+
+int olcSpritePack::Find(const std::wstring &sName) const
+{
+	if(m_nSprites == 0)
+		return -1;
+
+	//-- Entries are sorted by name, binary search the index in place
+	const sPackHeader *pHeader = (const sPackHeader*)m_pData;
+	const char        *pNames  = (const char*)(m_pData + pHeader->nNamesOffset);
+	std::string        sKey    = WS2S(sName);
+
+	int lo = 0, hi = Count() - 1;
+	while(lo <= hi)
+	{
+		int mid = (lo + hi) / 2;
+		const sPackEntry &e = m_pEntries[mid];
+		int cmp = sKey.compare(0, std::string::npos, pNames + e.nNameOffset, e.nNameLength);
+		if(cmp == 0)
+			return mid;
+		if(cmp < 0)
+			hi = mid - 1;
+		else
+			lo = mid + 1;
+	}
+	return -1;
+}
+//-----------------------------------------------------------------------------
+
+olcSprite* olcSpritePack::Sprite(int i)
+{
+	if(i < 0 || i >= Count())
+		return nullptr;
+
+	if(!m_vecSprites[i])
+	{
+		const sPackEntry &e = m_pEntries[i];
+		m_vecSprites[i].reset(new olcSprite());
+		m_vecSprites[i]->View(e.nWidth, e.nHeight,
+		                      (wchar_t*)(m_pData + e.nGlyphsOffset),
+		                      (short*)(m_pData + e.nColoursOffset));
+	}
+	return m_vecSprites[i].get();
+}
+//-----------------------------------------------------------------------------
+
+bool olcSpritePack::Write(const std::wstring &sFile,
+                          const std::vector<std::pair<std::wstring, const olcSprite*>> &vecSprites)
+{
+	//-- Sort by name so readers can binary search the index
+	std::vector<std::pair<std::string, const olcSprite*>> vecSorted;
+	for(auto &s : vecSprites)
+		if(s.second && s.second->nWidth > 0 && s.second->nHeight > 0)
+			vecSorted.push_back({ WS2S(s.first), s.second });
+	std::sort(vecSorted.begin(), vecSorted.end(),
+		[](const std::pair<std::string, const olcSprite*> &a, const std::pair<std::string, const olcSprite*> &b)
+		{ return a.first < b.first; });
+	for(size_t i = 1; i < vecSorted.size(); ++i)
+		if(vecSorted[i].first == vecSorted[i - 1].first)
+			return false;
+
+	//-- Lay the file out
+	sPackHeader header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, "OLCP", 4);
+	header.nVersion     = VERSION;
+	header.nGlyphSize   = sizeof(wchar_t);
+	header.nSprites     = uint32_t(vecSorted.size());
+	header.nAlignment   = ALIGNMENT;
+	header.nIndexOffset = AlignUp(sizeof(sPackHeader), alignof(sPackEntry));
+	header.nNamesOffset = header.nIndexOffset + vecSorted.size() * sizeof(sPackEntry);
+
+	std::string sNames;
+	std::vector<sPackEntry> vecEntries(vecSorted.size());
+	for(size_t i = 0; i < vecSorted.size(); ++i)
+	{
+		vecEntries[i].nNameOffset = uint32_t(sNames.size());
+		vecEntries[i].nNameLength = uint32_t(vecSorted[i].first.size());
+		sNames += vecSorted[i].first;
+	}
+	header.nNamesSize = sNames.size();
+
+	uint64_t nOffset = header.nNamesOffset + header.nNamesSize;
+	for(size_t i = 0; i < vecSorted.size(); ++i)
+	{
+		const olcSprite *s = vecSorted[i].second;
+		uint64_t nCells = uint64_t(s->nWidth) * uint64_t(s->nHeight);
+		vecEntries[i].nWidth         = s->nWidth;
+		vecEntries[i].nHeight        = s->nHeight;
+		vecEntries[i].nColoursOffset = AlignUp(nOffset, ALIGNMENT);
+		vecEntries[i].nGlyphsOffset  = AlignUp(vecEntries[i].nColoursOffset + nCells * sizeof(short), ALIGNMENT);
+		nOffset = vecEntries[i].nGlyphsOffset + nCells * sizeof(wchar_t);
+	}
+
+	//-- Write it
+	std::ofstream f(WS2S(sFile).c_str(), std::ios_base::binary);
+	if(!f.is_open())
+		return false;
+
+	static const char zeros[ALIGNMENT] = {};
+	auto pad = [&](uint64_t nTo)
+	{
+		uint64_t nAt = uint64_t(f.tellp());
+		if(nTo > nAt)
+			f.write(zeros, std::streamsize(nTo - nAt));
+	};
+
+	f.write((const char*)&header, sizeof(header));
+	pad(header.nIndexOffset);
+	f.write((const char*)vecEntries.data(), std::streamsize(vecEntries.size() * sizeof(sPackEntry)));
+	f.write(sNames.data(), std::streamsize(sNames.size()));
+	for(size_t i = 0; i < vecSorted.size(); ++i)
+	{
+		const olcSprite *s = vecSorted[i].second;
+		size_t nCells = size_t(s->nWidth) * size_t(s->nHeight);
+		pad(vecEntries[i].nColoursOffset);
+		f.write((const char*)s->Colours(), std::streamsize(nCells * sizeof(short)));
+		pad(vecEntries[i].nGlyphsOffset);
+		f.write((const char*)s->Glyphs(), std::streamsize(nCells * sizeof(wchar_t)));
+	}
+
+	return bool(f);
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,98 @@
+//---------------------------------------------------------------------------//
+//  Sprite packs.
+//
+//  A pack is a single file holding many sprites, meant to be memory mapped
+//  instead of opening and reading one .spr file per sprite:
+//
+//    sPackHeader                   magic "OLCP", version, glyph size, counts
+//    sPackEntry[nSprites]          sorted by name
+//    names                         UTF-8, not terminated
+//    cell data                     per sprite: colours, then glyphs, each
+//                                  block aligned to nAlignment bytes
+//
+//  Glyphs are stored with the writer's wchar_t size, so a pack is only
+//  opened on a platform with the same wchar_t as the one that wrote it.
+//
+//  Sprites handed out by a pack are views into the mapping: nothing is
+//  copied, and their cells are only paged in when first drawn. The mapping
+//  is copy-on-write, so SetGlyph()/SetColour() work but never reach the
+//  file. Views are only valid while the pack is open.
+//---------------------------------------------------------------------------//
+
+//-----------------------------------------------------------------------------
+#pragma once
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+//-----------------------------------------------------------------------------
+#include "olcConsoleGameEngine.h"
+//-----------------------------------------------------------------------------
+
+class olcSpritePack
+{
+public:
+	static const uint16_t VERSION   = 1;
+	static const uint32_t ALIGNMENT = 16;
+
+	struct sPackHeader
+	{
+		char     magic[4];
+		uint16_t nVersion;
+		uint16_t nGlyphSize;
+		uint32_t nSprites;
+		uint32_t nAlignment;
+		uint64_t nIndexOffset;
+		uint64_t nNamesOffset;
+		uint64_t nNamesSize;
+	};
+
+	struct sPackEntry
+	{
+		uint32_t nNameOffset;
+		uint32_t nNameLength;
+		int32_t  nWidth;
+		int32_t  nHeight;
+		uint64_t nColoursOffset;
+		uint64_t nGlyphsOffset;
+	};
+
+private:
+	uint8_t*          m_pData = nullptr;
+	size_t            m_nSize = 0;
+#ifdef _WIN32
+	void*             m_hFile    = nullptr;	// HANDLEs, without <windows.h>
+	void*             m_hMapping = nullptr;
+#endif
+	const sPackEntry* m_pEntries = nullptr;
+	uint32_t          m_nSprites = 0;
+	std::vector<std::unique_ptr<olcSprite>> m_vecSprites;
+
+	bool Map(const std::wstring &sFile);
+	void Unmap();
+	bool Validate();
+
+public:
+	olcSpritePack() {}
+	~olcSpritePack();
+	olcSpritePack(const olcSpritePack&) = delete;
+	olcSpritePack& operator=(const olcSpritePack&) = delete;
+
+	bool Open(const std::wstring &sFile);
+	void Close();
+
+	int         Count() const { return int(m_nSprites); }
+	std::string Name(int i) const;
+	int         Find(const std::wstring &sName) const;
+
+	// The sprite view, created on first request. nullptr if not found.
+	olcSprite*  Sprite(int i);
+	olcSprite*  Sprite(const std::wstring &sName) { return Sprite(Find(sName)); }
+
+	// Write a pack holding the given named sprites
+	static bool Write(const std::wstring &sFile,
+	                  const std::vector<std::pair<std::wstring, const olcSprite*>> &vecSprites);
+};
+//-----------------------------------------------------------------------------
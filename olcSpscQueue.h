@@ -0,0 +1,67 @@
+//---------------------------------------------------------------------------//
+//  Lock-free single producer / single consumer ring buffer.
+//
+//  One thread may Push() and one (other) thread may Pop(); neither ever
+//  blocks. The capacity is rounded up to a power of two.
+//---------------------------------------------------------------------------//
+
+//-----------------------------------------------------------------------------
+#pragma once
+//-----------------------------------------------------------------------------
+#include <atomic>
+#include <cstddef>
+#include <memory>
+//-----------------------------------------------------------------------------
+
+template<typename T>
+class olcSpscQueue
+{
+private:
+	std::unique_ptr<T[]> m_buf;
+	size_t               m_nMask;
+
+	// Kept on separate cache lines so producer and consumer do not fight
+	alignas(64) std::atomic<size_t> m_nHead;	// next slot to pop
+	alignas(64) std::atomic<size_t> m_nTail;	// next slot to push
+
+public:
+	explicit olcSpscQueue(size_t nCapacity)
+		: m_nHead(0)
+		, m_nTail(0)
+	{
+		size_t n = 1;
+		while(n < nCapacity)
+			n <<= 1;
+		m_buf.reset(new T[n]);
+		m_nMask = n - 1;
+	}
+
+	olcSpscQueue(const olcSpscQueue&) = delete;
+	olcSpscQueue& operator=(const olcSpscQueue&) = delete;
+
+	// Producer side. Returns false when the queue is full.
+	bool Push(const T &item)
+	{
+		size_t nTail = m_nTail.load(std::memory_order_relaxed);
+		if(nTail - m_nHead.load(std::memory_order_acquire) > m_nMask)
+			return false;
+		m_buf[nTail & m_nMask] = item;
+		m_nTail.store(nTail + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Consumer side. Returns false when the queue is empty.
+	bool Pop(T &item)
+	{
+		size_t nHead = m_nHead.load(std::memory_order_relaxed);
+		if(nHead == m_nTail.load(std::memory_order_acquire))
+			return false;
+		item = m_buf[nHead & m_nMask];
+		m_nHead.store(nHead + 1, std::memory_order_release);
+		return true;
+	}
+
+	bool   Empty() const    { return m_nHead.load(std::memory_order_acquire) == m_nTail.load(std::memory_order_acquire); }
+	size_t Capacity() const { return m_nMask + 1; }
+};
+//-----------------------------------------------------------------------------
@@ -0,0 +1,75 @@
+//-----------------------------------------------------------------------------
+#include "olcText.h"
+
+#include <algorithm>
+#include <climits>
+//-----------------------------------------------------------------------------
+
+void olcLayoutText(std::wstring_view s, int nWidth, TEXT_ALIGN align, std::vector<sTextLine> &vecLines, int nAdvance)
+{
+	vecLines.clear();
+	nAdvance = std::max(nAdvance, 1);
+	const size_t nMax = nWidth > 0 ? size_t(std::max(nWidth / nAdvance, 1)) : SIZE_MAX;
+
+	size_t i = 0;
+	while(i < s.size())
+	{
+		size_t nEnd = s.find(L'\n', i);
+		if(nEnd == std::wstring_view::npos)
+			nEnd = s.size();
+
+		if(nEnd - i <= nMax)
+		{
+			vecLines.push_back({ int(i), int(nEnd - i), 0 });
+			i = nEnd + 1;
+			continue;
+		}
+
+		//-- Too long: wrap at the last space that fits (one just past the
+		//   end will do), or cut the word when nothing but spaces precede it
+		size_t nBreak = i + nMax;
+		while(nBreak > i && s[nBreak] != L' ')
+			--nBreak;
+		size_t nLast = nBreak;
+		while(nLast > i && s[nLast - 1] == L' ')
+			--nLast;
+		if(nLast == i)
+			nBreak = nLast = i + nMax;
+		vecLines.push_back({ int(i), int(nLast - i), 0 });
+		i = nBreak;
+		while(i < nEnd && s[i] == L' ')
+			++i;
+
+		//-- Spaces running up to the newline end this line, not the next
+		if(i == nEnd && nEnd < s.size())
+			++i;
+	}
+
+	if(align == TEXT_LEFT)
+		return;
+
+	int nBox = nWidth;
+	if(nBox <= 0)
+		for(const sTextLine &line : vecLines)
+			nBox = std::max(nBox, line.nLength * nAdvance);
+	for(sTextLine &line : vecLines)
+	{
+		int nSpare   = nBox - line.nLength * nAdvance;
+		line.nOffset = align == TEXT_CENTRE ? nSpare / 2 : nSpare;
+	}
+}
+//-----------------------------------------------------------------------------
+
+bool olcTextRun::Set(std::wstring_view s, int nWidth, TEXT_ALIGN align, int nAdvance)
+{
+	if(s == m_sText && nWidth == m_nWidth && align == m_nAlign && nAdvance == m_nAdvance)
+		return false;
+
+	m_sText.assign(s.data(), s.size());
+	m_nWidth   = nWidth;
+	m_nAlign   = align;
+	m_nAdvance = nAdvance;
+	olcLayoutText(m_sText, nWidth, align, m_vecLines, nAdvance);
+	return true;
+}
+//-----------------------------------------------------------------------------
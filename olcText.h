@@ -0,0 +1,67 @@
+//---------------------------------------------------------------------------//
+//  Text layout.
+//
+//  Breaks a string into lines for the engine's text routines: at '\n', and
+//  when a width is given, at the last space that still fits (mid-word only
+//  when a word alone is wider than the line). Spaces at a wrap are dropped.
+//  Every line is then aligned within the width, or within the widest line
+//  when there is none.
+//
+//  Laying out costs a pass over the string. Text that rarely changes can be
+//  kept laid out in an olcTextRun, which only redoes the work when it is
+//  given something different.
+//---------------------------------------------------------------------------//
+
+//-----------------------------------------------------------------------------
+#pragma once
+//-----------------------------------------------------------------------------
+#include <string>
+#include <string_view>
+#include <vector>
+//-----------------------------------------------------------------------------
+
+enum TEXT_ALIGN
+{
+	TEXT_LEFT   = 0,
+	TEXT_CENTRE = 1,
+	TEXT_RIGHT  = 2,
+};
+//-----------------------------------------------------------------------------
+
+// nLength characters of the text from nStart, drawn nOffset columns into
+// the line
+struct sTextLine
+{
+	int nStart;
+	int nLength;
+	int nOffset;
+};
+//-----------------------------------------------------------------------------
+
+// Lay s out in lines of at most nWidth columns (0 for no limit), each
+// character nAdvance columns wide. vecLines is replaced.
+void olcLayoutText(std::wstring_view s, int nWidth, TEXT_ALIGN align, std::vector<sTextLine> &vecLines, int nAdvance = 1);
+//-----------------------------------------------------------------------------
+
+class olcTextRun
+{
+private:
+	std::wstring           m_sText;
+	std::vector<sTextLine> m_vecLines;
+	int                    m_nWidth   = 0;
+	int                    m_nAdvance = 1;
+	TEXT_ALIGN             m_nAlign   = TEXT_LEFT;
+
+public:
+	olcTextRun() {}
+	olcTextRun(std::wstring_view s, int nWidth = 0, TEXT_ALIGN align = TEXT_LEFT, int nAdvance = 1) { Set(s, nWidth, align, nAdvance); }
+
+	// Lay s out as olcLayoutText() does. Returns false, without doing any
+	// work, when the run already holds exactly that.
+	bool Set(std::wstring_view s, int nWidth = 0, TEXT_ALIGN align = TEXT_LEFT, int nAdvance = 1);
+
+	const std::wstring&           Text() const    { return m_sText; }
+	const std::vector<sTextLine>& Lines() const   { return m_vecLines; }
+	int                           Advance() const { return m_nAdvance; }
+};
+//-----------------------------------------------------------------------------
@@ -0,0 +1,341 @@
+//-----------------------------------------------------------------------------
+#include "olcTilemap.h"
+
+#include <algorithm>
+#include <cstring>
+//-----------------------------------------------------------------------------
+
+bool olcTileset::Create(const olcSprite *sprite, int nTileWidth, int nTileHeight)
+{
+	m_nTileWidth = m_nTileHeight = m_nStride = 0;
+	m_vecGlyphs.clear();
+	m_vecAttributes.clear();
+	m_vecOffsets.clear();
+	m_vecSolid.clear();
+	if(sprite == nullptr || nTileWidth <= 0 || nTileHeight <= 0)
+		return false;
+	int nColumns = sprite->nWidth / nTileWidth, nRows = sprite->nHeight / nTileHeight;
+	if(nColumns == 0 || nRows == 0)
+		return false;
+
+	m_nTileWidth  = nTileWidth;
+	m_nTileHeight = nTileHeight;
+	m_nStride     = sprite->nWidth;
+	size_t nCells = size_t(sprite->nWidth) * size_t(sprite->nHeight);
+	m_vecGlyphs.assign(sprite->Glyphs(), sprite->Glyphs() + nCells);
+	m_vecAttributes.resize(nCells);
+	for(size_t i = 0; i < nCells; ++i)
+		m_vecAttributes[i] = uint8_t(sprite->Colours()[i]);
+
+	//-- EMPTY is never a tile
+	int nTiles = std::min(nColumns * nRows, int(olcTilemap::EMPTY));
+	for(int n = 0; n < nTiles; ++n)
+	{
+		m_vecOffsets.push_back((n / nColumns) * nTileHeight * m_nStride + (n % nColumns) * nTileWidth);
+		for(int r = 0; r < nTileHeight; ++r)
+		{
+			const wchar_t *glyphs = RowGlyphs(n, r);
+			m_vecSolid.push_back(std::find(glyphs, glyphs + nTileWidth, L' ') == glyphs + nTileWidth);
+		}
+	}
+	return true;
+}
+//-----------------------------------------------------------------------------
+
+const uint16_t olcTilemap::EMPTY;
+//-----------------------------------------------------------------------------
+
+olcTilemap::~olcTilemap()
+{
+	Close();
+}
+//-----------------------------------------------------------------------------
+
+bool olcTilemap::SetSize(int nWidth, int nHeight, int nChunkSize)
+{
+	if(nWidth <= 0 || nHeight <= 0 || nChunkSize <= 0 || nChunkSize > 1024)
+		return false;
+	m_nWidth     = nWidth;
+	m_nHeight    = nHeight;
+	m_nChunkSize = nChunkSize;
+	m_nChunksX   = (nWidth  + nChunkSize - 1) / nChunkSize;
+	m_nChunksY   = (nHeight + nChunkSize - 1) / nChunkSize;
+	return true;
+}
+//-----------------------------------------------------------------------------
+
+bool olcTilemap::Create(int nWidth, int nHeight, int nChunkSize)
+{
+	Close();
+	return SetSize(nWidth, nHeight, nChunkSize);
+}
+//-----------------------------------------------------------------------------
+
+bool olcTilemap::Open(const std::wstring &sFile, size_t nMaxChunks, int nMargin)
+{
+	Close();
+	m_file.open(WS2S(sFile), std::ios::binary);
+	if(!m_file)
+		return false;
+
+	sMapHeader header;
+	if(!m_file.read((char*)&header, sizeof(header)) ||
+	   memcmp(header.magic, "OLCM", 4) != 0 || header.nVersion != VERSION ||
+	   !SetSize(header.nWidth, header.nHeight, header.nChunkSize))
+	{
+		Close();
+		return false;
+	}
+
+	//-- Every chunk must be there, so the loader never reads short
+	uint64_t nSize = sizeof(sMapHeader) + uint64_t(m_nChunksX) * uint64_t(m_nChunksY) * uint64_t(m_nChunkSize) * uint64_t(m_nChunkSize) * sizeof(uint16_t);
+	m_file.seekg(0, std::ios::end);
+	if(!m_file || uint64_t(m_file.tellg()) < nSize)
+	{
+		Close();
+		return false;
+	}
+
+	m_nMaxChunks = std::max(nMaxChunks, size_t(1));
+	m_nMargin    = std::max(nMargin, 0);
+	m_bQuit      = false;
+	m_threadLoader = std::thread(&olcTilemap::LoaderThread, this);
+	return true;
+}
+//-----------------------------------------------------------------------------
+
+void olcTilemap::Close()
+{
+	if(m_threadLoader.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(m_mux);
+			m_bQuit = true;
+		}
+		m_cvLoad.notify_all();
+		m_threadLoader.join();
+	}
+	if(m_file.is_open())
+		m_file.close();
+	m_file.clear();
+
+	m_queueLoad.clear();
+	m_vecLoaded.clear();
+	m_vecFree.clear();
+	m_setPending.clear();
+	m_mapChunks.clear();
+	m_vecView.clear();
+	m_nViewX = m_nViewY = m_nViewW = 0;
+	m_bLoading = false;
+	m_nWidth = m_nHeight = m_nChunkSize = m_nChunksX = m_nChunksY = 0;
+}
+//-----------------------------------------------------------------------------
+
+bool olcTilemap::Save(const std::wstring &sFile) const
+{
+	if(IsStreaming() || m_nChunkSize == 0)
+		return false;
+
+	std::ofstream file(WS2S(sFile), std::ios::binary);
+	if(!file)
+		return false;
+
+	sMapHeader header;
+	memcpy(header.magic, "OLCM", 4);
+	header.nVersion   = VERSION;
+	header.nChunkSize = uint16_t(m_nChunkSize);
+	header.nWidth     = m_nWidth;
+	header.nHeight    = m_nHeight;
+	file.write((const char*)&header, sizeof(header));
+
+	const std::vector<uint16_t> vecEmpty(size_t(m_nChunkSize) * size_t(m_nChunkSize), EMPTY);
+	for(int cy = 0; cy < m_nChunksY; ++cy)
+	{
+		for(int cx = 0; cx < m_nChunksX; ++cx)
+		{
+			auto it = m_mapChunks.find(Key(cx, cy));
+			const std::vector<uint16_t> &vecTiles = it != m_mapChunks.end() ? it->second.vecTiles : vecEmpty;
+			file.write((const char*)vecTiles.data(), std::streamsize(vecTiles.size() * sizeof(uint16_t)));
+		}
+	}
+	return bool(file);
+}
+//-----------------------------------------------------------------------------
+
+uint16_t olcTilemap::GetTile(int x, int y) const
+{
+	if(x < 0 || y < 0 || x >= m_nWidth || y >= m_nHeight)
+		return EMPTY;
+	auto it = m_mapChunks.find(Key(x / m_nChunkSize, y / m_nChunkSize));
+	if(it == m_mapChunks.end())
+		return EMPTY;
+	return it->second.vecTiles[size_t((y % m_nChunkSize) * m_nChunkSize + x % m_nChunkSize)];
+}
+//-----------------------------------------------------------------------------
+
+bool olcTilemap::SetTile(int x, int y, uint16_t nTile)
+{
+	if(IsStreaming() || x < 0 || y < 0 || x >= m_nWidth || y >= m_nHeight)
+		return false;
+	sChunk &chunk = m_mapChunks[Key(x / m_nChunkSize, y / m_nChunkSize)];
+	if(chunk.vecTiles.empty())
+	{
+		chunk.vecTiles.assign(size_t(m_nChunkSize) * size_t(m_nChunkSize), EMPTY);
+		chunk.nLastViewed = m_nFrame;
+	}
+	chunk.vecTiles[size_t((y % m_nChunkSize) * m_nChunkSize + x % m_nChunkSize)] = nTile;
+	return true;
+}
+//-----------------------------------------------------------------------------
+
+void olcTilemap::LoaderThread()
+{
+	const size_t nTiles = size_t(m_nChunkSize) * size_t(m_nChunkSize);
+
+	std::unique_lock<std::mutex> lock(m_mux);
+	while(true)
+	{
+		m_cvLoad.wait(lock, [&] { return m_bQuit || !m_queueLoad.empty(); });
+		if(m_bQuit)
+			break;
+
+		uint64_t nKey = m_queueLoad.front();
+		m_queueLoad.pop_front();
+		std::vector<uint16_t> vecTiles;
+		if(!m_vecFree.empty())
+		{
+			vecTiles = std::move(m_vecFree.back());
+			m_vecFree.pop_back();
+		}
+		m_bLoading = true;
+		lock.unlock();
+
+		//-- Chunks are stored row by row, all the same size
+		uint64_t nChunk = (nKey >> 32) * uint64_t(m_nChunksX) + uint32_t(nKey);
+		vecTiles.resize(nTiles);
+		m_file.seekg(std::streamoff(sizeof(sMapHeader) + nChunk * nTiles * sizeof(uint16_t)));
+		if(!m_file.read((char*)vecTiles.data(), std::streamsize(nTiles * sizeof(uint16_t))))
+		{
+			m_file.clear();
+			std::fill(vecTiles.begin(), vecTiles.end(), EMPTY);
+		}
+
+		lock.lock();
+		m_vecLoaded.push_back({ nKey, std::move(vecTiles) });
+		m_bLoading = false;
+		if(m_queueLoad.empty())
+			m_cvIdle.notify_all();
+	}
+}
+//-----------------------------------------------------------------------------
+
+void olcTilemap::Install()
+{
+	for(sLoaded &loaded : m_vecLoaded)
+	{
+		m_setPending.erase(loaded.nKey);
+		m_mapChunks[loaded.nKey] = { std::move(loaded.vecTiles), m_nFrame };
+	}
+	m_vecLoaded.clear();
+}
+//-----------------------------------------------------------------------------
+
+void olcTilemap::Evict()
+{
+	if(m_mapChunks.size() <= m_nMaxChunks)
+		return;
+
+	//-- Oldest first, never one in the current view
+	std::vector<std::pair<uint64_t, uint64_t>> vecOld;
+	for(auto &chunk : m_mapChunks)
+		if(chunk.second.nLastViewed < m_nFrame)
+			vecOld.push_back({ chunk.second.nLastViewed, chunk.first });
+	size_t nEvict = std::min(m_mapChunks.size() - m_nMaxChunks, vecOld.size());
+	std::partial_sort(vecOld.begin(), vecOld.begin() + std::ptrdiff_t(nEvict), vecOld.end());
+
+	std::lock_guard<std::mutex> lock(m_mux);
+	for(size_t i = 0; i < nEvict; ++i)
+	{
+		auto it = m_mapChunks.find(vecOld[i].second);
+		if(m_vecFree.size() < 16)
+			m_vecFree.push_back(std::move(it->second.vecTiles));
+		m_mapChunks.erase(it);
+	}
+}
+//-----------------------------------------------------------------------------
+
+void olcTilemap::Stream(int tx1, int ty1, int tx2, int ty2)
+{
+	++m_nFrame;
+	int cx1 = tx1 / m_nChunkSize, cy1 = ty1 / m_nChunkSize;
+	int cx2 = tx2 / m_nChunkSize, cy2 = ty2 / m_nChunkSize;
+
+	if(IsStreaming())
+	{
+		int mx1 = std::max(cx1 - m_nMargin, 0), my1 = std::max(cy1 - m_nMargin, 0);
+		int mx2 = std::min(cx2 + m_nMargin, m_nChunksX - 1), my2 = std::min(cy2 + m_nMargin, m_nChunksY - 1);
+		auto request = [&](int cx, int cy)
+		{
+			uint64_t nKey = Key(cx, cy);
+			if(m_mapChunks.count(nKey) == 0 && m_setPending.insert(nKey).second)
+				m_queueLoad.push_back(nKey);
+		};
+
+		{
+			std::lock_guard<std::mutex> lock(m_mux);
+			Install();
+
+			//-- Forget queued chunks the camera has moved away from
+			for(auto it = m_queueLoad.begin(); it != m_queueLoad.end(); )
+			{
+				int cx = int(uint32_t(*it)), cy = int(*it >> 32);
+				if(cx >= mx1 && cx <= mx2 && cy >= my1 && cy <= my2)
+				{
+					++it;
+					continue;
+				}
+				m_setPending.erase(*it);
+				it = m_queueLoad.erase(it);
+			}
+
+			//-- The view first, then the margin around it
+			for(int cy = cy1; cy <= cy2; ++cy)
+				for(int cx = cx1; cx <= cx2; ++cx)
+					request(cx, cy);
+			for(int cy = my1; cy <= my2; ++cy)
+				for(int cx = mx1; cx <= mx2; ++cx)
+					if(cx < cx1 || cx > cx2 || cy < cy1 || cy > cy2)
+						request(cx, cy);
+		}
+		m_cvLoad.notify_one();
+	}
+
+	m_nViewX = cx1;
+	m_nViewY = cy1;
+	m_nViewW = cx2 - cx1 + 1;
+	m_vecView.assign(size_t(m_nViewW) * size_t(cy2 - cy1 + 1), nullptr);
+	for(int cy = cy1; cy <= cy2; ++cy)
+	{
+		for(int cx = cx1; cx <= cx2; ++cx)
+		{
+			auto it = m_mapChunks.find(Key(cx, cy));
+			if(it == m_mapChunks.end())
+				continue;
+			it->second.nLastViewed = m_nFrame;
+			m_vecView[size_t((cy - cy1) * m_nViewW + (cx - cx1))] = it->second.vecTiles.data();
+		}
+	}
+
+	if(IsStreaming())
+		Evict();
+}
+//-----------------------------------------------------------------------------
+
+void olcTilemap::Wait()
+{
+	if(!IsStreaming())
+		return;
+	std::unique_lock<std::mutex> lock(m_mux);
+	m_cvIdle.wait(lock, [&] { return m_queueLoad.empty() && !m_bLoading; });
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,180 @@
+//---------------------------------------------------------------------------//
+//  Tilemaps.
+//
+//  An olcTileset cuts a sprite into a grid of equally sized tiles, numbered
+//  left to right and top to bottom. Its cells are copied into glyph and
+//  attribute planes, with the offset of every tile resolved up front and
+//  the rows without any L' ' flagged, so drawing a tile row is either two
+//  block copies or a copy that skips the transparent cells.
+//
+//  An olcTilemap holds a tile index per map cell, in square chunks. A map
+//  either lives in memory (Create(), chunks allocated on first SetTile())
+//  or is streamed from a map file (Open()):
+//
+//    sMapHeader                    magic "OLCM", version, chunk size, size
+//    chunks                        row by row, chunk size squared uint16_t
+//                                  tile indices each, edge chunks padded
+//                                  with EMPTY
+//
+//  When streaming, Stream() asks the loader thread for the chunks around
+//  the view and evicts the least recently viewed ones once more than the
+//  budget are held, so only a window of a huge map is ever in memory.
+//  Chunks still loading read as EMPTY for the frames until they arrive.
+//
+//  The engine draws a map with DrawTilemap(), which only visits the tiles
+//  under the draw target.
+//---------------------------------------------------------------------------//
+
+//-----------------------------------------------------------------------------
+#pragma once
+//-----------------------------------------------------------------------------
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+//-----------------------------------------------------------------------------
+#include "olcConsoleGameEngine.h"
+//-----------------------------------------------------------------------------
+
+class olcTileset
+{
+private:
+	int                  m_nTileWidth  = 0;
+	int                  m_nTileHeight = 0;
+	int                  m_nStride     = 0;		// cells per row of the planes
+	std::vector<wchar_t> m_vecGlyphs;
+	std::vector<uint8_t> m_vecAttributes;
+	std::vector<int>     m_vecOffsets;		// per tile, its top left cell
+	std::vector<uint8_t> m_vecSolid;		// per tile row, no L' ' in it
+
+public:
+	olcTileset() {}
+	olcTileset(const olcSprite *sprite, int nTileWidth, int nTileHeight) { Create(sprite, nTileWidth, nTileHeight); }
+
+	// False (and no tiles) unless at least one whole tile fits the sprite
+	bool Create(const olcSprite *sprite, int nTileWidth, int nTileHeight);
+
+	int  TileWidth() const  { return m_nTileWidth;  }
+	int  TileHeight() const { return m_nTileHeight; }
+	int  Count() const      { return int(m_vecOffsets.size()); }
+
+	// Row nRow of tile nTile, TileWidth() cells
+	inline const wchar_t* RowGlyphs(int nTile, int nRow) const     { return m_vecGlyphs.data()     + m_vecOffsets[nTile] + nRow * m_nStride; }
+	inline const uint8_t* RowAttributes(int nTile, int nRow) const { return m_vecAttributes.data() + m_vecOffsets[nTile] + nRow * m_nStride; }
+	inline bool           RowSolid(int nTile, int nRow) const      { return m_vecSolid[size_t(nTile) * size_t(m_nTileHeight) + size_t(nRow)] != 0; }
+};
+//-----------------------------------------------------------------------------
+
+class olcTilemap
+{
+public:
+	static const uint16_t VERSION = 1;
+	static const uint16_t EMPTY   = 0xFFFF;	// drawn as nothing
+
+	struct sMapHeader
+	{
+		char     magic[4];
+		uint16_t nVersion;
+		uint16_t nChunkSize;
+		int32_t  nWidth;
+		int32_t  nHeight;
+	};
+
+private:
+	struct sChunk
+	{
+		std::vector<uint16_t> vecTiles;
+		uint64_t              nLastViewed;
+	};
+	struct sLoaded
+	{
+		uint64_t              nKey;
+		std::vector<uint16_t> vecTiles;
+	};
+
+	int                  m_nWidth     = 0;		// in tiles
+	int                  m_nHeight    = 0;
+	int                  m_nChunkSize = 0;
+	int                  m_nChunksX   = 0;
+	int                  m_nChunksY   = 0;
+	std::unordered_map<uint64_t, sChunk> m_mapChunks;	// the chunks in memory
+	uint64_t             m_nFrame     = 0;
+
+	// The chunks of the last Stream() range, row by row, nullptr if absent
+	std::vector<const uint16_t*> m_vecView;
+	int                  m_nViewX = 0, m_nViewY = 0, m_nViewW = 0;
+
+	// Streaming. Only the loader thread reads the file; the queues and the
+	// free list are shared under m_mux, everything else is the game thread's.
+	std::ifstream        m_file;
+	size_t               m_nMaxChunks = 0;
+	int                  m_nMargin    = 0;
+	std::unordered_set<uint64_t> m_setPending;	// queued or loading
+	std::thread          m_threadLoader;
+	std::mutex           m_mux;
+	std::condition_variable m_cvLoad;
+	std::condition_variable m_cvIdle;
+	std::deque<uint64_t> m_queueLoad;
+	std::vector<sLoaded> m_vecLoaded;
+	std::vector<std::vector<uint16_t>> m_vecFree;
+	bool                 m_bLoading   = false;
+	bool                 m_bQuit      = false;
+
+	static uint64_t Key(int cx, int cy) { return (uint64_t(uint32_t(cy)) << 32) | uint32_t(cx); }
+
+	bool SetSize(int nWidth, int nHeight, int nChunkSize);
+	void LoaderThread();
+	void Install();
+	void Evict();
+
+public:
+	olcTilemap() {}
+	~olcTilemap();
+	olcTilemap(const olcTilemap&) = delete;
+	olcTilemap& operator=(const olcTilemap&) = delete;
+
+	// An empty map held in memory, nWidth x nHeight tiles
+	bool Create(int nWidth, int nHeight, int nChunkSize = 32);
+	// Stream a map file, keeping about nMaxChunks chunks in memory and
+	// fetching nMargin chunks beyond the view ahead of the camera
+	bool Open(const std::wstring &sFile, size_t nMaxChunks = 256, int nMargin = 1);
+	void Close();
+
+	// Write a map held in memory out as a map file
+	bool Save(const std::wstring &sFile) const;
+
+	int  Width() const       { return m_nWidth;  }
+	int  Height() const      { return m_nHeight; }
+	int  ChunkSize() const   { return m_nChunkSize; }
+	bool IsStreaming() const { return m_threadLoader.joinable(); }
+	// Chunks in memory right now
+	size_t Resident() const  { return m_mapChunks.size(); }
+
+	// EMPTY outside the map and in chunks not in memory. Setting only works
+	// on maps held in memory.
+	uint16_t GetTile(int x, int y) const;
+	bool     SetTile(int x, int y, uint16_t nTile);
+
+	// Get the tiles of [tx1, tx2] x [ty1, ty2] (inclusive, inside the map)
+	// ready for ViewRow(): take in the chunks loaded since the last call,
+	// queue up the missing ones and evict over the budget
+	void Stream(int tx1, int ty1, int tx2, int ty2);
+	// Block until every queued chunk has loaded. The next Stream() takes
+	// them in.
+	void Wait();
+
+	// Row y of chunk column cx, ChunkSize() tiles, in the range last passed
+	// to Stream(). nullptr while the chunk is not in memory.
+	inline const uint16_t* ViewRow(int cx, int y) const
+	{
+		const uint16_t *pChunk = m_vecView[size_t((y / m_nChunkSize - m_nViewY) * m_nViewW + (cx - m_nViewX))];
+		return pChunk ? pChunk + (y % m_nChunkSize) * m_nChunkSize : nullptr;
+	}
+};
+//-----------------------------------------------------------------------------
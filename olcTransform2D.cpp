@@ -0,0 +1,85 @@
+//-----------------------------------------------------------------------------
+#include "olcTransform2D.h"
+
+#include <cmath>
+//-----------------------------------------------------------------------------
+
+void olcTransform2D::Reset()
+{
+	m[0][0] = 1.0f; m[0][1] = 0.0f; m[0][2] = 0.0f;
+	m[1][0] = 0.0f; m[1][1] = 1.0f; m[1][2] = 0.0f;
+}
+//-----------------------------------------------------------------------------
+
+void olcTransform2D::Multiply(const olcTransform2D &t)
+{
+	float r[2][3];
+	for(int i = 0; i < 2; ++i)
+	{
+		r[i][0] = t.m[i][0] * m[0][0] + t.m[i][1] * m[1][0];
+		r[i][1] = t.m[i][0] * m[0][1] + t.m[i][1] * m[1][1];
+		r[i][2] = t.m[i][0] * m[0][2] + t.m[i][1] * m[1][2] + t.m[i][2];
+	}
+	for(int i = 0; i < 2; ++i)
+		for(int j = 0; j < 3; ++j)
+			m[i][j] = r[i][j];
+}
+//-----------------------------------------------------------------------------
+
+void olcTransform2D::Rotate(float fTheta)
+{
+	olcTransform2D t;
+	t.m[0][0] = std::cos(fTheta); t.m[0][1] = -std::sin(fTheta);
+	t.m[1][0] = std::sin(fTheta); t.m[1][1] =  std::cos(fTheta);
+	Multiply(t);
+}
+//-----------------------------------------------------------------------------
+
+void olcTransform2D::Scale(float sx, float sy)
+{
+	olcTransform2D t;
+	t.m[0][0] = sx;
+	t.m[1][1] = sy;
+	Multiply(t);
+}
+//-----------------------------------------------------------------------------
+
+void olcTransform2D::Shear(float sx, float sy)
+{
+	olcTransform2D t;
+	t.m[0][1] = sx;
+	t.m[1][0] = sy;
+	Multiply(t);
+}
+//-----------------------------------------------------------------------------
+
+void olcTransform2D::Translate(float ox, float oy)
+{
+	m[0][2] += ox;
+	m[1][2] += oy;
+}
+//-----------------------------------------------------------------------------
+
+void olcTransform2D::Forward(float x, float y, float &ox, float &oy) const
+{
+	ox = m[0][0] * x + m[0][1] * y + m[0][2];
+	oy = m[1][0] * x + m[1][1] * y + m[1][2];
+}
+//-----------------------------------------------------------------------------
+
+bool olcTransform2D::Inverse(olcTransform2D &inv) const
+{
+	float det = m[0][0] * m[1][1] - m[0][1] * m[1][0];
+	if(std::fabs(det) < 1e-12f)
+		return false;
+
+	float idet = 1.0f / det;
+	inv.m[0][0] =  m[1][1] * idet;
+	inv.m[0][1] = -m[0][1] * idet;
+	inv.m[1][0] = -m[1][0] * idet;
+	inv.m[1][1] =  m[0][0] * idet;
+	inv.m[0][2] = -(inv.m[0][0] * m[0][2] + inv.m[0][1] * m[1][2]);
+	inv.m[1][2] = -(inv.m[1][0] * m[0][2] + inv.m[1][1] * m[1][2]);
+	return true;
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,39 @@
+//---------------------------------------------------------------------------//
+//  2D affine transforms.
+//
+//  Maps sprite space (cell (i, j) of a sprite covers [i, i + 1) x [j, j + 1))
+//  to screen space. Every operation applies after the ones before it, so to
+//  spin a sprite about its centre and put it at (x, y):
+//
+//      olcTransform2D t;
+//      t.Translate(-w / 2.0f, -h / 2.0f);
+//      t.Rotate(fAngle);
+//      t.Translate(x, y);
+//---------------------------------------------------------------------------//
+
+//-----------------------------------------------------------------------------
+#pragma once
+//-----------------------------------------------------------------------------
+
+class olcTransform2D
+{
+public:
+	// x' = m[0][0] * x + m[0][1] * y + m[0][2]
+	// y' = m[1][0] * x + m[1][1] * y + m[1][2]
+	float m[2][3];
+
+	olcTransform2D() { Reset(); }
+
+	void Reset();
+	void Rotate(float fTheta);
+	void Scale(float sx, float sy);
+	void Shear(float sx, float sy);
+	void Translate(float ox, float oy);
+	// Apply t after this transform
+	void Multiply(const olcTransform2D &t);
+
+	void Forward(float x, float y, float &ox, float &oy) const;
+	// The transform mapping back, false if there is none (zero scale)
+	bool Inverse(olcTransform2D &inv) const;
+};
+//-----------------------------------------------------------------------------
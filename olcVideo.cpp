@@ -0,0 +1,574 @@
+//-----------------------------------------------------------------------------
+#include "olcVideo.h"
+#include "olcBoundedQueue.h"
+#include "olcConsoleGameEngine.h"
+#include "olcProfiler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <thread>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define OLC_VIDEO_SSE2
+#endif
+//-----------------------------------------------------------------------------
+
+// The console colours, in COLOUR order
+static const uint8_t s_palette[16][3] =
+{
+	{   0,   0,   0 }, {   0,   0, 128 }, {   0, 128,   0 }, {   0, 128, 128 },
+	{ 128,   0,   0 }, { 128,   0, 128 }, { 128, 128,   0 }, { 192, 192, 192 },
+	{ 128, 128, 128 }, {   0,   0, 255 }, {   0, 255,   0 }, {   0, 255, 255 },
+	{ 255,   0,   0 }, { 255,   0, 255 }, { 255, 255,   0 }, { 255, 255, 255 },
+};
+//-----------------------------------------------------------------------------
+
+static inline uint8_t Clamp255(int v)
+{
+	return uint8_t(v < 0 ? 0 : (v > 255 ? 255 : v));
+}
+//-----------------------------------------------------------------------------
+
+bool olcFrameSource::Open(const std::wstring &sFile, double dFps)
+{
+	Close();
+	m_file.open(WS2S(sFile), std::ios::binary);
+	if(!m_file)
+		return false;
+
+	char sig[2] = { 0, 0 };
+	m_file.read(sig, 2);
+	m_file.seekg(0);
+	if(sig[0] == 'P' && sig[1] == '6')
+	{
+		//-- The first header gives the size, its frame is read later
+		if(!ReadPPMHeader(m_nWidth, m_nHeight, m_nMax))
+		{
+			Close();
+			return false;
+		}
+		m_nFormat     = SOURCE_PPM;
+		m_bHeaderRead = true;
+		m_dFps        = dFps;
+		return true;
+	}
+
+	std::string sHeader;
+	if(!std::getline(m_file, sHeader) || sHeader.compare(0, 10, "YUV4MPEG2 ") != 0)
+	{
+		Close();
+		return false;
+	}
+
+	//-- Space separated parameters, each a letter and its value
+	std::string sColour = "420";
+	size_t      nPos    = 10;
+	while(nPos < sHeader.size())
+	{
+		size_t nEnd = sHeader.find(' ', nPos);
+		if(nEnd == std::string::npos)
+			nEnd = sHeader.size();
+		std::string sParam = sHeader.substr(nPos, nEnd - nPos);
+		nPos = nEnd + 1;
+		if(sParam.size() < 2)
+			continue;
+		switch(sParam[0])
+		{
+		case 'W': m_nWidth  = atoi(sParam.c_str() + 1); break;
+		case 'H': m_nHeight = atoi(sParam.c_str() + 1); break;
+		case 'C': sColour   = sParam.substr(1);         break;
+		case 'F':
+		{
+			int nNum = 0, nDen = 0;
+			if(sscanf(sParam.c_str() + 1, "%d:%d", &nNum, &nDen) == 2 && nNum > 0 && nDen > 0)
+				m_dFps = double(nNum) / double(nDen);
+			break;
+		}
+		}
+	}
+
+	if(sColour.compare(0, 3, "420") == 0)
+	{
+		m_nChromaWidth  = (m_nWidth  + 1) / 2;
+		m_nChromaHeight = (m_nHeight + 1) / 2;
+	}
+	else if(sColour.compare(0, 3, "422") == 0)
+	{
+		m_nChromaWidth  = (m_nWidth + 1) / 2;
+		m_nChromaHeight = m_nHeight;
+	}
+	else if(sColour == "444")
+	{
+		m_nChromaWidth  = m_nWidth;
+		m_nChromaHeight = m_nHeight;
+	}
+	else if(sColour != "mono")
+		m_nWidth = 0;	// not a layout read here
+	if(m_nWidth <= 0 || m_nHeight <= 0 || m_nWidth > 16384 || m_nHeight > 16384)
+	{
+		Close();
+		return false;
+	}
+
+	m_vecChromaColumns.resize(size_t(m_nWidth));
+	for(int x = 0; x < m_nWidth; ++x)
+		m_vecChromaColumns[size_t(x)] = int((long long)x * m_nChromaWidth / m_nWidth);
+	if(dFps > 0.0)
+		m_dFps = dFps;
+	m_nFormat = SOURCE_Y4M;
+	return true;
+}
+//-----------------------------------------------------------------------------
+
+bool olcFrameSource::OpenRaw(const std::wstring &sFile, int nWidth, int nHeight, double dFps)
+{
+	Close();
+	if(nWidth <= 0 || nHeight <= 0)
+		return false;
+	m_file.open(WS2S(sFile), std::ios::binary);
+	if(!m_file)
+		return false;
+	m_nFormat = SOURCE_RAW;
+	m_nWidth  = nWidth;
+	m_nHeight = nHeight;
+	m_dFps    = dFps;
+	return true;
+}
+//-----------------------------------------------------------------------------
+
+void olcFrameSource::Close()
+{
+	if(m_file.is_open())
+		m_file.close();
+	m_file.clear();
+	m_nFormat = SOURCE_NONE;
+	m_nWidth = m_nHeight = m_nChromaWidth = m_nChromaHeight = m_nMax = 0;
+	m_dFps = 0.0;
+	m_bHeaderRead = false;
+}
+//-----------------------------------------------------------------------------
+
+bool olcFrameSource::ReadFrame(sRgbImage &image)
+{
+	switch(m_nFormat)
+	{
+	case SOURCE_Y4M:
+		return ReadY4M(image);
+	case SOURCE_PPM:
+		return ReadPPM(image);
+	case SOURCE_RAW:
+		image.nWidth  = m_nWidth;
+		image.nHeight = m_nHeight;
+		image.vecRGB.resize(size_t(m_nWidth) * size_t(m_nHeight) * 3);
+		return bool(m_file.read((char*)image.vecRGB.data(), std::streamsize(image.vecRGB.size())));
+	default:
+		return false;
+	}
+}
+//-----------------------------------------------------------------------------
+
+bool olcFrameSource::ReadY4M(sRgbImage &image)
+{
+	std::string sFrame;
+	if(!std::getline(m_file, sFrame) || sFrame.compare(0, 5, "FRAME") != 0)
+		return false;
+
+	size_t nLuma   = size_t(m_nWidth) * size_t(m_nHeight);
+	size_t nChroma = size_t(m_nChromaWidth) * size_t(m_nChromaHeight);
+	m_vecPlanes.resize(nLuma + 2 * nChroma);
+	if(!m_file.read((char*)m_vecPlanes.data(), std::streamsize(m_vecPlanes.size())))
+		return false;
+
+	image.nWidth  = m_nWidth;
+	image.nHeight = m_nHeight;
+	image.vecRGB.resize(nLuma * 3);
+	const uint8_t *pY = m_vecPlanes.data();
+	const uint8_t *pU = pY + nLuma;
+	const uint8_t *pV = pU + nChroma;
+	uint8_t       *pRGB = image.vecRGB.data();
+
+	//-- BT.601, studio range, in 8.8 fixed point
+	for(int y = 0; y < m_nHeight; ++y)
+	{
+		const uint8_t *rowY = pY + size_t(y) * size_t(m_nWidth);
+		size_t nChromaRow   = m_nChromaWidth ? size_t(y * m_nChromaHeight / m_nHeight) * size_t(m_nChromaWidth) : 0;
+		for(int x = 0; x < m_nWidth; ++x)
+		{
+			int c = 298 * (int(rowY[x]) - 16) + 128;
+			int d = 0, e = 0;
+			if(m_nChromaWidth)
+			{
+				size_t i = nChromaRow + size_t(m_vecChromaColumns[size_t(x)]);
+				d = int(pU[i]) - 128;
+				e = int(pV[i]) - 128;
+			}
+			*pRGB++ = Clamp255((c + 409 * e) >> 8);
+			*pRGB++ = Clamp255((c - 100 * d - 208 * e) >> 8);
+			*pRGB++ = Clamp255((c + 516 * d) >> 8);
+		}
+	}
+	return true;
+}
+//-----------------------------------------------------------------------------
+
+bool olcFrameSource::ReadPPMHeader(int &nWidth, int &nHeight, int &nMax)
+{
+	char sig[2];
+	if(!m_file.read(sig, 2) || sig[0] != 'P' || sig[1] != '6')
+		return false;
+
+	//-- Three numbers, with whitespace and comments between them, then a
+	//   single whitespace character before the samples
+	int *pValues[3] = { &nWidth, &nHeight, &nMax };
+	for(int *pValue : pValues)
+	{
+		int c = m_file.get();
+		while(c == '#' || isspace(c))
+		{
+			if(c == '#')
+				while(c != '\n' && c != EOF)
+					c = m_file.get();
+			c = m_file.get();
+		}
+		if(!isdigit(c))
+			return false;
+		long long n = 0;
+		while(isdigit(c) && n <= 65535)
+		{
+			n = n * 10 + (c - '0');
+			c = m_file.get();
+		}
+		if(!isspace(c) || n <= 0 || n > 65535)
+			return false;
+		*pValue = int(n);
+	}
+	return nWidth <= 16384 && nHeight <= 16384;
+}
+//-----------------------------------------------------------------------------
+
+bool olcFrameSource::ReadPPM(sRgbImage &image)
+{
+	int nWidth = m_nWidth, nHeight = m_nHeight, nMax = m_nMax;
+	if(!m_bHeaderRead)
+	{
+		//-- The end of a stream of images is the end of the file
+		if(m_file.peek() == EOF || !ReadPPMHeader(nWidth, nHeight, nMax))
+			return false;
+	}
+	m_bHeaderRead = false;
+
+	image.nWidth  = nWidth;
+	image.nHeight = nHeight;
+	size_t nSamples = size_t(nWidth) * size_t(nHeight) * 3;
+	image.vecRGB.resize(nSamples);
+	if(nMax < 256)
+	{
+		if(!m_file.read((char*)image.vecRGB.data(), std::streamsize(nSamples)))
+			return false;
+		if(nMax != 255)
+			for(uint8_t &v : image.vecRGB)
+				v = uint8_t(std::min(int(v), nMax) * 255 / nMax);
+	}
+	else
+	{
+		//-- Two bytes a sample, most significant first
+		m_vecPlanes.resize(nSamples * 2);
+		if(!m_file.read((char*)m_vecPlanes.data(), std::streamsize(nSamples * 2)))
+			return false;
+		for(size_t i = 0; i < nSamples; ++i)
+			image.vecRGB[i] = uint8_t(std::min((m_vecPlanes[2 * i] << 8) | m_vecPlanes[2 * i + 1], nMax) * 255 / nMax);
+	}
+	return true;
+}
+//-----------------------------------------------------------------------------
+
+void olcColourMapper::BuildLookup()
+{
+	//-- Every colour on its own (as a solid block), and every pair of them
+	//   under each of the three shades
+	static const wchar_t shades[3]   = { PIXEL_QUARTER, PIXEL_HALF, PIXEL_THREEQUARTERS };
+	static const int     coverage[3]  = { 1, 2, 3 };	// quarters of foreground
+	m_vecBlends.clear();
+	for(int c = 0; c < 16; ++c)
+		m_vecBlends.push_back({ PIXEL_SOLID, uint8_t(c | (c << 4)), s_palette[c][0], s_palette[c][1], s_palette[c][2] });
+	for(int fg = 0; fg < 16; ++fg)
+	{
+		for(int bg = fg + 1; bg < 16; ++bg)
+		{
+			for(int s = 0; s < 3; ++s)
+			{
+				int q = coverage[s];
+				m_vecBlends.push_back({ shades[s], uint8_t(fg | (bg << 4)),
+					(s_palette[fg][0] * q + s_palette[bg][0] * (4 - q) + 2) / 4,
+					(s_palette[fg][1] * q + s_palette[bg][1] * (4 - q) + 2) / 4,
+					(s_palette[fg][2] * q + s_palette[bg][2] * (4 - q) + 2) / 4 });
+			}
+		}
+	}
+
+	//-- The blends as padded float arrays, four to a register. The padding
+	//   is too far off to ever be picked.
+	size_t nBlends = m_vecBlends.size(), nPadded = (nBlends + 3) & ~size_t(3);
+	std::vector<float> vecR(nPadded, 1e6f), vecG(nPadded, 1e6f), vecB(nPadded, 1e6f);
+	for(size_t i = 0; i < nBlends; ++i)
+	{
+		vecR[i] = float(m_vecBlends[i].r);
+		vecG[i] = float(m_vecBlends[i].g);
+		vecB[i] = float(m_vecBlends[i].b);
+	}
+
+	//-- The closest blend to every 5:5:5 colour, by distance weighted
+	//   towards green and red the way the eye is
+	m_vecLookup.resize(32768);
+	for(int nKey = 0; nKey < 32768; ++nKey)
+	{
+		int   r5 = nKey >> 10, g5 = (nKey >> 5) & 31, b5 = nKey & 31;
+		float r  = float((r5 << 3) | (r5 >> 2));
+		float g  = float((g5 << 3) | (g5 >> 2));
+		float b  = float((b5 << 3) | (b5 >> 2));
+		size_t nBest = 0;
+#if defined(OLC_VIDEO_SSE2)
+		const __m128 r4 = _mm_set1_ps(r), g4 = _mm_set1_ps(g), b4 = _mm_set1_ps(b);
+		const __m128 wr = _mm_set1_ps(3.0f), wg = _mm_set1_ps(4.0f), wb = _mm_set1_ps(2.0f);
+		__m128  best  = _mm_set1_ps(3.4e38f);
+		__m128i index = _mm_setzero_si128();
+		__m128i lanes = _mm_setr_epi32(0, 1, 2, 3);
+		for(size_t i = 0; i < nPadded; i += 4)
+		{
+			__m128 dr = _mm_sub_ps(_mm_loadu_ps(&vecR[i]), r4);
+			__m128 dg = _mm_sub_ps(_mm_loadu_ps(&vecG[i]), g4);
+			__m128 db = _mm_sub_ps(_mm_loadu_ps(&vecB[i]), b4);
+			__m128 d  = _mm_add_ps(_mm_add_ps(_mm_mul_ps(wr, _mm_mul_ps(dr, dr)), _mm_mul_ps(wg, _mm_mul_ps(dg, dg))), _mm_mul_ps(wb, _mm_mul_ps(db, db)));
+			__m128i closer = _mm_castps_si128(_mm_cmplt_ps(d, best));
+			best  = _mm_min_ps(d, best);
+			index = _mm_or_si128(_mm_and_si128(closer, lanes), _mm_andnot_si128(closer, index));
+			lanes = _mm_add_epi32(lanes, _mm_set1_epi32(4));
+		}
+		alignas(16) float   fBest[4];
+		alignas(16) int32_t nIndex[4];
+		_mm_store_ps(fBest, best);
+		_mm_store_si128((__m128i*)nIndex, index);
+		for(int k = 1; k < 4; ++k)
+			if(fBest[k] < fBest[0] || (fBest[k] == fBest[0] && nIndex[k] < nIndex[0]))
+			{
+				fBest[0]  = fBest[k];
+				nIndex[0] = nIndex[k];
+			}
+		nBest = size_t(nIndex[0]);
+#else
+		float fBest = 3.4e38f;
+		for(size_t i = 0; i < nBlends; ++i)
+		{
+			float dr = vecR[i] - r, dg = vecG[i] - g, db = vecB[i] - b;
+			float d  = 3.0f * dr * dr + 4.0f * dg * dg + 2.0f * db * db;
+			if(d < fBest)
+			{
+				fBest = d;
+				nBest = i;
+			}
+		}
+#endif
+		m_vecLookup[size_t(nKey)] = uint16_t(nBest);
+	}
+}
+//-----------------------------------------------------------------------------
+
+void olcColourMapper::Map(const sRgbImage &image, olcCellBuffer &cells)
+{
+	const int w = cells.Width(), h = cells.Height();
+	if(w <= 0 || h <= 0)
+		return;
+	if(image.nWidth <= 0 || image.nHeight <= 0)
+	{
+		std::fill(cells.Glyphs(), cells.Glyphs() + cells.Size(), L' ');
+		std::fill(cells.Attributes(), cells.Attributes() + cells.Size(), uint8_t(0));
+		return;
+	}
+
+	//-- The source columns of every cell, at least one each
+	m_vecColumns.resize(size_t(w) * 2);
+	for(int x = 0; x < w; ++x)
+	{
+		int x0 = int((long long)x * image.nWidth / w);
+		m_vecColumns[size_t(2 * x)]     = x0;
+		m_vecColumns[size_t(2 * x + 1)] = std::max(int((long long)(x + 1) * image.nWidth / w), x0 + 1);
+	}
+	m_vecSums.resize(size_t(w) * 3);
+	m_vecErrors.assign(size_t(w + 2) * 6, 0);
+	int *pErrors = m_vecErrors.data(), *pErrorsNext = pErrors + size_t(w + 2) * 3;
+
+	for(int y = 0; y < h; ++y)
+	{
+		//-- Box filter: sum the pixels under each cell of the row
+		int y0 = int((long long)y * image.nHeight / h);
+		int y1 = std::max(int((long long)(y + 1) * image.nHeight / h), y0 + 1);
+		std::fill(m_vecSums.begin(), m_vecSums.end(), 0u);
+		for(int sy = y0; sy < y1; ++sy)
+		{
+			const uint8_t *row = image.vecRGB.data() + size_t(sy) * size_t(image.nWidth) * 3;
+			for(int x = 0; x < w; ++x)
+			{
+				uint32_t r = 0, g = 0, b = 0;
+				for(int sx = m_vecColumns[size_t(2 * x)]; sx < m_vecColumns[size_t(2 * x + 1)]; ++sx)
+				{
+					r += row[3 * sx];
+					g += row[3 * sx + 1];
+					b += row[3 * sx + 2];
+				}
+				m_vecSums[size_t(3 * x)]     += r;
+				m_vecSums[size_t(3 * x + 1)] += g;
+				m_vecSums[size_t(3 * x + 2)] += b;
+			}
+		}
+
+		wchar_t *pGlyphs     = cells.Glyphs()     + size_t(y) * size_t(w);
+		uint8_t *pAttributes = cells.Attributes() + size_t(y) * size_t(w);
+		for(int x = 0; x < w; ++x)
+		{
+			uint32_t nArea = uint32_t(m_vecColumns[size_t(2 * x + 1)] - m_vecColumns[size_t(2 * x)]) * uint32_t(y1 - y0);
+			int r = int((m_vecSums[size_t(3 * x)]     + nArea / 2) / nArea);
+			int g = int((m_vecSums[size_t(3 * x + 1)] + nArea / 2) / nArea);
+			int b = int((m_vecSums[size_t(3 * x + 2)] + nArea / 2) / nArea);
+
+			//-- Errors are kept in sixteenths, Floyd-Steinberg weights
+			int *e = pErrors + 3 * (x + 1);
+			if(m_bDither)
+			{
+				r = Clamp255(r + e[0] / 16);
+				g = Clamp255(g + e[1] / 16);
+				b = Clamp255(b + e[2] / 16);
+			}
+
+			const sBlend &blend = m_vecBlends[m_vecLookup[size_t(((r >> 3) << 10) | ((g >> 3) << 5) | (b >> 3))]];
+			pGlyphs[x]     = blend.c;
+			pAttributes[x] = blend.nAttribute;
+
+			if(m_bDither)
+			{
+				int err[3] = { r - blend.r, g - blend.g, b - blend.b };
+				int *n = pErrorsNext + 3 * (x + 1);
+				for(int k = 0; k < 3; ++k)
+				{
+					e[3 + k] += err[k] * 7;
+					n[k - 3] += err[k] * 3;
+					n[k]     += err[k] * 5;
+					n[k + 3] += err[k];
+				}
+			}
+		}
+
+		std::swap(pErrors, pErrorsNext);
+		std::fill(pErrorsNext, pErrorsNext + size_t(w + 2) * 3, 0);
+	}
+}
+//-----------------------------------------------------------------------------
+
+long long olcVideoPlayer::Play(olcRenderBackend &backend, int nWidth, int nHeight, bool bRealtime, int nDepth)
+{
+	m_nWidth = m_nHeight = 0;
+	if(backend.Construct(nWidth, nHeight, 8, 8) < 0)
+		return -1;
+	m_nWidth  = nWidth;
+	m_nHeight = nHeight;
+	m_nFramesDropped = 0;
+	nDepth = std::max(nDepth, 1);
+
+	//-- Buffers go round: from the free queue to a stage, down the pipeline
+	//   and back. Two more than a queue holds, so the stages on both ends of
+	//   a full queue still have one each.
+	struct sCells
+	{
+		olcCellBuffer cells;
+		long long     nFrame;
+	};
+	const size_t nQueued  = size_t(nDepth);
+	const size_t nBuffers = nQueued + 2;
+	olcBoundedQueue<std::unique_ptr<sRgbImage>> queueFreeImages(nBuffers), queueImages(nQueued);
+	olcBoundedQueue<std::unique_ptr<sCells>>    queueFreeCells(nBuffers),  queueCells(nQueued);
+	for(size_t i = 0; i < nBuffers; ++i)
+	{
+		queueFreeImages.Push(std::unique_ptr<sRgbImage>(new sRgbImage()));
+		std::unique_ptr<sCells> pCells(new sCells());
+		pCells->cells.Resize(nWidth, nHeight);
+		queueFreeCells.Push(std::move(pCells));
+	}
+
+	std::thread threadRead([&]
+	{
+		olcProfiler::SetThreadName("Video read");
+		std::unique_ptr<sRgbImage> pImage;
+		while(queueFreeImages.Pop(pImage))
+		{
+			OLC_PROFILE_ZONE("ReadFrame");
+			if(!m_source.ReadFrame(*pImage) || !queueImages.Push(std::move(pImage)))
+				break;
+		}
+		queueImages.Close();
+	});
+
+	std::thread threadMap([&]
+	{
+		olcProfiler::SetThreadName("Video map");
+		std::unique_ptr<sRgbImage> pImage;
+		std::unique_ptr<sCells>    pCells;
+		long long nFrame = 0;
+		while(queueImages.Pop(pImage) && queueFreeCells.Pop(pCells))
+		{
+			{
+				OLC_PROFILE_ZONE("MapFrame");
+				m_mapper.Map(*pImage, pCells->cells);
+			}
+			pCells->nFrame = nFrame++;
+			queueFreeImages.Push(std::move(pImage));
+			if(!queueCells.Push(std::move(pCells)))
+				break;
+		}
+		//-- Also lets the reader go if this stage stopped first
+		queueImages.Close();
+		queueFreeImages.Close();
+		queueCells.Close();
+	});
+
+	const double dFps   = m_source.FrameRate();
+	const bool   bPaced = bRealtime && dFps > 0.0;
+	const sCellRect rect = { 0, 0, short(nWidth - 1), short(nHeight - 1) };
+	std::chrono::steady_clock::time_point tpStart;
+	std::unique_ptr<sCells> pCells;
+	long long nPresented = 0;
+	while(queueCells.Pop(pCells))
+	{
+		if(bPaced)
+		{
+			//-- Frame times count from the first frame out of the pipeline.
+			//   A frame the next one is already due after is skipped.
+			std::chrono::steady_clock::time_point tpNow = std::chrono::steady_clock::now();
+			if(pCells->nFrame == 0)
+				tpStart = tpNow;
+			auto tpDue  = tpStart + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(double(pCells->nFrame) / dFps));
+			auto tpNext = tpStart + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(double(pCells->nFrame + 1) / dFps));
+			if(tpNow >= tpNext)
+			{
+				++m_nFramesDropped;
+				queueFreeCells.Push(std::move(pCells));
+				continue;
+			}
+			std::this_thread::sleep_until(tpDue);
+		}
+
+		{
+			OLC_PROFILE_ZONE("Present");
+			backend.Present(pCells->cells, &rect, 1);
+		}
+		++nPresented;
+		queueFreeCells.Push(std::move(pCells));
+	}
+
+	threadRead.join();
+	threadMap.join();
+	return nPresented;
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,152 @@
+//---------------------------------------------------------------------------//
+//  Images and video in cells.
+//
+//  olcFrameSource reads uncompressed frames as 8 bit RGB:
+//
+//    Y4M              "YUV4MPEG2" streams, 4:2:0, 4:2:2, 4:4:4 or mono,
+//                     converted from BT.601 studio range YUV
+//    PPM              binary (P6) images; several in a row, as written by
+//                     image pipes, play as a stream
+//    raw RGB          bare frames, size and frame rate given by the caller
+//
+//  olcColourMapper turns an image into cells. Every cell is one console
+//  colour (PIXEL_SOLID) or a blend of two under one of the PIXEL_QUARTER,
+//  PIXEL_HALF and PIXEL_THREEQUARTERS shades. The closest blend to every
+//  colour, at 5 bits per channel, is worked out once up front, so mapping a
+//  cell is a table lookup. Error diffusion (Floyd-Steinberg) passes what
+//  each cell gets wrong on to its neighbours. Images are box filtered to the
+//  size of the cell buffer.
+//
+//  olcVideoPlayer plays a source through a render backend as a pipeline of
+//  three threads joined by bounded queues: one reads frames, one maps them
+//  to cells and the calling thread presents them, dropping the frames that
+//  are already late to keep to the source's frame rate.
+//
+//  To show an image in a game, map it into an olcCellBuffer of its own and
+//  CopyRect() that onto the screen.
+//---------------------------------------------------------------------------//
+
+//-----------------------------------------------------------------------------
+#pragma once
+//-----------------------------------------------------------------------------
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+//-----------------------------------------------------------------------------
+#include "olcRenderBackend.h"
+//-----------------------------------------------------------------------------
+
+struct sRgbImage
+{
+	int                  nWidth  = 0;
+	int                  nHeight = 0;
+	std::vector<uint8_t> vecRGB;		// nWidth * nHeight pixels, row by row
+};
+//-----------------------------------------------------------------------------
+
+class olcFrameSource
+{
+private:
+	enum SOURCE_FORMAT
+	{
+		SOURCE_NONE,
+		SOURCE_Y4M,
+		SOURCE_PPM,
+		SOURCE_RAW,
+	};
+
+	std::ifstream        m_file;
+	SOURCE_FORMAT        m_nFormat = SOURCE_NONE;
+	int                  m_nWidth  = 0;
+	int                  m_nHeight = 0;
+	double               m_dFps    = 0.0;
+	int                  m_nChromaWidth  = 0;	// Y4M, 0 for mono
+	int                  m_nChromaHeight = 0;
+	std::vector<uint8_t> m_vecPlanes;
+	std::vector<int>     m_vecChromaColumns;	// Y4M, per pixel column
+	int                  m_nMax = 0;			// PPM, of the header already read
+	bool                 m_bHeaderRead = false;
+
+	bool ReadY4M(sRgbImage &image);
+	bool ReadPPM(sRgbImage &image);
+	bool ReadPPMHeader(int &nWidth, int &nHeight, int &nMax);
+
+public:
+	// A Y4M or PPM file, told apart by their signatures. dFps is the frame
+	// rate of PPM streams, and overrides the one of Y4M files when not 0.
+	bool Open(const std::wstring &sFile, double dFps = 0.0);
+	bool OpenRaw(const std::wstring &sFile, int nWidth, int nHeight, double dFps);
+	void Close();
+
+	int    Width() const     { return m_nWidth;  }
+	int    Height() const    { return m_nHeight; }
+	// 0 if unknown
+	double FrameRate() const { return m_dFps; }
+
+	// The next frame, false at the end of the source (or if it is damaged)
+	bool ReadFrame(sRgbImage &image);
+};
+//-----------------------------------------------------------------------------
+
+class olcColourMapper
+{
+private:
+	struct sBlend
+	{
+		wchar_t c;
+		uint8_t nAttribute;
+		int     r, g, b;
+	};
+	std::vector<sBlend>   m_vecBlends;
+	std::vector<uint16_t> m_vecLookup;		// 32768 entries, by 5:5:5 colour
+	bool                  m_bDither = true;
+
+	// Box filter bounds and scratch, reused from image to image
+	std::vector<int>      m_vecColumns;
+	std::vector<uint32_t> m_vecSums;
+	std::vector<int>      m_vecErrors;
+
+	void BuildLookup();
+
+public:
+	olcColourMapper() { BuildLookup(); }
+
+	void SetDithering(bool bEnable) { m_bDither = bEnable; }
+	bool IsDithering() const        { return m_bDither; }
+
+	// Fill all of cells with the image, scaled to its size
+	void Map(const sRgbImage &image, olcCellBuffer &cells);
+};
+//-----------------------------------------------------------------------------
+
+class olcVideoPlayer
+{
+private:
+	olcFrameSource  m_source;
+	olcColourMapper m_mapper;
+	int             m_nWidth  = 0;
+	int             m_nHeight = 0;
+	uint64_t        m_nFramesDropped = 0;
+
+public:
+	bool Open(const std::wstring &sFile, double dFps = 0.0)                       { return m_source.Open(sFile, dFps); }
+	bool OpenRaw(const std::wstring &sFile, int nWidth, int nHeight, double dFps) { return m_source.OpenRaw(sFile, nWidth, nHeight, dFps); }
+	void Close() { m_source.Close(); }
+
+	olcFrameSource&  Source() { return m_source; }
+	olcColourMapper& Mapper() { return m_mapper; }
+
+	// Construct the backend at nWidth x nHeight cells and play every frame
+	// through it, at the source's frame rate or as fast as the stages go
+	// (also when the rate is unknown). Up to nDepth frames wait between two
+	// stages. Returns the number of frames presented, -1 if the backend
+	// cannot be constructed.
+	long long Play(olcRenderBackend &backend, int nWidth, int nHeight, bool bRealtime, int nDepth = 3);
+	// The size in cells of the last Play(), once the backend made it fit
+	int       Width() const         { return m_nWidth;  }
+	int       Height() const        { return m_nHeight; }
+	// Frames skipped by the last Play() for being late
+	uint64_t  FramesDropped() const { return m_nFramesDropped; }
+};
+//-----------------------------------------------------------------------------
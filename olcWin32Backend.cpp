@@ -0,0 +1,213 @@
+//-----------------------------------------------------------------------------
+#include "olcWin32Backend.h"
+#include "olcCellKernels.h"
+
+#include <chrono>
+#include <cwchar>
+//-----------------------------------------------------------------------------
+#ifdef _WIN32
+
+olcWin32ConsoleBackend::~olcWin32ConsoleBackend()
+{
+	if(m_hConsoleIn != INVALID_HANDLE_VALUE)
+		SetConsoleMode(m_hConsoleIn, m_dwOriginalInMode);
+	if(m_hOriginalConsole != INVALID_HANDLE_VALUE)
+		SetConsoleActiveScreenBuffer(m_hOriginalConsole);
+	if(m_hConsole != INVALID_HANDLE_VALUE)
+		CloseHandle(m_hConsole);
+}
+//-----------------------------------------------------------------------------
+
+int olcWin32ConsoleBackend::Construct(int &width, int &height, int fontw, int fonth)
+{
+	m_hOriginalConsole = GetStdHandle(STD_OUTPUT_HANDLE);
+	m_hConsole         = CreateConsoleScreenBuffer(GENERIC_READ | GENERIC_WRITE,
+										0, NULL, CONSOLE_TEXTMODE_BUFFER, NULL);
+	if(INVALID_HANDLE_VALUE == m_hConsole)
+		return olcReportError(L"CreateConsoleScreenBuffer");
+
+	//-- Input arrives as console input records: keys, and mouse once quick
+	//   edit mode is out of the way. With stdin redirected there is no
+	//   console input, the game still runs, only without an input thread
+	m_hConsoleIn = GetStdHandle(STD_INPUT_HANDLE);
+	if(!GetConsoleMode(m_hConsoleIn, &m_dwOriginalInMode) ||
+	   !SetConsoleMode(m_hConsoleIn, ENABLE_EXTENDED_FLAGS | ENABLE_WINDOW_INPUT | ENABLE_MOUSE_INPUT))
+	{
+		m_hConsoleIn = INVALID_HANDLE_VALUE;
+		fwprintf(stderr, L"[WARNING] stdin is not a console, running without console input\n");
+	}
+
+	//-- This is what I have found so far:
+	//   - Windows establishes lower and upper limits to the size of the screen buffer.
+	//     The low limit depend on the current font size of the console and the current size of
+	//     the console screen.
+	//     Trying to set the buffer size below the actual console window size results
+	//     in an error.
+	//   - The maximum size for the buffer depends on the font size. The maximum buffer size
+	//     can be obtained by a call to GetConsoleScreenBufferInfo().
+	//
+	//     This is how we proceed to manage to get the console buffer and window size:
+	//
+	//   1. Set Console Window to the lowest possible size hence reducing the
+	//      low limit to its bare minimum
+	//   2. Set the ScreenBuffer size to the desired console size
+	//   3. Set the buffer to the console.
+	//   4. Set, now that the buffer has been assigned to the console, the font
+	//      size to the desired value. Mind though, the "Consolas" font has a
+	//      fixed pitch for the size, the width being half the height.
+	//   5. Get the ScreenBuffer info to check the maximum size allowed for the
+	//      console window. Adjust desired buffer size to allowed if necessary
+	//   6. Set the Window Size to the screen buffer size
+
+	//-- 1. Change console visual size to a minimum so ScreenBuffer can shrink
+	//   below the actual visual size
+	m_rectWindow = { 0, 0, 1, 1 };
+	SetConsoleWindowInfo(m_hConsole, TRUE, &m_rectWindow);
+
+	//-- 2. Set now the size of the screen buffer (there are minimum system sizes that
+	//   can be obtained by calling GetSystemMetrics() with params SM_CXMIN y SM_CXMAX
+	COORD coord;//({ width, height });
+	coord.X = width;
+	coord.Y = height;
+	if(!SetConsoleScreenBufferSize(m_hConsole, coord))
+		olcReportError(L"SetConsoleScreenBufferSize");
+
+	//-- 3. Set the buffer to the console
+	if(!SetConsoleActiveScreenBuffer(m_hConsole))
+		return olcReportError(L"SetConsoleActiveScreenBuffer");
+
+	//-- 4. Set the font size now that the buffer has been assigned to the
+	//      actual console
+	CONSOLE_FONT_INFOEX cfi;
+	cfi.cbSize       = sizeof(cfi);
+	if(!GetCurrentConsoleFontEx(m_hConsole, false, &cfi))
+		return olcReportError(L"GetCurrentConsoleFontEx");
+	cfi.nFont        = 0;
+	cfi.dwFontSize.X = fonth / 2;//fontw;
+	cfi.dwFontSize.Y = fonth;
+	cfi.FontFamily   = FF_DONTCARE;
+	cfi.FontWeight   = FW_NORMAL;
+	wcscpy_s(cfi.FaceName, L"Consolas");
+	if(!SetCurrentConsoleFontEx(m_hConsole, false, &cfi))
+		return olcReportError(L"SetCurrentConsoleFontEx");
+
+	//-- 5. Get Screen Buffer Info and check the maximum allowed window size
+	CONSOLE_SCREEN_BUFFER_INFO csbi;
+	if(!GetConsoleScreenBufferInfo(m_hConsole, &csbi))
+		return olcReportError(L"GetConsoleScreenBufferInfo");
+	//-- Re-scale the buffer and window if we've exceeded the high-end limit
+	if(height > csbi.dwMaximumWindowSize.Y ||
+	   width  > csbi.dwMaximumWindowSize.X)
+	{
+		height = height > csbi.dwMaximumWindowSize.Y
+						? csbi.dwMaximumWindowSize.Y : height;
+		width = width > csbi.dwMaximumWindowSize.X
+						? csbi.dwMaximumWindowSize.X : width;
+		coord.X = width;
+		coord.Y = height;
+		if(!SetConsoleScreenBufferSize(m_hConsole, coord))
+			olcReportError(L"SetConsoleScreenBufferSize");
+	}
+
+	//-- 6. Set Console Window Size
+	m_rectWindow = { 0, 0, SHORT(width - 1), SHORT(height - 1) };
+	if(!SetConsoleWindowInfo(m_hConsole, TRUE, &m_rectWindow))
+		return olcReportError(L"SetConsoleWindowInfo");
+
+	return 1;
+}
+//-----------------------------------------------------------------------------
+
+void olcWin32ConsoleBackend::Present(const olcCellBuffer &buf, const sCellRect *pRegions, int nRegions)
+{
+	static_assert(sizeof(CHAR_INFO) == sizeof(uint32_t), "CHAR_INFO is not the layout olcPackCells() writes");
+
+	int width  = buf.Width();
+	int height = buf.Height();
+	if(m_vecCharInfo.size() != buf.Size())
+		m_vecCharInfo.assign(buf.Size(), CHAR_INFO());
+
+	for(int i = 0; i < nRegions; ++i)
+	{
+		//-- Convert just the rows of the region, then write them out
+		SMALL_RECT rect = { pRegions[i].Left, pRegions[i].Top, pRegions[i].Right, pRegions[i].Bottom };
+		size_t     n    = size_t(rect.Right - rect.Left + 1);
+		for(int y = rect.Top; y <= rect.Bottom; ++y)
+		{
+			size_t nAt = size_t(y) * size_t(width) + size_t(rect.Left);
+			olcPackCells(buf.Glyphs() + nAt, buf.Attributes() + nAt, n, reinterpret_cast<uint32_t*>(m_vecCharInfo.data() + nAt));
+		}
+		WriteConsoleOutputW(m_hConsole, m_vecCharInfo.data(), { (short)width, (short)height }, { rect.Left, rect.Top }, &rect);
+	}
+}
+//-----------------------------------------------------------------------------
+
+void olcWin32ConsoleBackend::SetTitle(const std::wstring &sTitle)
+{
+	SetConsoleTitleW(sTitle.c_str());
+}
+//-----------------------------------------------------------------------------
+
+void olcWin32ConsoleBackend::PollKeyboard(short *pKeyState)
+{
+	for(int i = 0; i < 256; i++)
+		pKeyState[i] = GetAsyncKeyState(i);
+}
+//-----------------------------------------------------------------------------
+
+int olcWin32ConsoleBackend::WaitInput(olcInputEvent *pEvents, int nMax, int nTimeoutMs)
+{
+	if(WaitForSingleObject(m_hConsoleIn, DWORD(nTimeoutMs)) != WAIT_OBJECT_0)
+		return 0;
+
+	//-- Each record becomes at most 5 events (one per mouse button)
+	INPUT_RECORD inBuf[32];
+	DWORD events   = 0;
+	DWORD nRecords = DWORD(nMax / 5 < 32 ? nMax / 5 : 32);
+	if(!ReadConsoleInputW(m_hConsoleIn, inBuf, nRecords > 0 ? nRecords : 1, &events))
+		return 0;
+
+	auto tpNow = std::chrono::steady_clock::now();
+	int  n     = 0;
+	for(DWORD i = 0; i < events && n < nMax; i++)
+	{
+		switch(inBuf[i].EventType)
+		{
+		case KEY_EVENT:
+		{
+			const KEY_EVENT_RECORD &key = inBuf[i].Event.KeyEvent;
+			pEvents[n++] = { tpNow, key.bKeyDown ? INPUT_KEY_DOWN : INPUT_KEY_UP, key.wVirtualKeyCode & 0xFF, 0, 0 };
+		}
+		break;
+
+		case MOUSE_EVENT:
+		{
+			const MOUSE_EVENT_RECORD &mouse = inBuf[i].Event.MouseEvent;
+			int x = mouse.dwMousePosition.X;
+			int y = mouse.dwMousePosition.Y;
+			if(mouse.dwEventFlags == MOUSE_MOVED)
+				pEvents[n++] = { tpNow, INPUT_MOUSE_MOVE, 0, x, y };
+			else if(mouse.dwEventFlags == 0 || mouse.dwEventFlags == DOUBLE_CLICK)
+			{
+				for(int m = 0; m < 5 && n < nMax; m++)
+				{
+					DWORD bit = DWORD(1) << m;
+					if((mouse.dwButtonState & bit) != (m_dwMouseButtons & bit))
+						pEvents[n++] = { tpNow, (mouse.dwButtonState & bit) ? INPUT_MOUSE_DOWN : INPUT_MOUSE_UP, m, x, y };
+				}
+				m_dwMouseButtons = mouse.dwButtonState;
+			}
+		}
+		break;
+
+		default:
+			break;
+			// We don't care just at the moment
+		}
+	}
+	return n;
+}
+//-----------------------------------------------------------------------------
+
+#endif
+//-----------------------------------------------------------------------------
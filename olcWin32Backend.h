@@ -0,0 +1,46 @@
+//---------------------------------------------------------------------------//
+//  Win32 console backend (Windows only).
+//
+//  The original output of the engine: a console screen buffer written with
+//  WriteConsoleOutputW(). The engine's cell planes are packed into CHAR_INFO
+//  only over the regions being presented, with olcPackCells(), so nothing
+//  outside this file sees a Windows type.
+//---------------------------------------------------------------------------//
+
+//-----------------------------------------------------------------------------
+#pragma once
+//-----------------------------------------------------------------------------
+#ifdef _WIN32
+#include <vector>
+
+#include <windows.h>
+//-----------------------------------------------------------------------------
+#include "olcRenderBackend.h"
+//-----------------------------------------------------------------------------
+
+class olcWin32ConsoleBackend : public olcRenderBackend
+{
+private:
+	HANDLE     m_hOriginalConsole = INVALID_HANDLE_VALUE;
+	HANDLE     m_hConsole         = INVALID_HANDLE_VALUE;
+	HANDLE     m_hConsoleIn       = INVALID_HANDLE_VALUE;
+	DWORD      m_dwOriginalInMode = 0;
+	DWORD      m_dwMouseButtons   = 0;
+	SMALL_RECT m_rectWindow       = { 0, 0, 1, 1 };
+	std::vector<CHAR_INFO> m_vecCharInfo;
+
+public:
+	~olcWin32ConsoleBackend();
+
+	int  Construct(int &width, int &height, int fontw, int fonth) override;
+	void Present(const olcCellBuffer &buf, const sCellRect *pRegions, int nRegions) override;
+	void SetTitle(const std::wstring &sTitle) override;
+	void PollKeyboard(short *pKeyState) override;
+	int  WaitInput(olcInputEvent *pEvents, int nMax, int nTimeoutMs) override;
+
+	// False when stdin is not a console, InjectInput() still works then
+	bool HasInput() const override { return m_hConsoleIn != INVALID_HANDLE_VALUE; }
+};
+
+#endif
+//-----------------------------------------------------------------------------
@@ -0,0 +1,111 @@
+//-----------------------------------------------------------------------------
+#include "olcWorkerPool.h"
+#include "olcProfiler.h"
+//-----------------------------------------------------------------------------
+
+olcWorkerPool::~olcWorkerPool()
+{
+	Stop();
+}
+//-----------------------------------------------------------------------------
+
+void olcWorkerPool::Start(int nWorkers)
+{
+	Stop();
+	if(nWorkers < 0)
+	{
+		int nHardware = int(std::thread::hardware_concurrency());
+		nWorkers = nHardware > 1 ? nHardware - 1 : 0;
+	}
+
+	m_bQuit = false;
+	for(int i = 0; i < nWorkers; ++i)
+		m_vecThreads.emplace_back(&olcWorkerPool::WorkerThread, this);
+}
+//-----------------------------------------------------------------------------
+
+void olcWorkerPool::Stop()
+{
+	{
+		std::lock_guard<std::mutex> lck(m_mux);
+		m_bQuit = true;
+	}
+	m_cvWork.notify_all();
+	for(std::thread &t : m_vecThreads)
+		t.join();
+	m_vecThreads.clear();
+}
+//-----------------------------------------------------------------------------
+
+void olcWorkerPool::Work(const std::function<void(int)> &fn, int nTasks)
+{
+	for(int i = m_nNext++; i < nTasks; i = m_nNext++)
+	{
+		fn(i);
+		if(++m_nDone == nTasks)
+		{
+			std::lock_guard<std::mutex> lck(m_mux);
+			m_cvDone.notify_all();
+		}
+	}
+}
+//-----------------------------------------------------------------------------
+
+void olcWorkerPool::WorkerThread()
+{
+	olcProfiler::SetThreadName("Worker");
+	unsigned nSeen = 0;
+	std::unique_lock<std::mutex> lck(m_mux);
+	while(true)
+	{
+		m_cvWork.wait(lck, [&] { return m_bQuit || m_nGeneration != nSeen; });
+		if(m_bQuit)
+			return;
+		nSeen = m_nGeneration;
+
+		//-- The batch may already be over by the time this thread wakes up
+		if(m_pJob == nullptr)
+			continue;
+
+		//-- Run() cannot return (and free the job) while anyone is busy on it
+		const std::function<void(int)> *pJob = m_pJob;
+		int nTasks = m_nTasks;
+		++m_nBusy;
+		lck.unlock();
+		Work(*pJob, nTasks);
+		lck.lock();
+		if(--m_nBusy == 0)
+			m_cvDone.notify_all();
+	}
+}
+//-----------------------------------------------------------------------------
+
+void olcWorkerPool::Run(int nTasks, const std::function<void(int)> &fn)
+{
+	if(nTasks <= 0)
+		return;
+
+	if(m_vecThreads.empty() || nTasks == 1)
+	{
+		for(int i = 0; i < nTasks; ++i)
+			fn(i);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lck(m_mux);
+		m_pJob   = &fn;
+		m_nTasks = nTasks;
+		m_nNext  = 0;
+		m_nDone  = 0;
+		++m_nGeneration;
+	}
+	m_cvWork.notify_all();
+
+	Work(fn, nTasks);
+
+	std::unique_lock<std::mutex> lck(m_mux);
+	m_cvDone.wait(lck, [&] { return m_nDone == nTasks && m_nBusy == 0; });
+	m_pJob = nullptr;
+}
+//-----------------------------------------------------------------------------
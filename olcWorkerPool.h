@@ -0,0 +1,54 @@
+//---------------------------------------------------------------------------//
+//  Worker pool.
+//
+//  A fixed set of threads that run batches of independent tasks. Run()
+//  hands out task indices from a shared counter, so every task is run by
+//  exactly one thread; the calling thread joins in and only returns once
+//  the whole batch is done.
+//---------------------------------------------------------------------------//
+
+//-----------------------------------------------------------------------------
+#pragma once
+//-----------------------------------------------------------------------------
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+//-----------------------------------------------------------------------------
+
+class olcWorkerPool
+{
+private:
+	std::vector<std::thread>         m_vecThreads;
+	std::mutex                       m_mux;
+	std::condition_variable          m_cvWork;
+	std::condition_variable          m_cvDone;
+	const std::function<void(int)>*  m_pJob        = nullptr;
+	int                              m_nTasks      = 0;
+	std::atomic<int>                 m_nNext{ 0 };
+	std::atomic<int>                 m_nDone{ 0 };
+	int                              m_nBusy       = 0;
+	unsigned                         m_nGeneration = 0;
+	bool                             m_bQuit       = false;
+
+	void WorkerThread();
+	void Work(const std::function<void(int)> &fn, int nTasks);
+
+public:
+	olcWorkerPool() {}
+	~olcWorkerPool();
+	olcWorkerPool(const olcWorkerPool&) = delete;
+	olcWorkerPool& operator=(const olcWorkerPool&) = delete;
+
+	// Start nWorkers threads besides the caller, replacing any running ones.
+	// Negative picks one less than the number of hardware threads.
+	void Start(int nWorkers = -1);
+	void Stop();
+	int  Workers() const { return int(m_vecThreads.size()); }
+
+	// Run fn(0) .. fn(nTasks - 1) across the pool and wait for all of them
+	void Run(int nTasks, const std::function<void(int)> &fn);
+};
+//-----------------------------------------------------------------------------
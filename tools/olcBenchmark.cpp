@@ -0,0 +1,841 @@
+//---------------------------------------------------------------------------//
+//  olcCGE_bench - microbenchmarks for the drawing primitives and the
+//  present path, run headless at several console sizes.
+//
+//  usage: olcCGE_bench [--out <file.json>] [--filter <text>] [--quick]
+//
+//  Every benchmark is run in batches until a minimum time has passed, a few
+//  times over; the median and best time per call are reported. Results go
+//  to stdout (or --out) as JSON, progress to stderr. --filter only runs the
+//  benchmarks whose name contains the text, --quick trades accuracy for a
+//  shorter run.
+//
+//  The present benchmarks drive the whole game loop (Start() through to
+//  the backend) for a while and report frames per second. The ANSI backend
+//  is run with its output thrown away.
+//---------------------------------------------------------------------------//
+
+//-----------------------------------------------------------------------------
+#include "olcConsoleGameEngine.h"
+#include "olcAnsiBackend.h"
+#include "olcCollision.h"
+#include "olcTilemap.h"
+#include "olcAssetLoader.h"
+#include "olcEngineBatch.h"
+#include "olcVideo.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+//-----------------------------------------------------------------------------
+
+typedef std::chrono::steady_clock clock_type;
+
+struct sResult
+{
+	std::string sName;
+	int         nWidth;
+	int         nHeight;
+	double      dNsMedian;		// per call
+	double      dNsBest;
+	double      dCellsPerCall;	// cells written per call, 0 if not meaningful
+	long long   nCalls;
+};
+
+struct sOptions
+{
+	std::string sOut;
+	std::string sFilter;
+	double      dSampleTime = 0.05;
+	int         nSamples    = 7;
+};
+
+static sOptions             s_options;
+static std::vector<sResult> s_vecResults;
+//-----------------------------------------------------------------------------
+
+// The engine is abstract; the update is handed in for the present benchmarks,
+// the primitives are called directly without starting the game loop
+class olcBenchEngine : public olcConsoleGameEngine
+{
+public:
+	std::function<bool(olcBenchEngine&)> fnUpdate;
+
+	bool OnUserCreate() override { return true; }
+	bool OnUserUpdate(float) override { return fnUpdate ? fnUpdate(*this) : false; }
+};
+//-----------------------------------------------------------------------------
+
+static bool Selected(const std::string &sName)
+{
+	return s_options.sFilter.empty() || sName.find(s_options.sFilter) != std::string::npos;
+}
+//-----------------------------------------------------------------------------
+
+// Time fn(i) for i = 0, 1, 2... in batches. The batch size is grown until a
+// batch takes a tenth of the sample time, so the clock is read rarely.
+static void Run(const std::string &sName, olcBenchEngine &engine, double dCellsPerCall,
+                const std::function<void(int)> &fn)
+{
+	if(!Selected(sName))
+		return;
+
+	long long nBatch = 1;
+	while(true)
+	{
+		clock_type::time_point tp = clock_type::now();
+		for(long long i = 0; i < nBatch; ++i)
+			fn(int(i));
+		double d = std::chrono::duration<double>(clock_type::now() - tp).count();
+		if(d >= s_options.dSampleTime / 10.0 || nBatch >= (1LL << 30))
+			break;
+		nBatch *= 2;
+	}
+
+	std::vector<double> vecSamples;
+	long long nCalls = 0;
+	for(int s = 0; s < s_options.nSamples; ++s)
+	{
+		long long  n = 0;
+		double     d = 0.0;
+		clock_type::time_point tp = clock_type::now();
+		while(d < s_options.dSampleTime)
+		{
+			for(long long i = 0; i < nBatch; ++i)
+				fn(int(i));
+			n += nBatch;
+			d = std::chrono::duration<double>(clock_type::now() - tp).count();
+		}
+		vecSamples.push_back(d * 1e9 / double(n));
+		nCalls += n;
+	}
+	std::sort(vecSamples.begin(), vecSamples.end());
+
+	sResult r;
+	r.sName         = sName;
+	r.nWidth        = engine.ScreenWidth();
+	r.nHeight       = engine.ScreenHeight();
+	r.dNsMedian     = vecSamples[vecSamples.size() / 2];
+	r.dNsBest       = vecSamples.front();
+	r.dCellsPerCall = dCellsPerCall;
+	r.nCalls        = nCalls;
+	s_vecResults.push_back(r);
+
+	fprintf(stderr, "%-40s %4dx%-4d %12.1f ns\n", sName.c_str(), r.nWidth, r.nHeight, r.dNsMedian);
+}
+//-----------------------------------------------------------------------------
+
+// A sprite with a border, a few transparent holes and varied colours
+static void FillSprite(olcSprite &sprite)
+{
+	int w = sprite.nWidth, h = sprite.nHeight;
+	for(int y = 0; y < h; ++y)
+		for(int x = 0; x < w; ++x)
+		{
+			bool bHole = ((x * 7 + y * 13) % 5) == 0 && x > 0 && y > 0 && x < w - 1 && y < h - 1;
+			sprite.SetGlyph(x, y, bHole ? L' ' : wchar_t(0x2588 + (x + y) % 4));
+			sprite.SetColour(x, y, short(((x + y) % 15) + 1));
+		}
+}
+//-----------------------------------------------------------------------------
+
+static void BenchPrimitives(int nWidth, int nHeight)
+{
+	olcBenchEngine engine;
+	engine.SetRenderBackend(std::unique_ptr<olcRenderBackend>(new olcHeadlessBackend()));
+	if(engine.ConstructConsole(nWidth, nHeight) < 0)
+		return;
+	nWidth  = engine.ScreenWidth();
+	nHeight = engine.ScreenHeight();
+	int nCells = nWidth * nHeight;
+
+	//-- Points, spread over the screen so they are not all in cache
+	Run("Draw", engine, 1.0, [&](int i)
+	{
+		engine.Draw((i * 37) % nWidth, (i * 11) % nHeight, L'#', short(i & 0xF));
+	});
+	Run("Draw/clipped", engine, 0.0, [&](int i)
+	{
+		engine.Draw(-1 - (i & 7), nHeight + (i & 3), L'#', 0x0F);
+	});
+
+	//-- Fills
+	Run("Fill/full", engine, double(nCells), [&](int i)
+	{
+		engine.Fill(0, 0, nWidth, nHeight, L'#', short(i & 0xF));
+	});
+	Run("Fill/8x8", engine, 64.0, [&](int i)
+	{
+		int x = (i * 5) % (nWidth - 8), y = (i * 3) % (nHeight - 8);
+		engine.Fill(x, y, x + 8, y + 8, L'#', short(i & 0xF));
+	});
+	Run("Fill/clipped", engine, double(nCells / 4), [&](int i)
+	{
+		engine.Fill(-nWidth / 2, -nHeight / 2, nWidth / 2, nHeight / 2, L'#', short(i & 0xF));
+	});
+	Run("Clear", engine, double(nCells), [&](int i)
+	{
+		engine.Clear(L' ', short(i & 0xF));
+	});
+
+	//-- Pixel mode: filling every pixel, then packing them all into cells
+	//   (drawing a cell packs the pixels under it first)
+	engine.SetPixelMode(true);
+	Run("PixelMode/Fill/full", engine, double(nCells), [&](int i)
+	{
+		engine.Fill(0, 0, engine.PixelWidth(), engine.PixelHeight(), L'#', short(i & 0xF));
+	});
+	Run("PixelMode/Fill+pack/full", engine, double(nCells), [&](int i)
+	{
+		engine.Fill(0, 0, engine.PixelWidth(), engine.PixelHeight(), L'#', short(i & 0xF));
+		engine.DrawString(0, 0, L"#", 0x0F);
+	});
+	engine.SetPixelMode(false);
+
+	//-- Lines in all eight octants, inside the screen and crossing its edges.
+	//   Each octant is a line from the centre at angle (k + 0.5) * 45 degrees.
+	for(int k = 0; k < 8; ++k)
+	{
+		double a  = (k + 0.5) * 3.14159265358979 / 4.0;
+		double dx = std::cos(a), dy = std::sin(a);
+		int    cx = nWidth / 2, cy = nHeight / 2;
+		int    r  = std::min(nWidth, nHeight) / 2 - 1;
+		int    nLength = int(std::max(std::fabs(dx), std::fabs(dy)) * r) + 1;
+
+		Run("DrawLine/octant" + std::to_string(k), engine, double(nLength), [&](int i)
+		{
+			engine.DrawLine(cx, cy, cx + int(dx * r), cy + int(dy * r), L'#', short(i & 0xF));
+		});
+
+		// From well outside on one side to well outside on the other
+		int R = std::max(nWidth, nHeight) * 2;
+		Run("DrawLine/octant" + std::to_string(k) + "/clipped", engine, 0.0, [&](int i)
+		{
+			engine.DrawLine(cx - int(dx * R), cy - int(dy * R), cx + int(dx * R), cy + int(dy * R), L'#', short(i & 0xF));
+		});
+	}
+
+	//-- Filled shapes, inside and mostly off screen
+	Run("FillTriangle", engine, 0.0, [&](int i)
+	{
+		engine.FillTriangle(i % 7, 1, nWidth - 2, nHeight / 3, nWidth / 3, nHeight - 2, L'#', short(i & 0xF));
+	});
+	Run("FillTriangle/clipped", engine, 0.0, [&](int i)
+	{
+		engine.FillTriangle(-nWidth * 4, -nHeight * 4, nWidth / 2, nHeight * 4, nWidth * 4 + (i & 7), nHeight / 2, L'#', short(i & 0xF));
+	});
+	Run("FillCircle", engine, 0.0, [&](int i)
+	{
+		engine.FillCircle(nWidth / 2, nHeight / 2, std::min(nWidth, nHeight) / 2 - 1 - (i & 1), L'#', short(i & 0xF));
+	});
+	Run("DrawCircle", engine, 0.0, [&](int i)
+	{
+		engine.DrawCircle(nWidth / 2, nHeight / 2, std::min(nWidth, nHeight) / 2 - 1 - (i & 1), L'#', short(i & 0xF));
+	});
+	std::vector<sRasterPoint> vecStar;
+	for(int k = 0; k < 10; ++k)
+	{
+		double a = k * 3.14159265358979 / 5.0;
+		int    r = (k & 1) ? std::min(nWidth, nHeight) / 5 : std::min(nWidth, nHeight) / 2 - 1;
+		vecStar.push_back({ nWidth / 2 + int(std::cos(a) * r), nHeight / 2 + int(std::sin(a) * r) });
+	}
+	Run("FillPolygon/star", engine, 0.0, [&](int i)
+	{
+		engine.FillPolygon(vecStar, L'#', short(i & 0xF));
+	});
+
+	//-- Text, whole strings and then laid out in a box
+	std::wstring sShort = L"Hello, World 16!";
+	std::wstring sLine;
+	for(int x = 0; x < nWidth; ++x)
+		sLine += (x % 4) == 3 ? L' ' : wchar_t(L'A' + x % 26);
+
+	Run("DrawString/16", engine, 16.0, [&](int i)
+	{
+		engine.DrawString(i % (nWidth - 16), i % nHeight, sShort, short(i & 0xF));
+	});
+	Run("DrawString/row", engine, double(nWidth), [&](int i)
+	{
+		engine.DrawString(0, i % nHeight, sLine, short(i & 0xF));
+	});
+	Run("DrawStringAlpha/16", engine, 16.0, [&](int i)
+	{
+		engine.DrawStringAlpha(i % (nWidth - 16), i % nHeight, sShort, short(i & 0xF));
+	});
+	Run("DrawStringAlpha/row", engine, double(nWidth), [&](int i)
+	{
+		engine.DrawStringAlpha(0, i % nHeight, sLine, short(i & 0xF));
+	});
+	Run("DrawString/literal", engine, 16.0, [&](int i)
+	{
+		engine.DrawString(i % (nWidth - 16), i % nHeight, L"Hello, World 16!", short(i & 0xF));
+	});
+	std::wstring sParagraph;
+	for(int k = 0; k < 8; ++k)
+		sParagraph += sLine;
+	olcTextRun run(sParagraph, nWidth / 2, TEXT_CENTRE);
+	Run("DrawText/wrapped", engine, double(sParagraph.size()), [&](int i)
+	{
+		engine.DrawText(0, 0, nWidth / 2, 0, sParagraph, short(i & 0xF), TEXT_CENTRE);
+	});
+	Run("DrawTextRun/wrapped", engine, double(sParagraph.size()), [&](int i)
+	{
+		engine.DrawTextRun(0, 0, run, short(i & 0xF));
+	});
+
+	//-- Sprites, plain and compiled, whole and partial, inside and straddling
+	//   the bottom right corner
+	const int sizes[][2] = { { 8, 8 }, { 32, 16 }, { 64, 64 } };
+	for(auto &size : sizes)
+	{
+		int w = size[0], h = size[1];
+		if(w > nWidth || h > nHeight)
+			continue;
+
+		olcSprite sprite(w, h);
+		FillSprite(sprite);
+		olcCompiledSprite compiled(&sprite);
+
+		std::string sSize = std::to_string(w) + "x" + std::to_string(h);
+		int nX = nWidth - w + 1, nY = nHeight - h + 1;
+		double dCells = double(w * h);
+
+		Run("DrawSprite/" + sSize, engine, dCells, [&](int i)
+		{
+			engine.DrawSprite((i * 7) % nX, (i * 3) % nY, &sprite);
+		});
+		Run("DrawSprite/" + sSize + "/clipped", engine, dCells / 4, [&](int)
+		{
+			engine.DrawSprite(nWidth - w / 2, nHeight - h / 2, &sprite);
+		});
+		Run("DrawPartialSprite/" + sSize, engine, dCells / 4, [&](int i)
+		{
+			engine.DrawPartialSprite((i * 7) % nX, (i * 3) % nY, &sprite, w / 4, h / 4, w / 2, h / 2);
+		});
+		Run("DrawSprite/compiled/" + sSize, engine, dCells, [&](int i)
+		{
+			engine.DrawSprite((i * 7) % nX, (i * 3) % nY, &compiled);
+		});
+		Run("DrawSprite/compiled/" + sSize + "/clipped", engine, dCells / 4, [&](int)
+		{
+			engine.DrawSprite(nWidth - w / 2, nHeight - h / 2, &compiled);
+		});
+		Run("DrawPartialSprite/compiled/" + sSize, engine, dCells / 4, [&](int i)
+		{
+			engine.DrawPartialSprite((i * 7) % nX, (i * 3) % nY, &compiled, w / 4, h / 4, w / 2, h / 2);
+		});
+	}
+
+	//-- Rotated and scaled sprites, against the per cell inverse mapping
+	//   through GetGlyph()/Draw() games otherwise write themselves
+	for(auto &size : sizes)
+	{
+		int w = size[0], h = size[1];
+		olcSprite sprite(w, h);
+		FillSprite(sprite);
+		std::string sSize = std::to_string(w) + "x" + std::to_string(h);
+
+		auto transform = [&](int i)
+		{
+			olcTransform2D t;
+			t.Translate(-w / 2.0f, -h / 2.0f);
+			t.Rotate(float(i & 63) * 0.1f);
+			t.Scale(1.5f, 1.5f);
+			t.Translate(nWidth / 2.0f, nHeight / 2.0f);
+			return t;
+		};
+
+		Run("DrawSpriteTransformed/" + sSize, engine, 0.0, [&](int i)
+		{
+			engine.DrawSpriteTransformed(&sprite, transform(i));
+		});
+		Run("DrawSpriteTransformed/" + sSize + "/per-cell", engine, 0.0, [&](int i)
+		{
+			olcTransform2D t = transform(i), inv;
+			t.Inverse(inv);
+			float r = std::sqrt(float(w * w + h * h)) * 0.75f + 1.0f;
+			for(int y = int(nHeight / 2.0f - r); y <= int(nHeight / 2.0f + r); ++y)
+				for(int x = int(nWidth / 2.0f - r); x <= int(nWidth / 2.0f + r); ++x)
+				{
+					float u, v;
+					inv.Forward(x + 0.5f, y + 0.5f, u, v);
+					int i = int(std::floor(u)), j = int(std::floor(v));
+					if(i < 0 || j < 0 || i >= w || j >= h || sprite.GetGlyph(i, j) == L' ')
+						continue;
+					engine.Draw(x, y, sprite.GetGlyph(i, j), sprite.GetColour(i, j));
+				}
+		});
+	}
+
+	//-- A frame's worth of overlapping sprites, drawn right away and deferred
+	//   to the tiled worker pool
+	if(nWidth >= 32 && nHeight >= 16)
+	{
+		olcSprite sprite(32, 16);
+		FillSprite(sprite);
+		olcCompiledSprite compiled(&sprite);
+		int nX = nWidth - 31, nY = nHeight - 15;
+
+		auto frame = [&](int i)
+		{
+			engine.Clear(L' ', 0);
+			for(int s = 0; s < 256; ++s)
+				engine.DrawSprite((s * 37 + i) % nX, (s * 11) % nY, &compiled);
+			engine.FlushDrawCommands();
+		};
+		double dCells = double(nCells + 256 * 32 * 16);
+
+		Run("Frame/256sprites", engine, dCells, frame);
+		engine.SetDeferredDrawing(true);
+		Run("Frame/256sprites/deferred", engine, dCells, frame);
+		engine.SetDeferredDrawing(false);
+	}
+}
+//-----------------------------------------------------------------------------
+
+// Points stdout at the null device for as long as it lives
+class olcStdoutToNull
+{
+private:
+	int m_fdSaved = -1;
+
+public:
+	olcStdoutToNull()
+	{
+		fflush(stdout);
+#ifdef _WIN32
+		int fdNull = _open("NUL", _O_WRONLY);
+		m_fdSaved  = _dup(_fileno(stdout));
+		_dup2(fdNull, _fileno(stdout));
+		_close(fdNull);
+#else
+		int fdNull = open("/dev/null", O_WRONLY);
+		m_fdSaved  = dup(STDOUT_FILENO);
+		dup2(fdNull, STDOUT_FILENO);
+		close(fdNull);
+#endif
+	}
+
+	~olcStdoutToNull()
+	{
+		fflush(stdout);
+#ifdef _WIN32
+		_dup2(m_fdSaved, _fileno(stdout));
+		_close(m_fdSaved);
+#else
+		dup2(m_fdSaved, STDOUT_FILENO);
+		close(m_fdSaved);
+#endif
+	}
+};
+//-----------------------------------------------------------------------------
+
+// Cost of a profiler zone, off (the default) and recording
+static void BenchProfiler()
+{
+	olcBenchEngine engine;
+	engine.SetRenderBackend(std::unique_ptr<olcRenderBackend>(new olcHeadlessBackend()));
+	if(engine.ConstructConsole(80, 30) < 0)
+		return;
+
+	volatile int nSink = 0;
+	Run("Profiler/zone/off", engine, 0.0, [&](int i) { OLC_PROFILE_ZONE("Bench"); nSink = i; });
+	olcProfiler::Enable(true);
+	Run("Profiler/zone/on",  engine, 0.0, [&](int i) { OLC_PROFILE_ZONE("Bench"); nSink = i; });
+	olcProfiler::Enable(false);
+	olcProfiler::Reset();
+}
+//-----------------------------------------------------------------------------
+
+// Sprite collision: one mask pair, and a scene of a few thousand colliders
+static void BenchCollision()
+{
+	olcBenchEngine engine;
+	engine.SetRenderBackend(std::unique_ptr<olcRenderBackend>(new olcHeadlessBackend()));
+	if(engine.ConstructConsole(80, 30) < 0)
+		return;
+
+	olcSprite sprite(16, 12);
+	FillSprite(sprite);
+	olcCollisionMask mask(&sprite);
+
+	volatile bool bSink = false;
+	Run("Collision/overlap/16x12", engine, 0.0, [&](int i)
+	{
+		bSink = mask.Overlaps(0, 0, mask, (i % 29) - 14, (i % 23) - 11);
+	});
+
+	const int nColliders = 4000;
+	std::vector<sCollider> vecColliders;
+	for(int i = 0; i < nColliders; ++i)
+		vecColliders.push_back({ (i * 7919) % 1600, (i * 104729) % 1200, &mask });
+	olcCollisionGrid grid;
+	std::vector<std::pair<int, int>> vecPairs;
+	Run("Collision/grid/4000", engine, 0.0, [&](int i)
+	{
+		vecColliders[size_t(i % nColliders)].x ^= 1;
+		grid.FindPairs(vecColliders.data(), nColliders, vecPairs);
+	});
+}
+//-----------------------------------------------------------------------------
+
+// Particles: one update (integration and compaction) and one draw of 100k
+static void BenchParticles()
+{
+	olcBenchEngine engine;
+	engine.SetRenderBackend(std::unique_ptr<olcRenderBackend>(new olcHeadlessBackend()));
+	if(engine.ConstructConsole(320, 200) < 0)
+		return;
+
+	//-- Every particle that expires is re-emitted, so the count holds steady
+	//   and each update compacts a few hundred
+	const int nParticles = 100000;
+	olcParticleSystem particles;
+	particles.Reserve(nParticles);
+	particles.SetAcceleration(0.0f, 9.8f);
+	auto emit = [&](int k)
+	{
+		particles.Emit(float(k % 320), float((k / 320) % 200), float(k % 7) - 3.0f, float(k % 5) - 4.0f,
+			0.5f + float(k % 240) / 60.0f, 0x2588, short(k % 15 + 1));
+	};
+	for(int k = 0; k < nParticles; ++k)
+		emit(k);
+
+	int nNext = nParticles;
+	Run("Particles/update/100k", engine, 0.0, [&](int)
+	{
+		particles.Update(1.0f / 60.0f);
+		while(particles.Size() < size_t(nParticles))
+			emit(nNext++);
+	});
+
+	Run("Particles/draw/100k", engine, double(nParticles), [&](int)
+	{
+		engine.DrawParticles(particles);
+	});
+}
+//-----------------------------------------------------------------------------
+
+// Tilemap: a screen of opaque 8x8 tiles from a 1024x1024 map, and the same tiles
+// drawn one DrawPartialSprite() at a time
+static void BenchTilemap()
+{
+	olcBenchEngine engine;
+	engine.SetRenderBackend(std::unique_ptr<olcRenderBackend>(new olcHeadlessBackend()));
+	if(engine.ConstructConsole(320, 200) < 0)
+		return;
+
+	//-- Opaque terrain tiles
+	olcSprite sheet(32, 32);
+	FillSprite(sheet);
+	for(int y = 0; y < sheet.nHeight; ++y)
+		for(int x = 0; x < sheet.nWidth; ++x)
+			if(sheet.GetGlyph(x, y) == L' ')
+				sheet.SetGlyph(x, y, PIXEL_HALF);
+	olcTileset tileset(&sheet, 8, 8);
+	olcTilemap map;
+	map.Create(1024, 1024);
+	for(int y = 0; y < map.Height(); ++y)
+		for(int x = 0; x < map.Width(); ++x)
+			map.SetTile(x, y, uint16_t((x * 7 + y * 3) % tileset.Count()));
+
+	const double dCells = 320.0 * 200.0;
+	Run("Tilemap/draw", engine, dCells, [&](int i)
+	{
+		engine.DrawTilemap(map, tileset, float(i % 4096) * 1.5f, float(i % 2048) * 0.75f);
+	});
+
+	Run("Tilemap/partial-sprites", engine, dCells, [&](int i)
+	{
+		int cx = int(float(i % 4096) * 1.5f), cy = int(float(i % 2048) * 0.75f);
+		for(int ty = cy / 8; ty <= (cy + 199) / 8; ++ty)
+			for(int tx = cx / 8; tx <= (cx + 319) / 8; ++tx)
+			{
+				int n = map.GetTile(tx, ty);
+				engine.DrawPartialSprite(tx * 8 - cx, ty * 8 - cy, &sheet, (n % 4) * 8, (n / 4) * 8, 8, 8);
+			}
+	});
+}
+//-----------------------------------------------------------------------------
+
+// Assets: what loading a 64x64 sprite costs the game thread, read there or
+// queued for the loader
+static void BenchAssets()
+{
+	olcBenchEngine engine;
+	engine.SetRenderBackend(std::unique_ptr<olcRenderBackend>(new olcHeadlessBackend()));
+	if(engine.ConstructConsole(80, 30) < 0)
+		return;
+
+	olcSprite sprite(64, 64);
+	FillSprite(sprite);
+	std::wstring sFile = (std::filesystem::temp_directory_path() / "olcCGE_bench.spr").wstring();
+	if(!sprite.Save(sFile))
+		return;
+
+	olcSprite loaded;
+	Run("Assets/Load/sync", engine, 0.0, [&](int)
+	{
+		loaded.Load(sFile);
+	});
+
+	olcAssetLoader loader;
+	Run("Assets/LoadSprite/async", engine, 0.0, [&](int)
+	{
+		loader.LoadSprite(sFile);
+		loader.Evict(sFile);
+	});
+	loader.WaitAll();
+	std::filesystem::remove(sFile);
+}
+//-----------------------------------------------------------------------------
+
+// Batches: 64 small games stepped on the caller alone and on every core.
+// The cells per call are instance steps, so cells/s reads as steps/s.
+static void BenchBatch()
+{
+	olcBenchEngine engine;
+	engine.SetRenderBackend(std::unique_ptr<olcRenderBackend>(new olcHeadlessBackend()));
+	if(engine.ConstructConsole(80, 30) < 0)
+		return;
+
+	const int nInstances = 64;
+	auto create = [](int n)
+	{
+		std::unique_ptr<olcBenchEngine> pGame(new olcBenchEngine());
+		pGame->fnUpdate = [n, nFrame = 0](olcBenchEngine &e) mutable
+		{
+			++nFrame;
+			e.Clear();
+			for(int i = 0; i < 16; ++i)
+				e.DrawLine(0, (i * 7 + n) % 30, 79, (i * 11 + nFrame) % 30, 0x2588, short(i % 15 + 1));
+			e.FillCircle((nFrame + n) % 80, 15, 6, PIXEL_HALF, FG_GREEN);
+			e.DrawString(1, 1, L"Batched instance", FG_WHITE);
+			return true;
+		};
+		return std::unique_ptr<olcConsoleGameEngine>(std::move(pGame));
+	};
+
+	for(int nWorkers : { 0, -1 })
+	{
+		olcEngineBatch batch;
+		if(!batch.Create(nInstances, 80, 30, create, nWorkers))
+			return;
+		Run(nWorkers == 0 ? "Batch/step/64/serial" : "Batch/step/64/parallel", engine, double(nInstances), [&](int)
+		{
+			batch.Step(1.0f / 60.0f);
+		});
+	}
+}
+//-----------------------------------------------------------------------------
+
+// Video: a 640x360 frame mapped to 160x100 cells, with and without error
+// diffusion
+static void BenchVideo()
+{
+	olcBenchEngine engine;
+	engine.SetRenderBackend(std::unique_ptr<olcRenderBackend>(new olcHeadlessBackend()));
+	if(engine.ConstructConsole(80, 30) < 0)
+		return;
+
+	//-- Smooth gradients with some texture over them
+	sRgbImage image;
+	image.nWidth  = 640;
+	image.nHeight = 360;
+	image.vecRGB.resize(size_t(image.nWidth) * size_t(image.nHeight) * 3);
+	for(int y = 0; y < image.nHeight; ++y)
+		for(int x = 0; x < image.nWidth; ++x)
+		{
+			uint8_t *p = &image.vecRGB[(size_t(y) * size_t(image.nWidth) + size_t(x)) * 3];
+			p[0] = uint8_t(x * 255 / image.nWidth);
+			p[1] = uint8_t(y * 255 / image.nHeight);
+			p[2] = uint8_t(((x ^ y) & 63) * 4);
+		}
+
+	olcColourMapper mapper;
+	olcCellBuffer   cells(160, 100);
+	for(bool bDither : { true, false })
+	{
+		mapper.SetDithering(bDither);
+		Run(bDither ? "Video/map/160x100/dither" : "Video/map/160x100/nearest", engine, 160.0 * 100.0, [&](int)
+		{
+			mapper.Map(image, cells);
+		});
+	}
+}
+//-----------------------------------------------------------------------------
+
+enum BENCH_SCENE
+{
+	SCENE_FULL,		// every cell changes every frame
+	SCENE_SPRITES,	// a handful of sprites move over a static background
+};
+
+// Run the game loop for the sample time and record the time per frame
+static void BenchPresent(const std::string &sName, int nWidth, int nHeight, bool bAnsi, int nBuffers, BENCH_SCENE scene)
+{
+	if(!Selected(sName))
+		return;
+
+	// Declared first so the backend's last words on destruction go to the
+	// null device too
+	std::unique_ptr<olcStdoutToNull> pNull;
+	if(bAnsi)
+		pNull.reset(new olcStdoutToNull());
+
+	olcBenchEngine engine;
+	if(bAnsi)
+		engine.SetRenderBackend(std::unique_ptr<olcRenderBackend>(new olcAnsiBackend()));
+	else
+		engine.SetRenderBackend(std::unique_ptr<olcRenderBackend>(new olcHeadlessBackend()));
+	if(engine.ConstructConsole(nWidth, nHeight) < 0)
+		return;
+	engine.SetPresentMode(nBuffers, PRESENT_BLOCK);
+
+	olcSprite sprite(8, 8);
+	FillSprite(sprite);
+	std::vector<olcSprite*> vecSprites(16, &sprite);
+
+	long long nFrames = 0;
+	double    dCells  = 0.0;
+	double    dTime   = s_options.dSampleTime * s_options.nSamples;
+	clock_type::time_point tpStart;
+
+	engine.fnUpdate = [&](olcBenchEngine &e)
+	{
+		int w = e.ScreenWidth(), h = e.ScreenHeight();
+		if(nFrames == 0)
+		{
+			e.Clear(L'.', 0x08);
+			tpStart = clock_type::now();
+		}
+		else if(scene == SCENE_FULL)
+		{
+			e.Clear(L'#', short(nFrames & 0xF));
+			dCells += double(w * h);
+		}
+		else
+		{
+			// Erase last frame's sprites, then draw them one cell along
+			for(size_t s = 0; s < vecSprites.size(); ++s)
+			{
+				int x = int((s * 17 + nFrames - 1) % size_t(w)), y = int((s * 5) % size_t(h));
+				e.Fill(x, y, x + 8, y + 8, L'.', 0x08);
+				e.DrawSprite(int((s * 17 + nFrames) % size_t(w)), y, vecSprites[s]);
+			}
+			dCells += double(vecSprites.size() * 64 * 2);
+		}
+		++nFrames;
+		return std::chrono::duration<double>(clock_type::now() - tpStart).count() < dTime;
+	};
+	engine.Start();
+	double d = std::chrono::duration<double>(clock_type::now() - tpStart).count();
+
+	sResult r;
+	r.sName         = sName;
+	r.nWidth        = engine.ScreenWidth();
+	r.nHeight       = engine.ScreenHeight();
+	r.dNsMedian     = nFrames > 1 ? d * 1e9 / double(nFrames - 1) : 0.0;
+	r.dNsBest       = r.dNsMedian;
+	r.dCellsPerCall = nFrames > 1 ? dCells / double(nFrames - 1) : 0.0;
+	r.nCalls        = nFrames - 1;
+	s_vecResults.push_back(r);
+
+	fprintf(stderr, "%-40s %4dx%-4d %12.1f ns\n", sName.c_str(), r.nWidth, r.nHeight, r.dNsMedian);
+}
+//-----------------------------------------------------------------------------
+
+static bool WriteJson(FILE *f)
+{
+	fprintf(f, "{\n");
+	fprintf(f, "  \"suite\": \"olcCGE_bench\",\n");
+	fprintf(f, "  \"version\": \"%s\",\n", OLCCGE_VERSION);
+	fprintf(f, "  \"sample_seconds\": %g,\n", s_options.dSampleTime);
+	fprintf(f, "  \"samples\": %d,\n", s_options.nSamples);
+	fprintf(f, "  \"results\": [\n");
+	for(size_t i = 0; i < s_vecResults.size(); ++i)
+	{
+		const sResult &r = s_vecResults[i];
+		double dCallsPerSec = r.dNsMedian > 0.0 ? 1e9 / r.dNsMedian : 0.0;
+		fprintf(f, "    { \"name\": \"%s\", \"width\": %d, \"height\": %d, "
+		           "\"ns_per_call\": %.2f, \"ns_per_call_best\": %.2f, \"calls_per_sec\": %.1f, "
+		           "\"cells_per_call\": %.1f, \"cells_per_sec\": %.1f, \"calls\": %lld }%s\n",
+		        r.sName.c_str(), r.nWidth, r.nHeight,
+		        r.dNsMedian, r.dNsBest, dCallsPerSec,
+		        r.dCellsPerCall, r.dCellsPerCall * dCallsPerSec, r.nCalls,
+		        i + 1 < s_vecResults.size() ? "," : "");
+	}
+	fprintf(f, "  ]\n}\n");
+	return ferror(f) == 0;
+}
+//-----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+	for(int i = 1; i < argc; ++i)
+	{
+		if(strcmp(argv[i], "--out") == 0 && i + 1 < argc)
+			s_options.sOut = argv[++i];
+		else if(strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+			s_options.sFilter = argv[++i];
+		else if(strcmp(argv[i], "--quick") == 0)
+		{
+			s_options.dSampleTime = 0.01;
+			s_options.nSamples    = 3;
+		}
+		else
+		{
+			fprintf(stderr, "usage: %s [--out <file.json>] [--filter <text>] [--quick]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	const int resolutions[][2] = { { 80, 30 }, { 160, 100 }, { 320, 200 } };
+
+	for(auto &res : resolutions)
+		BenchPrimitives(res[0], res[1]);
+	BenchProfiler();
+	BenchCollision();
+	BenchParticles();
+	BenchTilemap();
+	BenchAssets();
+	BenchBatch();
+	BenchVideo();
+
+	for(auto &res : resolutions)
+	{
+		for(int nBuffers = 1; nBuffers <= 2; ++nBuffers)
+		{
+			std::string sMode = nBuffers == 1 ? "/sync" : "/threaded";
+			BenchPresent("Present/headless/full"    + sMode, res[0], res[1], false, nBuffers, SCENE_FULL);
+			BenchPresent("Present/headless/sprites" + sMode, res[0], res[1], false, nBuffers, SCENE_SPRITES);
+			BenchPresent("Present/ansi/full"        + sMode, res[0], res[1], true,  nBuffers, SCENE_FULL);
+			BenchPresent("Present/ansi/sprites"     + sMode, res[0], res[1], true,  nBuffers, SCENE_SPRITES);
+		}
+	}
+
+	FILE *f = s_options.sOut.empty() ? stdout : fopen(s_options.sOut.c_str(), "w");
+	if(f == nullptr)
+	{
+		fprintf(stderr, "cannot write '%s'\n", s_options.sOut.c_str());
+		return 1;
+	}
+	bool bOk = WriteJson(f);
+	if(f != stdout)
+		bOk = fclose(f) == 0 && bOk;
+	return bOk ? 0 : 1;
+}
+//-----------------------------------------------------------------------------
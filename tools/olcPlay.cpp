@@ -0,0 +1,118 @@
+//---------------------------------------------------------------------------//
+//  olcCGE_play - plays images and uncompressed video in the console (see
+//  olcVideo.h).
+//
+//  usage: olcCGE_play [--backend default|ansi|headless] [--size WxH]
+//                     [--raw WxH] [--fps N] [--no-dither] [--max-speed]
+//                     <file.y4m|file.ppm|file.rgb>
+//
+//  --size is the console size in cells (160x100 by default, the backend may
+//  make it smaller). --raw reads bare RGB frames of the given size. --fps
+//  sets the frame rate of PPM and raw streams, or overrides the one of a Y4M
+//  file. Playing through the headless backend at --max-speed times the
+//  pipeline and prints what was presented.
+//---------------------------------------------------------------------------//
+
+//-----------------------------------------------------------------------------
+#include "olcVideo.h"
+#include "olcToolBackend.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+//-----------------------------------------------------------------------------
+
+namespace fs = std::filesystem;
+//-----------------------------------------------------------------------------
+
+static int Usage(const char *sExe)
+{
+	fprintf(stderr, "usage: %s [--backend default|ansi|headless] [--size WxH] [--raw WxH]\n"
+	                "       %*s [--fps N] [--no-dither] [--max-speed] <file>\n", sExe, int(strlen(sExe)), "");
+	return 1;
+}
+//-----------------------------------------------------------------------------
+
+static bool ParseSize(const char *sText, int &nWidth, int &nHeight)
+{
+	return sscanf(sText, "%dx%d", &nWidth, &nHeight) == 2 && nWidth > 0 && nHeight > 0;
+}
+//-----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+	std::string sBackend  = "default";
+	bool        bRealtime = true;
+	bool        bDither   = true;
+	bool        bRaw      = false;
+	int         nWidth = 160, nHeight = 100, nRawWidth = 0, nRawHeight = 0;
+	double      dFps  = 0.0;
+	const char *sFile = nullptr;
+
+	for(int i = 1; i < argc; ++i)
+	{
+		if(strcmp(argv[i], "--backend") == 0 && i + 1 < argc)
+			sBackend = argv[++i];
+		else if(strcmp(argv[i], "--size") == 0 && i + 1 < argc)
+		{
+			if(!ParseSize(argv[++i], nWidth, nHeight))
+				return Usage(argv[0]);
+		}
+		else if(strcmp(argv[i], "--raw") == 0 && i + 1 < argc)
+		{
+			if(!ParseSize(argv[++i], nRawWidth, nRawHeight))
+				return Usage(argv[0]);
+			bRaw = true;
+		}
+		else if(strcmp(argv[i], "--fps") == 0 && i + 1 < argc)
+			dFps = atof(argv[++i]);
+		else if(strcmp(argv[i], "--no-dither") == 0)
+			bDither = false;
+		else if(strcmp(argv[i], "--max-speed") == 0)
+			bRealtime = false;
+		else if(argv[i][0] != '-' && sFile == nullptr)
+			sFile = argv[i];
+		else
+			return Usage(argv[0]);
+	}
+	if(sFile == nullptr)
+		return Usage(argv[0]);
+
+	std::unique_ptr<olcRenderBackend> pBackend = olcCreateToolBackend(sBackend);
+	if(!pBackend)
+		return Usage(argv[0]);
+
+	olcVideoPlayer player;
+	bool bOpen = bRaw ? player.OpenRaw(fs::path(sFile).wstring(), nRawWidth, nRawHeight, dFps)
+	                  : player.Open(fs::path(sFile).wstring(), dFps);
+	if(!bOpen)
+	{
+		fprintf(stderr, "cannot open '%s'\n", sFile);
+		return 2;
+	}
+	player.Mapper().SetDithering(bDither);
+
+	auto tpStart = std::chrono::steady_clock::now();
+	long long nFrames = player.Play(*pBackend, nWidth, nHeight, bRealtime);
+	double fSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - tpStart).count();
+
+	long long nCells = olcReleaseToolBackend(pBackend);
+
+	if(nFrames < 0)
+	{
+		fprintf(stderr, "cannot construct the '%s' backend\n", sBackend.c_str());
+		return 2;
+	}
+	fprintf(stderr, "%lld frames (%dx%d to %dx%d) in %.3fs, %llu dropped", nFrames,
+	        player.Source().Width(), player.Source().Height(), player.Width(), player.Height(), fSeconds,
+	        (unsigned long long)player.FramesDropped());
+	if(nCells >= 0)
+		fprintf(stderr, ", %lld cells presented", nCells);
+	fprintf(stderr, "\n");
+	return 0;
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,138 @@
+//---------------------------------------------------------------------------//
+//  olcCGE_replay - plays back recordings made with
+//  olcConsoleGameEngine::StartRecording() (see olcFrameRecording.h).
+//
+//  usage: olcCGE_replay [--backend default|ansi|headless] [--max-speed]
+//                       <recording>
+//         olcCGE_replay --diff <recording> <recording>
+//
+//  Playing through the headless backend at --max-speed times the decoder
+//  and prints what was presented, for regression runs. --diff compares two
+//  recordings frame by frame (say, the same session from two builds) and
+//  reports the first frame and cell where they differ.
+//---------------------------------------------------------------------------//
+
+//-----------------------------------------------------------------------------
+#include "olcFrameRecording.h"
+#include "olcToolBackend.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <string>
+//-----------------------------------------------------------------------------
+
+namespace fs = std::filesystem;
+//-----------------------------------------------------------------------------
+
+static int Usage(const char *sExe)
+{
+	fprintf(stderr, "usage: %s [--backend default|ansi|headless] [--max-speed] <recording>\n"
+	                "       %s --diff <recording> <recording>\n", sExe, sExe);
+	return 1;
+}
+//-----------------------------------------------------------------------------
+
+static int Diff(const char *sFileA, const char *sFileB)
+{
+	olcFramePlayer a, b;
+	if(!a.Open(fs::path(sFileA).wstring()) || !b.Open(fs::path(sFileB).wstring()))
+	{
+		fprintf(stderr, "cannot open both recordings\n");
+		return 2;
+	}
+	if(a.Width() != b.Width() || a.Height() != b.Height())
+	{
+		printf("sizes differ: %dx%d and %dx%d\n", a.Width(), a.Height(), b.Width(), b.Height());
+		return 1;
+	}
+
+	const int nCells = a.Width() * a.Height();
+	while(true)
+	{
+		bool bA = a.NextFrame();
+		bool bB = b.NextFrame();
+		if(!bA || !bB)
+		{
+			if(bA != bB)
+			{
+				printf("%s ends first, after %llu frames\n", bA ? sFileB : sFileA,
+				       (unsigned long long)(bA ? b.Frame() : a.Frame()));
+				return 1;
+			}
+			break;
+		}
+
+		const olcCellBuffer &cellsA = a.Cells();
+		const olcCellBuffer &cellsB = b.Cells();
+		for(int i = 0; i < nCells; ++i)
+		{
+			if(cellsA.Glyphs()[i] != cellsB.Glyphs()[i] || cellsA.Attributes()[i] != cellsB.Attributes()[i])
+			{
+				printf("frame %llu differs at (%d, %d): U+%04X/%02X and U+%04X/%02X\n",
+				       (unsigned long long)(a.Frame() - 1), i % a.Width(), i / a.Width(),
+				       unsigned(cellsA.Glyphs()[i]), unsigned(cellsA.Attributes()[i]),
+				       unsigned(cellsB.Glyphs()[i]), unsigned(cellsB.Attributes()[i]));
+				return 1;
+			}
+		}
+	}
+
+	printf("identical, %llu frames\n", (unsigned long long)a.Frame());
+	return 0;
+}
+//-----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+	std::string sBackend = "default";
+	bool        bRealtime = true;
+	const char *sFile = nullptr;
+
+	for(int i = 1; i < argc; ++i)
+	{
+		if(strcmp(argv[i], "--diff") == 0 && i + 2 < argc)
+			return Diff(argv[i + 1], argv[i + 2]);
+		else if(strcmp(argv[i], "--backend") == 0 && i + 1 < argc)
+			sBackend = argv[++i];
+		else if(strcmp(argv[i], "--max-speed") == 0)
+			bRealtime = false;
+		else if(argv[i][0] != '-' && sFile == nullptr)
+			sFile = argv[i];
+		else
+			return Usage(argv[0]);
+	}
+	if(sFile == nullptr)
+		return Usage(argv[0]);
+
+	std::unique_ptr<olcRenderBackend> pBackend = olcCreateToolBackend(sBackend);
+	if(!pBackend)
+		return Usage(argv[0]);
+
+	olcFramePlayer player;
+	if(!player.Open(fs::path(sFile).wstring()))
+	{
+		fprintf(stderr, "cannot open recording '%s'\n", sFile);
+		return 2;
+	}
+
+	auto tpStart = std::chrono::steady_clock::now();
+	long long nFrames = player.Play(*pBackend, bRealtime);
+	double fSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - tpStart).count();
+
+	long long nCells = olcReleaseToolBackend(pBackend);
+
+	if(nFrames < 0)
+	{
+		fprintf(stderr, "cannot construct the '%s' backend\n", sBackend.c_str());
+		return 2;
+	}
+	fprintf(stderr, "%lld frames (%dx%d) in %.3fs", nFrames, player.Width(), player.Height(), fSeconds);
+	if(nCells >= 0)
+		fprintf(stderr, ", %lld cells presented", nCells);
+	fprintf(stderr, "\n");
+	return 0;
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,75 @@
+//---------------------------------------------------------------------------//
+//  olcCGE_sprpack - packs .spr files written by olcSprite::Save() into a
+//  single sprite pack (see olcSpritePack.h).
+//
+//  usage: olcCGE_sprpack <output pack> <.spr file or directory>...
+//
+//  A file is named after its stem, files found in a directory after their
+//  path relative to it without the extension ("enemies/goblin").
+//---------------------------------------------------------------------------//
+
+//-----------------------------------------------------------------------------
+#include "olcSpritePack.h"
+
+#include <cstdio>
+#include <filesystem>
+#include <memory>
+#include <vector>
+//-----------------------------------------------------------------------------
+
+namespace fs = std::filesystem;
+//-----------------------------------------------------------------------------
+
+int main(int argc, char *argv[])
+{
+	if(argc < 3)
+	{
+		fprintf(stderr, "usage: %s <output pack> <.spr file or directory>...\n", argv[0]);
+		return 1;
+	}
+
+	//-- Collect the inputs
+	std::vector<std::pair<std::wstring, fs::path>> vecInputs;
+	for(int i = 2; i < argc; ++i)
+	{
+		fs::path input(argv[i]);
+		std::error_code ec;
+		if(fs::is_directory(input, ec))
+		{
+			for(auto &entry : fs::recursive_directory_iterator(input))
+			{
+				if(!entry.is_regular_file() || entry.path().extension() != ".spr")
+					continue;
+				fs::path name = fs::relative(entry.path(), input).replace_extension();
+				vecInputs.push_back({ name.generic_wstring(), entry.path() });
+			}
+		}
+		else
+			vecInputs.push_back({ input.stem().wstring(), input });
+	}
+
+	//-- Load them all, then write the pack
+	std::vector<std::unique_ptr<olcSprite>> vecLoaded;
+	std::vector<std::pair<std::wstring, const olcSprite*>> vecSprites;
+	for(auto &input : vecInputs)
+	{
+		std::unique_ptr<olcSprite> sprite(new olcSprite());
+		if(!sprite->Load(input.second.wstring()))
+		{
+			fprintf(stderr, "cannot load sprite '%s'\n", input.second.string().c_str());
+			return 1;
+		}
+		vecSprites.push_back({ input.first, sprite.get() });
+		vecLoaded.push_back(std::move(sprite));
+	}
+
+	if(!olcSpritePack::Write(fs::path(argv[1]).wstring(), vecSprites))
+	{
+		fprintf(stderr, "cannot write pack '%s' (duplicate sprite names?)\n", argv[1]);
+		return 1;
+	}
+
+	printf("packed %zu sprites into %s\n", vecSprites.size(), argv[1]);
+	return 0;
+}
+//-----------------------------------------------------------------------------
@@ -0,0 +1,44 @@
+//---------------------------------------------------------------------------//
+//  Backend selection for the command line tools that play frames through a
+//  render backend (olcCGE_replay, olcCGE_play).
+//
+//  --backend picks one by name: "default" (olcCreateDefaultBackend()),
+//  "ansi" or "headless". Run headless, the tools report how many cells were
+//  presented.
+//---------------------------------------------------------------------------//
+
+//-----------------------------------------------------------------------------
+#pragma once
+//-----------------------------------------------------------------------------
+#include <memory>
+#include <string>
+//-----------------------------------------------------------------------------
+#include "olcRenderBackend.h"
+#include "olcAnsiBackend.h"
+//-----------------------------------------------------------------------------
+
+// The backend called sName, nullptr for an unknown name
+inline std::unique_ptr<olcRenderBackend> olcCreateToolBackend(const std::string &sName)
+{
+	std::unique_ptr<olcRenderBackend> pBackend;
+	if(sName == "default")
+		pBackend = olcCreateDefaultBackend();
+	else if(sName == "ansi")
+		pBackend.reset(new olcAnsiBackend());
+	else if(sName == "headless")
+		pBackend.reset(new olcHeadlessBackend());
+	return pBackend;
+}
+//-----------------------------------------------------------------------------
+
+// Destroy the backend before the tool prints its summary, as the terminal
+// backends restore the screen when they go. Returns the cells presented
+// for the headless backend, -1 for the others.
+inline long long olcReleaseToolBackend(std::unique_ptr<olcRenderBackend> &pBackend)
+{
+	olcHeadlessBackend *pHeadless = dynamic_cast<olcHeadlessBackend*>(pBackend.get());
+	long long nCells = pHeadless ? (long long)pHeadless->CellsPresented() : -1;
+	pBackend.reset();
+	return nCells;
+}
+//-----------------------------------------------------------------------------